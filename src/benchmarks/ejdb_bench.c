@@ -0,0 +1,545 @@
+/// EJDB2 core operations benchmark.
+///
+/// Generates a synthetic collection and runs single operation workloads
+/// (point get, insert, update, range scan, sorted query, count) and
+/// YCSB-like mixed read/write workloads over a set of thread counts.
+/// Results are printed as JSON.
+
+#include "ejdb2.h"
+
+#include <iowow/iwconv.h>
+
+#include <errno.h>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <getopt.h>
+#include <pthread.h>
+#include <time.h>
+
+#define BENCH_COLL        "bench"
+#define BENCH_MAX_THREADS 256
+#define BENCH_RANGE_WIDTH 100
+#define BENCH_LATEST_SPAN 1000
+
+typedef enum {
+  WL_GET = 0,
+  WL_INSERT,
+  WL_UPDATE,
+  WL_RANGE,
+  WL_SORTED,
+  WL_COUNT,
+  WL_YCSB_A, /**< 50% get, 50% update */
+  WL_YCSB_B, /**< 95% get, 5% update */
+  WL_YCSB_D, /**< 95% get of recently inserted documents, 5% insert */
+  WL_NUM,
+} wl_t;
+
+static const char *_wl_names[WL_NUM] = {
+  "get", "insert", "update", "range", "sorted", "count", "ycsb-a", "ycsb-b", "ycsb-d"
+};
+
+// Percentage of write operations in mixed workloads
+static const int _wl_write_pct[WL_NUM] = {
+  [WL_YCSB_A] = 50,
+  [WL_YCSB_B] = 5,
+  [WL_YCSB_D] = 5,
+};
+
+static const char *_wl_queries[WL_NUM] = {
+  [WL_RANGE]  = "/[n >= :lo] and /[n < :hi]",
+  [WL_SORTED] = "/[k = :k] | desc /n | limit 10",
+  [WL_COUNT]  = "/[k = :k]",
+};
+
+static struct env {
+  const char *program;
+  const char *path;
+  const char *out;
+  EJDB      db;
+  int64_t   docs;
+  int64_t   ops;
+  int64_t   card;
+  int       doc_size;
+  int       threads[BENCH_MAX_THREADS];
+  int       threads_num;
+  uint64_t  seed;
+  bool      index;
+  bool      wal;
+  bool      workloads[WL_NUM];
+} env;
+
+struct worker {
+  wl_t      wl;
+  int       tid;
+  int64_t   ops;
+  int64_t   errors;
+  uint64_t  rnd;
+  uint64_t *lat; /**< Per operation latencies in nanoseconds. */
+  char     *pad; /**< Document padding buffer of `doc_size + 1` bytes. */
+  pthread_t thr;
+};
+
+static int _usage(const char *err) {
+  if (err) {
+    fprintf(stderr, "\n%s\n", err);
+  }
+  fprintf(stderr, "\n\tEJDB " EJDB2_VERSION " core operations benchmark.\n");
+  fprintf(stderr, "\nUsage:\n\n  %s [options]\n\n", env.program);
+  fprintf(stderr, "\t-f, --file=<>         Database file path. Default: ejdb_bench.db\n");
+  fprintf(stderr, "\t-o, --out=<>          Write JSON results into the given file. Default: stdout\n");
+  fprintf(stderr, "\t-d, --docs=NUM        Number of documents in generated collection. Default: 100000\n");
+  fprintf(stderr, "\t-s, --doc-size=NUM    Approximate document size in bytes. Default: 256\n");
+  fprintf(stderr, "\t-c, --card=NUM        Cardinality of the /k field. Default: 1000\n");
+  fprintf(stderr, "\t-n, --ops=NUM         Number of operations per thread. Default: 10000\n");
+  fprintf(stderr, "\t-t, --threads=<>      Comma separated list of thread counts. Default: 1,2,4,8\n");
+  fprintf(stderr,
+          "\t-W, --workloads=<>    Comma separated list of workloads:\n"
+          "\t                      get,insert,update,range,sorted,count,ycsb-a,ycsb-b,ycsb-d. Default: all\n");
+  fprintf(stderr, "\t-r, --seed=NUM        Random generator seed. Default: 1\n");
+  fprintf(stderr, "\t-i, --index           Create indexes on /k and /n fields.\n");
+  fprintf(stderr, "\t-w, --wal             Use write ahead log (WAL).\n");
+  fprintf(stderr, "\t-h, --help            Print usage help.\n");
+  fprintf(stderr, "\n");
+  return err ? 1 : 0;
+}
+
+static uint64_t _rnd_next(uint64_t *s) {
+  // xorshift64*
+  uint64_t x = *s;
+  x ^= x >> 12;
+  x ^= x << 25;
+  x ^= x >> 27;
+  *s = x;
+  return x * 0x2545F4914F6CDD1DULL;
+}
+
+static uint64_t _rnd_seed(uint64_t seed, int tid) {
+  uint64_t s = (seed + 1) * 0x9E3779B97F4A7C15ULL + (uint64_t) tid;
+  return s ? s : 1;
+}
+
+static uint64_t _time_ns(void) {
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (uint64_t) t.tv_sec * 1000000000ULL + (uint64_t) t.tv_nsec;
+}
+
+static iwrc _doc_create(uint64_t *rnd, char *pad, int64_t n, JBL *out) {
+  iwrc rc = 0;
+  JBL jbl = 0;
+  int plen = env.doc_size > 32 ? env.doc_size - 32 : 1;
+
+  for (int i = 0; i < plen; ++i) {
+    pad[i] = (char) ('a' + _rnd_next(rnd) % 26);
+  }
+  pad[plen] = '\0';
+
+  RCC(rc, finish, jbl_create_empty_object(&jbl));
+  RCC(rc, finish, jbl_set_int64(jbl, "n", n));
+  RCC(rc, finish, jbl_set_int64(jbl, "k", (int64_t) (_rnd_next(rnd) % env.card)));
+  RCC(rc, finish, jbl_set_string(jbl, "s", pad));
+
+finish:
+  if (rc) {
+    jbl_destroy(&jbl);
+  } else {
+    *out = jbl;
+  }
+  return rc;
+}
+
+static iwrc _populate(void) {
+  iwrc rc = 0;
+  uint64_t rnd = _rnd_seed(env.seed, -1);
+  char *pad = malloc(env.doc_size + 1);
+  if (!pad) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+
+  if (env.index) {
+    RCC(rc, finish, ejdb_ensure_index(env.db, BENCH_COLL, "/n", EJDB_IDX_UNIQUE | EJDB_IDX_I64));
+    RCC(rc, finish, ejdb_ensure_index(env.db, BENCH_COLL, "/k", EJDB_IDX_I64));
+  } else {
+    RCC(rc, finish, ejdb_ensure_collection(env.db, BENCH_COLL));
+  }
+  for (int64_t i = 1; i <= env.docs; ++i) {
+    int64_t id;
+    JBL jbl;
+    RCC(rc, finish, _doc_create(&rnd, pad, i, &jbl));
+    rc = ejdb_put_new(env.db, BENCH_COLL, jbl, &id);
+    jbl_destroy(&jbl);
+    RCBREAK(rc);
+  }
+
+finish:
+  free(pad);
+  return rc;
+}
+
+static iwrc _noop_visitor(EJDB_EXEC *ux, EJDB_DOC doc, int64_t *step) {
+  return 0;
+}
+
+static int64_t _nseq;    /**< Value of /n field of the last inserted document */
+static int64_t _last_id; /**< Identifier of the last inserted document */
+
+static iwrc _op(struct worker *w, JQL q) {
+  iwrc rc = 0;
+  JBL jbl = 0;
+  wl_t wl = w->wl;
+  int64_t id = 1 + (int64_t) (_rnd_next(&w->rnd) % env.docs);
+
+  if (_wl_write_pct[wl]) { // Mixed workload, select operation
+    bool write = (int) (_rnd_next(&w->rnd) % 100) < _wl_write_pct[wl];
+    if (wl == WL_YCSB_D) {
+      if (!write) {
+        id = __atomic_load_n(&_last_id, __ATOMIC_RELAXED) - (int64_t) (_rnd_next(&w->rnd) % BENCH_LATEST_SPAN);
+        if (id < 1) {
+          id = 1;
+        }
+      }
+      wl = write ? WL_INSERT : WL_GET;
+    } else {
+      wl = write ? WL_UPDATE : WL_GET;
+    }
+  }
+
+  switch (wl) {
+    case WL_GET:
+      rc = ejdb_get(env.db, BENCH_COLL, id, &jbl);
+      break;
+    case WL_INSERT: {
+      int64_t n = __atomic_add_fetch(&_nseq, 1, __ATOMIC_RELAXED);
+      RCC(rc, finish, _doc_create(&w->rnd, w->pad, n, &jbl));
+      rc = ejdb_put_new(env.db, BENCH_COLL, jbl, &id);
+      if (!rc) {
+        __atomic_store_n(&_last_id, id, __ATOMIC_RELAXED);
+      }
+      break;
+    }
+    case WL_UPDATE: {
+      char patch[64];
+      snprintf(patch, sizeof(patch), "{\"k\":%" PRId64 "}", (int64_t) (_rnd_next(&w->rnd) % env.card));
+      rc = ejdb_patch(env.db, BENCH_COLL, patch, id);
+      break;
+    }
+    case WL_RANGE: {
+      EJDB_EXEC ux = { .db = env.db, .q = q, .visitor = _noop_visitor };
+      RCC(rc, finish, jql_set_i64(q, "lo", 0, id));
+      RCC(rc, finish, jql_set_i64(q, "hi", 0, id + BENCH_RANGE_WIDTH));
+      rc = ejdb_exec(&ux);
+      break;
+    }
+    case WL_SORTED: {
+      EJDB_EXEC ux = { .db = env.db, .q = q, .visitor = _noop_visitor };
+      RCC(rc, finish, jql_set_i64(q, "k", 0, (int64_t) (_rnd_next(&w->rnd) % env.card)));
+      rc = ejdb_exec(&ux);
+      break;
+    }
+    case WL_COUNT: {
+      int64_t count;
+      RCC(rc, finish, jql_set_i64(q, "k", 0, (int64_t) (_rnd_next(&w->rnd) % env.card)));
+      rc = ejdb_count(env.db, q, &count, 0);
+      break;
+    }
+    default:
+      break;
+  }
+
+finish:
+  jbl_destroy(&jbl);
+  return rc;
+}
+
+static void* _worker_run(void *op) {
+  struct worker *w = op;
+  JQL q = 0;
+  const char *qs = _wl_queries[w->wl];
+
+  if (qs) {
+    iwrc rc = jql_create(&q, BENCH_COLL, qs);
+    if (rc) {
+      iwlog_ecode_error3(rc);
+      w->errors = w->ops;
+      return 0;
+    }
+  }
+  for (int64_t i = 0; i < w->ops; ++i) {
+    uint64_t ts = _time_ns();
+    iwrc rc = _op(w, q);
+    w->lat[i] = _time_ns() - ts;
+    if (rc) {
+      if (!w->errors) {
+        iwlog_ecode_error3(rc);
+      }
+      ++w->errors;
+    }
+  }
+  jql_destroy(&q);
+  return 0;
+}
+
+static int _lat_cmp(const void *a, const void *b) {
+  uint64_t x = *(const uint64_t*) a, y = *(const uint64_t*) b;
+  return x < y ? -1 : x > y ? 1 : 0;
+}
+
+static double _percentile_us(const uint64_t *lat, size_t num, double p) {
+  if (!num) {
+    return 0;
+  }
+  size_t idx = (size_t) (p * (double) (num - 1) + 0.5);
+  return (double) lat[idx] / 1000.0;
+}
+
+static iwrc _run(wl_t wl, int nthreads, FILE *out, bool first) {
+  iwrc rc = 0;
+  int64_t errors = 0;
+  size_t num = (size_t) env.ops * (size_t) nthreads;
+  struct worker *workers = calloc(nthreads, sizeof(*workers));
+  uint64_t *lat = malloc(num * sizeof(*lat));
+  char *pads = malloc((size_t) nthreads * (size_t) (env.doc_size + 1));
+
+  if (!workers || !lat || !pads) {
+    rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    goto finish;
+  }
+
+  uint64_t ts = _time_ns();
+  for (int i = 0; i < nthreads; ++i) {
+    struct worker *w = &workers[i];
+    w->wl = wl;
+    w->tid = i;
+    w->ops = env.ops;
+    w->rnd = _rnd_seed(env.seed, i);
+    w->lat = lat + (size_t) i * (size_t) env.ops;
+    w->pad = pads + (size_t) i * (size_t) (env.doc_size + 1);
+    int err = pthread_create(&w->thr, 0, _worker_run, w);
+    if (err) {
+      rc = iwrc_set_errno(IW_ERROR_THREADING_ERRNO, err);
+      for (int j = 0; j < i; ++j) {
+        pthread_join(workers[j].thr, 0);
+      }
+      goto finish;
+    }
+  }
+  for (int i = 0; i < nthreads; ++i) {
+    pthread_join(workers[i].thr, 0);
+    errors += workers[i].errors;
+  }
+  uint64_t elapsed = _time_ns() - ts;
+
+  uint64_t sum = 0;
+  for (size_t i = 0; i < num; ++i) {
+    sum += lat[i];
+  }
+  qsort(lat, num, sizeof(*lat), _lat_cmp);
+
+  fprintf(out, "%s\n    {\"workload\":\"%s\",\"threads\":%d,\"ops\":%zu,\"errors\":%" PRId64
+          ",\"elapsed_ms\":%.3f,\"ops_per_sec\":%.1f,"
+          "\"latency_us\":{\"min\":%.3f,\"avg\":%.3f,\"p50\":%.3f,\"p90\":%.3f,"
+          "\"p99\":%.3f,\"p999\":%.3f,\"max\":%.3f}}",
+          first ? "" : ",", _wl_names[wl], nthreads, num, errors,
+          (double) elapsed / 1e6,
+          elapsed ? (double) num * 1e9 / (double) elapsed : 0.0,
+          _percentile_us(lat, num, 0), num ? (double) sum / (double) num / 1000.0 : 0.0,
+          _percentile_us(lat, num, 0.5), _percentile_us(lat, num, 0.9),
+          _percentile_us(lat, num, 0.99), _percentile_us(lat, num, 0.999),
+          _percentile_us(lat, num, 1.0));
+  fflush(out);
+
+finish:
+  free(workers);
+  free(lat);
+  free(pads);
+  return rc;
+}
+
+static bool _parse_threads(const char *spec) {
+  env.threads_num = 0;
+  for (const char *p = spec; *p; ) {
+    char *end;
+    long v = strtol(p, &end, 10);
+    if (end == p || v < 1 || v > BENCH_MAX_THREADS || env.threads_num >= BENCH_MAX_THREADS) {
+      return false;
+    }
+    env.threads[env.threads_num++] = (int) v;
+    p = end;
+    if (*p == ',') {
+      ++p;
+    } else if (*p) {
+      return false;
+    }
+  }
+  return env.threads_num > 0;
+}
+
+static bool _parse_workloads(const char *spec) {
+  memset(env.workloads, 0, sizeof(env.workloads));
+  for (const char *p = spec; *p; ) {
+    size_t len = strcspn(p, ",");
+    int i = 0;
+    for ( ; i < WL_NUM; ++i) {
+      if (strlen(_wl_names[i]) == len && !strncmp(_wl_names[i], p, len)) {
+        env.workloads[i] = true;
+        break;
+      }
+    }
+    if (i == WL_NUM) {
+      return false;
+    }
+    p += len;
+    if (*p == ',') {
+      ++p;
+    }
+  }
+  return true;
+}
+
+int main(int argc, char const *argv[]) {
+  iwrc rc = 0;
+  int ec = 0, ch;
+  bool first = true;
+  FILE *out = stdout;
+
+  env.program = argc ? argv[0] : "";
+  env.path = "ejdb_bench.db";
+  env.docs = 100000;
+  env.doc_size = 256;
+  env.card = 1000;
+  env.ops = 10000;
+  env.seed = 1;
+  _parse_threads("1,2,4,8");
+  for (int i = 0; i < WL_NUM; ++i) {
+    env.workloads[i] = true;
+  }
+
+  static const struct option long_options[] = {
+    { "help", 0, 0, 'h' },
+    { "file", 1, 0, 'f' },
+    { "out", 1, 0, 'o' },
+    { "docs", 1, 0, 'd' },
+    { "doc-size", 1, 0, 's' },
+    { "card", 1, 0, 'c' },
+    { "ops", 1, 0, 'n' },
+    { "threads", 1, 0, 't' },
+    { "workloads", 1, 0, 'W' },
+    { "seed", 1, 0, 'r' },
+    { "index", 0, 0, 'i' },
+    { "wal", 0, 0, 'w' },
+    { 0 }
+  };
+
+  while ((ch = getopt_long(argc, (char* const*) argv, "f:o:d:s:c:n:t:W:r:iwh", long_options, 0)) != -1) {
+    switch (ch) {
+      case 'h':
+        ec = _usage(0);
+        goto finish;
+      case 'f':
+        env.path = optarg;
+        break;
+      case 'o':
+        env.out = optarg;
+        break;
+      case 'd':
+        env.docs = iwatoi(optarg);
+        break;
+      case 's':
+        env.doc_size = (int) iwatoi(optarg);
+        break;
+      case 'c':
+        env.card = iwatoi(optarg);
+        break;
+      case 'n':
+        env.ops = iwatoi(optarg);
+        break;
+      case 't':
+        if (!_parse_threads(optarg)) {
+          ec = _usage("Invalid --threads value");
+          goto finish;
+        }
+        break;
+      case 'W':
+        if (!_parse_workloads(optarg)) {
+          ec = _usage("Invalid --workloads value");
+          goto finish;
+        }
+        break;
+      case 'r':
+        env.seed = (uint64_t) iwatoi(optarg);
+        break;
+      case 'i':
+        env.index = true;
+        break;
+      case 'w':
+        env.wal = true;
+        break;
+      default:
+        ec = _usage(0);
+        goto finish;
+    }
+  }
+
+  if (env.docs < 1 || env.ops < 1 || env.card < 1 || env.doc_size < 1) {
+    ec = _usage("Invalid arguments: --docs, --ops, --card and --doc-size must be positive");
+    goto finish;
+  }
+
+  if (env.out) {
+    out = fopen(env.out, "w");
+    if (!out) {
+      rc = iwrc_set_errno(IW_ERROR_IO_ERRNO, errno);
+      goto finish;
+    }
+  }
+
+  EJDB_OPTS opts = {
+    .kv         = {
+      .path     = env.path,
+      .oflags   = IWKV_TRUNC
+    },
+    .no_wal     = !env.wal
+  };
+
+  RCC(rc, finish, ejdb_init());
+  RCC(rc, finish, ejdb_open(&opts, &env.db));
+
+  uint64_t ts = _time_ns();
+  RCC(rc, finish, _populate());
+  uint64_t populate_ns = _time_ns() - ts;
+  _nseq = env.docs;
+  _last_id = env.docs;
+
+  fprintf(out, "{\n  \"config\":{\"docs\":%" PRId64 ",\"doc_size\":%d,\"card\":%" PRId64
+          ",\"ops\":%" PRId64 ",\"seed\":%" PRIu64 ",\"index\":%s,\"wal\":%s,\"populate_ms\":%.3f},\n"
+          "  \"results\":[",
+          env.docs, env.doc_size, env.card, env.ops, env.seed,
+          env.index ? "true" : "false", env.wal ? "true" : "false",
+          (double) populate_ns / 1e6);
+
+  for (int wl = 0; wl < WL_NUM; ++wl) {
+    if (!env.workloads[wl]) {
+      continue;
+    }
+    for (int i = 0; i < env.threads_num; ++i) {
+      RCC(rc, finish, _run(wl, env.threads[i], out, first));
+      first = false;
+    }
+  }
+  fprintf(out, "\n  ]\n}\n");
+
+finish:
+  if (env.db) {
+    IWRC(ejdb_close(&env.db), rc);
+  }
+  if (out && out != stdout) {
+    fclose(out);
+  }
+  if (rc) {
+    iwlog_ecode_error3(rc);
+    ec = 1;
+  }
+  return ec;
+}
@@ -3,12 +3,16 @@
 #include <string.h>
 #include <errno.h>
 #include <stdlib.h>
+#include <pthread.h>
 
 #include "com_softmotions_ejdb2_EJDB2.h"
 #include "com_softmotions_ejdb2_JQL.h"
 
 
 #define JBN_JSON_FLUSH_BUFFER_SZ 4096
+#define JBN_XSTR_POOL_SIZE       8
+#define JBN_XSTR_POOL_MAX_BUF_SZ 4194304
+#define JBN_BATCH_MAX_BYTES      JBN_XSTR_POOL_MAX_BUF_SZ
 
 typedef struct JBN_STR {
   const char *utf;
@@ -351,6 +355,83 @@ finish:
   return ret;
 }
 
+// PUT BATCH
+JNIEXPORT jlongArray JNICALL Java_com_softmotions_ejdb2_EJDB2__1put_1batch(
+  JNIEnv      *env,
+  jobject      thisObj,
+  jstring      coll_,
+  jobjectArray jsons_) {
+  iwrc rc;
+  EJDB db;
+  JBL *jbls = 0;
+  int64_t *oids = 0;
+  jlongArray ret = 0;
+  jsize num = jsons_ ? (*env)->GetArrayLength(env, jsons_) : 0;
+
+  const char *coll = (*env)->GetStringUTFChars(env, coll_, 0);
+  if (!coll || !jsons_) {
+    rc = IW_ERROR_INVALID_ARGS;
+    goto finish;
+  }
+
+  rc = jbn_db(env, thisObj, &db);
+  RCGO(rc, finish);
+
+  jbls = calloc(num + 1, sizeof(*jbls));
+  oids = calloc(num + 1, sizeof(*oids));
+  if (!jbls || !oids) {
+    rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    goto finish;
+  }
+  // Parse all documents before database access
+  for (jsize i = 0; i < num; ++i) {
+    jstring json_ = (*env)->GetObjectArrayElement(env, jsons_, i);
+    if (!json_) {
+      if (!(*env)->ExceptionOccurred(env)) {
+        rc = IW_ERROR_INVALID_ARGS;
+      }
+      goto finish;
+    }
+    const char *json = (*env)->GetStringUTFChars(env, json_, 0);
+    if (!json) {
+      (*env)->DeleteLocalRef(env, json_);
+      goto finish;
+    }
+    rc = jbl_from_json(&jbls[i], json);
+    (*env)->ReleaseStringUTFChars(env, json_, json);
+    (*env)->DeleteLocalRef(env, json_);
+    RCGO(rc, finish);
+  }
+
+  if (num > 0) {
+    rc = ejdb_put_new_batch(db, coll, jbls, num, oids);
+    RCGO(rc, finish);
+  }
+
+  ret = (*env)->NewLongArray(env, num);
+  if (ret) {
+    (*env)->SetLongArrayRegion(env, ret, 0, num, (const jlong*) oids);
+  }
+
+finish:
+  if (jbls) {
+    for (jsize i = 0; i < num; ++i) {
+      if (jbls[i]) {
+        jbl_destroy(&jbls[i]);
+      }
+    }
+    free(jbls);
+  }
+  free(oids);
+  if (coll) {
+    (*env)->ReleaseStringUTFChars(env, coll_, coll);
+  }
+  if (rc) {
+    jbn_throw_rc_exception(env, rc, 0);
+  }
+  return ret;
+}
+
 JNIEXPORT jlong JNICALL Java_com_softmotions_ejdb2_EJDB2__1online_1backup(
   JNIEnv *env, jobject thisObj,
   jstring target_) {
@@ -717,11 +798,57 @@ typedef struct JBN_EXEC_CTX {
   jobject   cbObj;
   jclass    cbClazz;
   jmethodID cbMid;
+  bool      buffer;     /**< Pass documents as direct `ByteBuffer` instead of `String` */
+  bool      stop;       /**< Iteration stopped by batch callback */
+  jint      batch_size; /**< Max number of documents passed to batch callback */
+  jint      num;        /**< Number of documents in current batch */
+  jlong    *ids;        /**< Documents identifiers of current batch */
+  jint     *offsets;    /**< `num + 1` offsets of documents in `xstr` */
+  IWXSTR   *xstr;       /**< Current batch JSON data */
+  size_t    xstr_peak;  /**< Max size of `xstr` data, the buffer capacity is at least this size */
 } JBN_EXEC_CTX;
 
+// Pool of reusable batch buffers
+static pthread_mutex_t k_xstr_pool_mtx = PTHREAD_MUTEX_INITIALIZER;
+static IWXSTR *k_xstr_pool[JBN_XSTR_POOL_SIZE];
+static int k_xstr_pool_num;
+
+static IWXSTR* jbn_xstr_acquire(size_t siz) {
+  IWXSTR *xstr = 0;
+  pthread_mutex_lock(&k_xstr_pool_mtx);
+  if (k_xstr_pool_num > 0) {
+    xstr = k_xstr_pool[--k_xstr_pool_num];
+  }
+  pthread_mutex_unlock(&k_xstr_pool_mtx);
+  return xstr ? xstr : iwxstr_new2(siz);
+}
+
+// Returns buffer into the pool unless it has grown over `JBN_XSTR_POOL_MAX_BUF_SZ`,
+// `peak` is the max data size ever stored in buffer
+static void jbn_xstr_release(IWXSTR *xstr, size_t peak) {
+  if (!xstr) {
+    return;
+  }
+  if (peak < iwxstr_size(xstr)) {
+    peak = iwxstr_size(xstr);
+  }
+  if (peak <= JBN_XSTR_POOL_MAX_BUF_SZ) {
+    iwxstr_clear(xstr);
+    pthread_mutex_lock(&k_xstr_pool_mtx);
+    if (k_xstr_pool_num < JBN_XSTR_POOL_SIZE) {
+      k_xstr_pool[k_xstr_pool_num++] = xstr;
+      xstr = 0;
+    }
+    pthread_mutex_unlock(&k_xstr_pool_mtx);
+  }
+  if (xstr) {
+    iwxstr_destroy(xstr);
+  }
+}
+
 static iwrc jbn_exec_visitor(struct ejdb_exec *ux, EJDB_DOC doc, int64_t *step) {
   iwrc rc = 0;
-  jstring json = 0;
+  jobject json = 0;
   JBN_EXEC_CTX *ectx = ux->opaque;
   JNIEnv *env = ectx->env;
   IWXSTR *xstr = iwxstr_new2(jbl_size(doc->raw) * 2);
@@ -735,7 +862,12 @@ static iwrc jbn_exec_visitor(struct ejdb_exec *ux, EJDB_DOC doc, int64_t *step)
   }
   RCGO(rc, finish);
 
-  json = (*env)->NewStringUTF(env, iwxstr_ptr(xstr));
+  if (ectx->buffer) {
+    // Direct buffer over UTF-8 JSON data, valid only within callback call
+    json = (*env)->NewDirectByteBuffer(env, iwxstr_ptr(xstr), iwxstr_size(xstr));
+  } else {
+    json = (*env)->NewStringUTF(env, iwxstr_ptr(xstr));
+  }
   if (!json) {
     if (!(*env)->ExceptionOccurred(env)) {
       rc = JBN_ERROR_CREATION_OBJ;
@@ -757,17 +889,102 @@ finish:
   return rc;
 }
 
-// JQL EXECUTE
-JNIEXPORT void JNICALL Java_com_softmotions_ejdb2_JQL__1execute(
+static iwrc jbn_exec_batch_flush(JBN_EXEC_CTX *ectx) {
+  iwrc rc = 0;
+  JNIEnv *env = ectx->env;
+  jlongArray ids = 0;
+  jintArray offsets = 0;
+  jobject data = 0;
+  if (!ectx->num) {
+    return 0;
+  }
+  ids = (*env)->NewLongArray(env, ectx->num);
+  if (!ids) {
+    goto finish;
+  }
+  (*env)->SetLongArrayRegion(env, ids, 0, ectx->num, ectx->ids);
+  offsets = (*env)->NewIntArray(env, ectx->num + 1);
+  if (!offsets) {
+    goto finish;
+  }
+  (*env)->SetIntArrayRegion(env, offsets, 0, ectx->num + 1, ectx->offsets);
+  // Direct buffer over batch data, valid only within callback call
+  data = (*env)->NewDirectByteBuffer(env, iwxstr_ptr(ectx->xstr), iwxstr_size(ectx->xstr));
+  if (!data) {
+    goto finish;
+  }
+  if (!(*env)->CallBooleanMethod(env, ectx->cbObj, ectx->cbMid, ids, offsets, data)) {
+    ectx->stop = true;
+  }
+
+finish:
+  if (!ids || !offsets || !data) {
+    if (!(*env)->ExceptionCheck(env)) {
+      rc = JBN_ERROR_CREATION_OBJ;
+    }
+  }
+  if ((*env)->ExceptionCheck(env)) {
+    ectx->stop = true;
+  }
+  if (ids) {
+    (*env)->DeleteLocalRef(env, ids);
+  }
+  if (offsets) {
+    (*env)->DeleteLocalRef(env, offsets);
+  }
+  if (data) {
+    (*env)->DeleteLocalRef(env, data);
+  }
+  ectx->num = 0;
+  if (ectx->xstr_peak < iwxstr_size(ectx->xstr)) {
+    ectx->xstr_peak = iwxstr_size(ectx->xstr);
+  }
+  iwxstr_clear(ectx->xstr);
+  return rc;
+}
+
+static iwrc jbn_exec_batch_visitor(struct ejdb_exec *ux, EJDB_DOC doc, int64_t *step) {
+  iwrc rc;
+  JBN_EXEC_CTX *ectx = ux->opaque;
+  if (doc->node) {
+    rc = jbn_as_json(doc->node, jbl_xstr_json_printer, ectx->xstr, 0);
+  } else {
+    rc = jbl_as_json(doc->raw, jbl_xstr_json_printer, ectx->xstr, 0);
+  }
+  RCRET(rc);
+  if (iwxstr_size(ectx->xstr) > INT32_MAX) { // Offsets are `jint`
+    return IW_ERROR_OVERFLOW;
+  }
+  ectx->ids[ectx->num++] = doc->id;
+  ectx->offsets[ectx->num] = (jint) iwxstr_size(ectx->xstr);
+  // Batch is also limited by data size, keeping `jint` offsets and pooled buffers bounded
+  if (ectx->num >= ectx->batch_size || iwxstr_size(ectx->xstr) >= JBN_BATCH_MAX_BYTES) {
+    rc = jbn_exec_batch_flush(ectx);
+    if (ectx->stop) {
+      *step = 0;
+    }
+  }
+  return rc;
+}
+
+static void jbn_execute(
   JNIEnv *env,
   jobject thisObj,
   jobject dbObj,
   jobject cbObj,
-  jobject logStreamObj) {
+  jobject logStreamObj,
+  bool    buffer,
+  jint    batch_size) {
   iwrc rc;
   EJDB db;
   JQL q;
   IWXSTR *log = 0;
+  JBN_EXEC_CTX ectx = {
+    .env = env,
+    .cbObj = cbObj,
+    .buffer = buffer,
+    .batch_size = batch_size
+  };
 
   if (!dbObj) {
     jbn_throw_rc_exception(env, IW_ERROR_INVALID_ARGS, 0);
@@ -780,17 +997,26 @@ JNIEXPORT void JNICALL Java_com_softmotions_ejdb2_JQL__1execute(
   rc = jbn_db(env, dbObj, &db);
   RCGO(rc, finish);
 
-  JBN_EXEC_CTX ectx = {
-    .env = env,
-    .cbObj = cbObj
-  };
-
   if (cbObj) {
     ectx.cbClazz = (*env)->GetObjectClass(env, cbObj);
-    ectx.cbMid = (*env)->GetMethodID(env, ectx.cbClazz, "onRecord", "(JLjava/lang/String;)J");
+    if (batch_size > 0) {
+      ectx.cbMid = (*env)->GetMethodID(env, ectx.cbClazz, "onBatch", "([J[ILjava/nio/ByteBuffer;)Z");
+    } else {
+      ectx.cbMid = (*env)->GetMethodID(env, ectx.cbClazz, "onRecord",
+                                       buffer ? "(JLjava/nio/ByteBuffer;)J" : "(JLjava/lang/String;)J");
+    }
     if (!ectx.cbMid) {
       goto finish;
     }
+    if (batch_size > 0) {
+      ectx.ids = malloc(batch_size * sizeof(*ectx.ids));
+      ectx.offsets = calloc(batch_size + 1, sizeof(*ectx.offsets));
+      ectx.xstr = jbn_xstr_acquire(JBN_JSON_FLUSH_BUFFER_SZ);
+      if (!ectx.ids || !ectx.offsets || !ectx.xstr) {
+        rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+        goto finish;
+      }
+    }
   }
 
   jlong skip = (*env)->GetLongField(env, thisObj, k_JQL_skip_fid);
@@ -809,13 +1035,18 @@ JNIEXPORT void JNICALL Java_com_softmotions_ejdb2_JQL__1execute(
     .skip = skip > 0 ? skip : 0,
     .limit = limit > 0 ? limit : 0,
     .opaque = &ectx,
-    .visitor = cbObj ? jbn_exec_visitor : 0,
+    .visitor = cbObj ? (batch_size > 0 ? jbn_exec_batch_visitor : jbn_exec_visitor) : 0,
     .log = log
   };
 
   rc = ejdb_exec(&ux);
   RCGO(rc, finish);
 
+  if (ectx.num && !ectx.stop) { // Rest of batch
+    rc = jbn_exec_batch_flush(&ectx);
+    RCGO(rc, finish);
+  }
+
   if (log) { // Send query execution log
     size_t xsz = iwxstr_size(log);
     jclass logStreamClazz = (*env)->GetObjectClass(env, logStreamObj);
@@ -835,11 +1066,49 @@ finish:
   if (log) {
     iwxstr_destroy(log);
   }
+  free(ectx.ids);
+  free(ectx.offsets);
+  jbn_xstr_release(ectx.xstr, ectx.xstr_peak);
   if (rc) {
     jbn_throw_rc_exception(env, rc, 0);
   }
 }
 
+// JQL EXECUTE
+JNIEXPORT void JNICALL Java_com_softmotions_ejdb2_JQL__1execute(
+  JNIEnv *env,
+  jobject thisObj,
+  jobject dbObj,
+  jobject cbObj,
+  jobject logStreamObj) {
+  jbn_execute(env, thisObj, dbObj, cbObj, logStreamObj, false, 0);
+}
+
+// JQL EXECUTE BUFFER
+JNIEXPORT void JNICALL Java_com_softmotions_ejdb2_JQL__1execute_1buffer(
+  JNIEnv *env,
+  jobject thisObj,
+  jobject dbObj,
+  jobject cbObj,
+  jobject logStreamObj) {
+  jbn_execute(env, thisObj, dbObj, cbObj, logStreamObj, true, 0);
+}
+
+// JQL EXECUTE BATCHED
+JNIEXPORT void JNICALL Java_com_softmotions_ejdb2_JQL__1execute_1batched(
+  JNIEnv *env,
+  jobject thisObj,
+  jobject dbObj,
+  jint    batchSize,
+  jobject cbObj,
+  jobject logStreamObj) {
+  if (batchSize < 1) {
+    jbn_throw_rc_exception(env, IW_ERROR_INVALID_ARGS, 0);
+    return;
+  }
+  jbn_execute(env, thisObj, dbObj, cbObj, logStreamObj, true, batchSize);
+}
+
 // JQL EXECUTE SCALAR LONG
 JNIEXPORT jlong JNICALL Java_com_softmotions_ejdb2_JQL__1execute_1scalar_1long(
   JNIEnv *env,
@@ -1223,4 +1492,9 @@ JNIEXPORT void JNI_OnUnload(JavaVM *vm, void *reserved) { // Not really useless
   if (k_EJDB2Exception_clazz) {
     (*env)->DeleteGlobalRef(env, k_EJDB2Exception_clazz);
   }
+  pthread_mutex_lock(&k_xstr_pool_mtx);
+  while (k_xstr_pool_num > 0) {
+    iwxstr_destroy(k_xstr_pool[--k_xstr_pool_num]);
+  }
+  pthread_mutex_unlock(&k_xstr_pool_mtx);
 }
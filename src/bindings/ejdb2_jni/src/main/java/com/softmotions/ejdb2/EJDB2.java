@@ -83,6 +83,27 @@ public final class EJDB2 implements AutoCloseable {
     return new JQL(this, query, collection);
   }
 
+  /**
+   * Create a prepared query. Query is parsed once per thread and reused
+   * by every {@link PreparedJQL#get()} call made on that thread.
+   * <p>
+   * Note: collection name must be encoded in query, eg: {@code @mycoll/[foo=bar]}
+   * </p>
+   */
+  public PreparedJQL prepareQuery(String query) throws EJDB2Exception {
+    return new PreparedJQL(this, query, null);
+  }
+
+  /**
+   * Create a prepared query. Query is parsed once per thread and reused
+   * by every {@link PreparedJQL#get()} call made on that thread.
+   *
+   * @param collection Optional collection name
+   */
+  public PreparedJQL prepareQuery(String query, String collection) throws EJDB2Exception {
+    return new PreparedJQL(this, query, collection);
+  }
+
   /**
    * Persists {@code json} document into {@code collection}.
    *
@@ -139,6 +160,39 @@ public final class EJDB2 implements AutoCloseable {
     return _put(collection, json.toString(), id);
   }
 
+  /**
+   * Persists a batch of {@code jsons} documents into {@code collection}.
+   * <p>
+   * All documents are parsed and stored within single native call and
+   * single acquisition of collection write lock. Batch is not atomic:
+   * on error documents stored before failed one are kept.
+   *
+   * @param  collection     Collection name
+   * @param  jsons          JSON documents
+   * @return                Generated identifiers in order of {@code jsons}
+   * @throws EJDB2Exception
+   */
+  public long[] putBatch(String collection, String... jsons) throws EJDB2Exception {
+    return _put_batch(collection, jsons);
+  }
+
+  /**
+   * Persists a batch of {@code jsons} documents into {@code collection}.
+   *
+   * @param  collection     Collection name
+   * @param  jsons          JSON documents
+   * @return                Generated identifiers in order of {@code jsons}
+   * @throws EJDB2Exception
+   * @see                   #putBatch(String, String...)
+   */
+  public long[] putBatch(String collection, JSON... jsons) throws EJDB2Exception {
+    String[] data = new String[jsons.length];
+    for (int i = 0; i < jsons.length; ++i) {
+      data[i] = jsons[i].toString();
+    }
+    return _put_batch(collection, data);
+  }
+
   /**
    * Removes a document identified by given {@code id} from collection
    * {@code coll}.
@@ -497,6 +551,8 @@ public final class EJDB2 implements AutoCloseable {
 
   private native long _put(String collection, String json, long id) throws EJDB2Exception;
 
+  private native long[] _put_batch(String collection, String[] jsons) throws EJDB2Exception;
+
   private native void _del(String collection, long id) throws EJDB2Exception;
 
   private native void _rename_collection(String oldCollectionName, String newCollectionName) throws EJDB2Exception;
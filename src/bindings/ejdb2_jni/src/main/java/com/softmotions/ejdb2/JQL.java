@@ -5,6 +5,7 @@ import java.io.OutputStream;
 import java.io.UnsupportedEncodingException;
 import java.lang.ref.ReferenceQueue;
 import java.lang.ref.WeakReference;
+import java.nio.ByteBuffer;
 import java.util.ArrayList;
 import java.util.List;
 import java.util.Map;
@@ -40,6 +41,8 @@ import java.util.concurrent.ConcurrentHashMap;
  */
 public final class JQL implements AutoCloseable {
 
+  private static final int DEFAULT_BATCH_SIZE = 1024;
+
   private static final ReferenceQueue<JQL> refQueue = new ReferenceQueue<>();
 
   @SuppressWarnings("StaticCollection")
@@ -279,7 +282,7 @@ public final class JQL implements AutoCloseable {
       explain.reset();
     }
     if (cb != null) {
-      _execute(db, (id, sv) -> cb.onDocument(new EJDB2Document(id, sv)), explain);
+      _execute_buffer(db, (id, buf) -> cb.onDocument(new EJDB2Document(id, bytes(buf))), explain);
     } else {
       _execute(db, null, explain);
     }
@@ -305,11 +308,57 @@ public final class JQL implements AutoCloseable {
     }
   }
 
+  /**
+   * Execute query and handle raw document bodies by provided {@code cb}.
+   * Documents are passed as direct {@link ByteBuffer} with UTF-8 JSON data
+   * avoiding intermediate {@link String} conversions.
+   *
+   * @param  cb             Optional callback
+   * @throws EJDB2Exception
+   */
+  public void executeBuffer(JQLBufferCallback cb) throws EJDB2Exception {
+    if (explain != null) {
+      explain.reset();
+    }
+    _execute_buffer(db, cb, explain);
+  }
+
+  /**
+   * Execute query and handle result set by batches of up to {@code batchSize}
+   * documents. Every batch is passed to {@code cb} by single native upcall.
+   * Batch is flushed earlier once its JSON data exceeds 4MB.
+   *
+   * @param  batchSize      Max number of documents in batch
+   * @param  cb             Batch callback
+   * @throws EJDB2Exception
+   */
+  public void executeBatched(int batchSize, JQLBatchCallback cb) throws EJDB2Exception {
+    if (explain != null) {
+      explain.reset();
+    }
+    _execute_batched(db, batchSize, cb, explain);
+  }
+
+  /**
+   * Execute query and return all documents of result set.
+   * Use it with caution on large data sets.
+   *
+   * @throws EJDB2Exception
+   */
+  public EJDB2Document[] executeToArray() throws EJDB2Exception {
+    return list().toArray(new EJDB2Document[0]);
+  }
+
   public List<EJDB2Document> list() throws EJDB2Exception {
     List<EJDB2Document> list = new ArrayList<>();
-    execute((doc) -> {
-      list.add(doc);
-      return 1;
+    executeBatched(DEFAULT_BATCH_SIZE, (ids, offsets, data) -> {
+      for (int i = 0; i < ids.length; ++i) {
+        byte[] buf = new byte[offsets[i + 1] - offsets[i]];
+        data.position(offsets[i]);
+        data.get(buf);
+        list.add(new EJDB2Document(ids[i], buf));
+      }
+      return true;
     });
     return list;
   }
@@ -319,8 +368,8 @@ public final class JQL implements AutoCloseable {
     if (explain != null) {
       explain.reset();
     }
-    _execute(db, (id, json) -> {
-      v[0] = new EJDB2Document(id, json);
+    _execute_buffer(db, (id, buf) -> {
+      v[0] = new EJDB2Document(id, bytes(buf));
       return 0;
     }, explain);
     return v[0];
@@ -433,12 +482,22 @@ public final class JQL implements AutoCloseable {
     }
   }
 
+  private static byte[] bytes(ByteBuffer buf) {
+    byte[] data = new byte[buf.remaining()];
+    buf.get(data);
+    return data;
+  }
+
   private static native void _destroy(long handle);
 
   private native void _init(EJDB2 db, String query, String collection);
 
   private native void _execute(EJDB2 db, JQLCallback cb, OutputStream explainLog);
 
+  private native void _execute_buffer(EJDB2 db, JQLBufferCallback cb, OutputStream explainLog);
+
+  private native void _execute_batched(EJDB2 db, int batchSize, JQLBatchCallback cb, OutputStream explainLog);
+
   private native long _execute_scalar_long(EJDB2 db, OutputStream explainLog);
 
   private native void _reset();
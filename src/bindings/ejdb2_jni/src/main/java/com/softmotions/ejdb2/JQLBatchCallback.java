@@ -0,0 +1,24 @@
+package com.softmotions.ejdb2;
+
+import java.nio.ByteBuffer;
+
+/**
+ * SAM callback used iterate over query result set by batches of documents.
+ */
+public interface JQLBatchCallback {
+
+  /**
+   * Called on every batch of JSON records in result set.
+   *
+   * @param ids     Documents identifiers, number of documents in batch is
+   *                {@code ids.length}
+   * @param offsets {@code ids.length + 1} offsets of documents in {@code data}.
+   *                Document {@code i} occupies {@code [offsets[i], offsets[i + 1])}
+   *                range of {@code data}
+   * @param data    Direct buffer with concatenated UTF-8 encoded compact JSON
+   *                documents. Buffer memory is owned by database and valid only
+   *                within this call, copy data to keep it.
+   * @return {@code false} to stop iteration
+   */
+  boolean onBatch(long[] ids, int[] offsets, ByteBuffer data);
+}
@@ -0,0 +1,32 @@
+package com.softmotions.ejdb2;
+
+import java.nio.ByteBuffer;
+
+/**
+ * SAM callback used iterate over query result set
+ * without conversion of documents into {@link String}.
+ */
+public interface JQLBufferCallback {
+
+  /**
+   * Called on every JSON record in result set.
+   *
+   * Implementor can control iteration behavior by returning a step getting next
+   * record:
+   *
+   * <ul>
+   * <li>{@code 1} go to the next record</li>
+   * <li>{@code N} move forward by {@code N} records</li>
+   * <li>{@code -1} iterate current record again</li>
+   * <li>{@code -2} go to the previous record</li>
+   * <li>{@code 0} stop iteration</li>
+   * </ul>
+   *
+   * @param id   Current document identifier
+   * @param json Direct buffer with UTF-8 encoded compact JSON document body.
+   *             Buffer memory is owned by database and valid only
+   *             within this call, copy data to keep it.
+   * @return Number of records to skip
+   */
+  long onRecord(long id, ByteBuffer json);
+}
@@ -0,0 +1,86 @@
+package com.softmotions.ejdb2;
+
+/**
+ * Prepared query shared across threads.
+ * <p>
+ * Query text is parsed once per thread: every thread gets its own {@link JQL}
+ * instance which is reused by subsequent {@link #get()} calls made on that
+ * thread. Before being returned query is reset: placeholders are cleared and
+ * {@code skip}/{@code limit} overrides are dropped, so caller only needs to bind
+ * placeholders and execute query.
+ * <p>
+ * Typical usage:
+ *
+ * <pre>
+ * {@code
+ *    PreparedJQL pq = db.prepareQuery("/[foo=:val]", "mycoll");
+ *    ...
+ *    // On any thread
+ *    pq.get().setString("val", "bar").execute((docId, doc) -> {
+ *      System.out.println(String.format("Found %d %s", docId, doc));
+ *      return 1;
+ *    });
+ * }
+ * </pre>
+ * <p>
+ * Returned {@link JQL} instances are owned by prepared query and must not be
+ * closed by caller. Native resources are released once thread owning instance
+ * is gone and instance is garbage collected.
+ */
+public final class PreparedJQL {
+
+  private final EJDB2 db;
+
+  private final String query;
+
+  private final String collection;
+
+  private final ThreadLocal<JQL> local = new ThreadLocal<>();
+
+  PreparedJQL(EJDB2 db, String query, String collection) throws EJDB2Exception {
+    this.db = db;
+    this.query = query;
+    this.collection = collection;
+    // Parse query eagerly to report syntax errors on creation
+    local.set(new JQL(db, query, collection));
+  }
+
+  /**
+   * Owner database instance
+   */
+  public EJDB2 getDb() {
+    return db;
+  }
+
+  /**
+   * Query specification used to construct this prepared query.
+   */
+  public String getQuery() {
+    return query;
+  }
+
+  /**
+   * Collection name used for this query
+   */
+  public String getCollection() {
+    return collection;
+  }
+
+  /**
+   * Returns query instance bound to the current thread with all placeholders reset.
+   */
+  public JQL get() throws EJDB2Exception {
+    JQL q = local.get();
+    if (q == null) {
+      q = new JQL(db, query, collection);
+      local.set(q);
+    } else {
+      q.reset();
+      q.setSkip(0).setLimit(0);
+      if (collection != null) { // Otherwise keep collection from query text
+        q.setCollection(collection);
+      }
+    }
+    return q;
+  }
+}
@@ -2,6 +2,7 @@ package com.softmotions.ejdb2;
 
 import java.io.ByteArrayOutputStream;
 import java.io.File;
+import java.nio.charset.StandardCharsets;
 import java.util.LinkedHashMap;
 import java.util.Map;
 import java.util.Objects;
@@ -93,6 +94,18 @@ public class TestEJDB2 {
       assert (Objects.equals(results.get(2L), "{\"foo\":\"baz\"}"));
       results.clear();
 
+      q.executeBuffer((docId, buf) -> {
+        assert (buf.isDirect());
+        byte[] data = new byte[buf.remaining()];
+        buf.get(data);
+        results.put(docId, new String(data, StandardCharsets.UTF_8));
+        return 1;
+      });
+      assert (results.size() == 2);
+      assert (Objects.equals(results.get(1L), "{\"foo\":\"bar\"}"));
+      assert (Objects.equals(results.get(2L), "{\"foo\":\"baz\"}"));
+      results.clear();
+
       try (JQL q2 = db.createQuery("/[foo=:?]", "mycoll").setString(0, "zaz")) {
         q2.executeRaw((docId, doc) -> {
           results.put(docId, doc);
@@ -167,6 +180,38 @@ public class TestEJDB2 {
       // Test #333 
       db.put("test333", "{\"foo\":1.1}");
 
+      // Batch put
+      long[] ids = db.putBatch("batch", "{\"n\":1}", "{\"n\":2}", "{\"n\":3}");
+      assert (ids.length == 3);
+      assert (ids[0] == 1L && ids[1] == 2L && ids[2] == 3L);
+      assert (db.createQuery("@batch/* | count").executeScalarInt() == 3);
+
+      final int[] batches = { 0 };
+      db.createQuery("@batch/*").executeBatched(2, (bids, offsets, data) -> {
+        assert (data.isDirect());
+        assert (offsets.length == bids.length + 1);
+        batches[0]++;
+        return true;
+      });
+      assert (batches[0] == 2);
+      EJDB2Document[] docs = db.createQuery("@batch/* | asc /n").executeToArray();
+      assert (docs.length == 3);
+      assert (docs[0].id == 1L && docs[2].id == 3L);
+      assert (docs[1].json.get("n").asInteger() == 2);
+
+      PreparedJQL pq = db.prepareQuery("/[n=:?] | count", "batch");
+      JQL pq1 = pq.get();
+      assert (pq1.setLong(0, 2).executeScalarInt() == 1);
+      JQL pq2 = pq.get().setLimit(1);
+      assert (pq1 == pq2);
+      assert (pq2.setLong(0, 4).executeScalarInt() == 0);
+      assert (pq.get().getLimit() == 0);
+      final JQL[] pqt = { null };
+      Thread t = new Thread(() -> pqt[0] = pq.get());
+      t.start();
+      t.join();
+      assert (pqt[0] != null && pqt[0] != pq1);
+
       long ts0 = System.currentTimeMillis();
       long ts = db.onlineBackup("test-bkp.db");
       assert (ts > ts0);
@@ -818,6 +818,123 @@ static napi_value jn_patch_or_put(napi_env env, napi_callback_info info) {
   return jn_put_patch(env, info, true, true);
 }
 
+//  ---------------- EJDB2.putBatch()
+
+struct JNPUT_BATCH_DATA {
+  const char  *coll;
+  const char **jsons;
+  int64_t     *ids;
+  uint32_t     num;
+};
+
+static void jn_put_batch_execute(napi_env env, void *data) {
+  JBL *jbls = 0;
+  JNWORK work = data;
+  JBN jbn = work->unwrapped;
+  struct JNPUT_BATCH_DATA *wdata = work->data;
+  if (!jbn->db) {
+    work->rc = JN_ERROR_INVALID_STATE;
+    return;
+  }
+  if (!wdata->num) {
+    return;
+  }
+  jbls = calloc(wdata->num, sizeof(*jbls));
+  if (!jbls) {
+    work->rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    return;
+  }
+  // Parse all documents before database access
+  for (uint32_t i = 0; i < wdata->num; ++i) {
+    work->rc = jbl_from_json(&jbls[i], wdata->jsons[i]);
+    RCGO(work->rc, finish);
+  }
+  work->rc = ejdb_put_new_batch(jbn->db, wdata->coll, jbls, wdata->num, wdata->ids);
+
+finish:
+  for (uint32_t i = 0; i < wdata->num; ++i) {
+    if (jbls[i]) {
+      jbl_destroy(&jbls[i]);
+    }
+  }
+  free(jbls);
+}
+
+static void jn_put_batch_complete(napi_env env, napi_status ns, void *data) {
+  napi_value rv, vid;
+  JNWORK work = data;
+  if (jn_resolve_pending_errors(env, ns, work)) {
+    goto finish;
+  }
+  struct JNPUT_BATCH_DATA *wdata = work->data;
+  ns = napi_create_array_with_length(env, wdata->num, &rv);
+  for (uint32_t i = 0; !ns && i < wdata->num; ++i) {
+    ns = napi_create_int64(env, wdata->ids[i], &vid);
+    if (!ns) {
+      ns = napi_set_element(env, rv, i, vid);
+    }
+  }
+  if (ns) {
+    jn_resolve_pending_errors(env, ns, work);
+    goto finish;
+  }
+  JNGO(ns, env, napi_resolve_deferred(env, work->deferred, rv), finish);
+  work->deferred = 0;
+
+finish:
+  jn_work_destroy(env, &work);
+}
+
+// collection, [json]
+static napi_value jn_put_batch(napi_env env, napi_callback_info info) {
+  iwrc rc = 0;
+  napi_status ns = 0;
+  napi_value this, argv[2] = { 0 };
+  size_t argc = sizeof(argv) / sizeof(argv[0]);
+  void *data;
+  bool is_array = false;
+  napi_value ret = 0;
+  JNWORK work = jn_work_create(&rc);
+  RCGO(rc, finish);
+
+  JNGO(ns, env, napi_get_cb_info(env, info, &argc, argv, &this, &data), finish);
+  if (argc != sizeof(argv) / sizeof(argv[0])) {
+    rc = JN_ERROR_INVALID_NATIVE_CALL_ARGS;
+    goto finish;
+  }
+  JNGO(ns, env, napi_is_array(env, argv[1], &is_array), finish);
+  if (!is_array) {
+    rc = JN_ERROR_INVALID_NATIVE_CALL_ARGS;
+    goto finish;
+  }
+
+  struct JNPUT_BATCH_DATA *wdata = jn_work_alloc_data(sizeof(*wdata), work, &rc);
+  RCGO(rc, finish);
+  wdata->coll = jn_string(env, argv[0], work->pool, false, true, &rc);
+  RCGO(rc, finish);
+  JNGO(ns, env, napi_get_array_length(env, argv[1], &wdata->num), finish);
+  wdata->jsons = iwpool_calloc((wdata->num + 1) * sizeof(*wdata->jsons), work->pool);
+  wdata->ids = iwpool_calloc((wdata->num + 1) * sizeof(*wdata->ids), work->pool);
+  if (!wdata->jsons || !wdata->ids) {
+    rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    goto finish;
+  }
+  for (uint32_t i = 0; i < wdata->num; ++i) {
+    wdata->jsons[i] = jn_string_at(env, work->pool, argv[1], false, false, i, &rc);
+    RCGO(rc, finish);
+  }
+  ret = jn_launch_promise(env, info, "put_batch", jn_put_batch_execute, jn_put_batch_complete, work);
+
+finish:
+  if (rc) {
+    JNRC(env, rc);
+    if (work) {
+      jn_work_destroy(env, &work);
+    }
+  }
+  return ret ? ret : jn_undefined(env);
+}
+
 //  ---------------- EJDB2.get()
 
 struct JNGET_DATA {
@@ -1401,6 +1518,11 @@ finish:
 
 // ---------------- jql_stream_attach
 
+#define JN_STREAM_BATCH_DOCS  128   // Default max number of documents delivered by single stream call
+#define JN_STREAM_BATCH_BYTES 65536 // Default max size of JSON data delivered by single stream call
+
+struct JNCS;
+
 typedef struct JNQS { // query stream associated data
   volatile bool aborted;
   volatile bool paused;
@@ -1410,18 +1532,25 @@ typedef struct JNQS { // query stream associated data
   napi_ref stream_ref;      // Reference to the stream object
   napi_ref explain_cb_ref;  // Reference to the optional explain callback
   int64_t  limit;
+  int64_t  batch_docs;      // Max number of documents in a batch
+  int64_t  batch_bytes;     // Max size of batch JSON data
+  struct JNCS    *batch;    // Pending batch of documents, accessed only by query thread
   struct JNWORK   work;
   pthread_mutex_t mtx;
   pthread_cond_t  cond;
 } *JNQS;
 
 typedef struct JNCS { // call data to `k_add_stream_tsfn`
-  bool     has_count;
-  IWXSTR  *log;
-  IWXSTR  *document;
-  int64_t  count;
-  int64_t  document_id;
-  napi_ref stream_ref; // copied from `JNQS`
+  bool      has_count;
+  bool      last;        // Stream close event
+  IWXSTR   *log;
+  IWXSTR   *documents;   // Concatenated JSON documents
+  int64_t  *ids;         // Documents identifiers
+  uint32_t *offsets;     // `num + 1` offsets of documents in `documents`
+  size_t    num;         // Number of documents in batch
+  size_t    cap;         // Capacity of `ids` and `offsets` arrays
+  int64_t   count;
+  napi_ref  stream_ref;  // copied from `JNQS`
 } *JNCS;
 
 static void jn_cs_destroy(JNCS *csp) {
@@ -1429,17 +1558,69 @@ static void jn_cs_destroy(JNCS *csp) {
     return;
   }
   JNCS cs = *csp;
-  if (cs->document) {
-    iwxstr_destroy(cs->document);
+  if (cs->documents) {
+    iwxstr_destroy(cs->documents);
   }
   if (cs->log) {
     iwxstr_destroy(cs->log);
   }
+  free(cs->ids);
+  free(cs->offsets);
   free(cs);
   *csp = 0;
 }
 
-// function addStreamResult(stream, id, jsondoc, log)
+static iwrc jn_cs_create(JNQS qs, JNCS *csp) {
+  JNCS cs = calloc(1, sizeof(*cs));
+  if (!cs) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  cs->stream_ref = qs->stream_ref;
+  *csp = cs;
+  return 0;
+}
+
+static iwrc jn_cs_add(JNCS cs, EJDB_DOC doc) {
+  iwrc rc = 0;
+  if (!cs->documents) {
+    cs->documents = iwxstr_new();
+    if (!cs->documents) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+  }
+  if (cs->num + 1 >= cs->cap) {
+    size_t cap = cs->cap ? cs->cap * 2 : 32;
+    int64_t *ids = realloc(cs->ids, cap * sizeof(*ids));
+    if (!ids) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    cs->ids = ids;
+    uint32_t *offsets = realloc(cs->offsets, cap * sizeof(*offsets));
+    if (!offsets) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    cs->offsets = offsets;
+    cs->cap = cap;
+  }
+  if (cs->num == 0) {
+    cs->offsets[0] = iwxstr_size(cs->documents);
+  }
+  if (doc->node) {
+    rc = jbn_as_json(doc->node, jbl_xstr_json_printer, cs->documents, 0);
+  } else {
+    rc = jbl_as_json(doc->raw, jbl_xstr_json_printer, cs->documents, 0);
+  }
+  RCRET(rc);
+  cs->ids[cs->num++] = doc->id;
+  cs->offsets[cs->num] = iwxstr_size(cs->documents);
+  return rc;
+}
+
+static void jn_free_buffer(napi_env env, void *data, void *hint) {
+  free(data);
+}
+
+// function addStreamResults(stream, ids, offsets, data, last, log)
 static void jn_resultset_tsf(
   napi_env   env,
   napi_value js_add_stream,
@@ -1453,40 +1634,64 @@ static void jn_resultset_tsf(
 
   JNCS cs = data;
   napi_status ns;
-  napi_value vstream, vid, vdoc, vlog, vresult;
+  napi_value vstream, vids, voffsets, vdata, vlast, vlog, vresult;
   napi_value vglobal = jn_global(env);
   napi_value vnull = jn_null(env);
+  napi_value vundefined = jn_undefined(env);
 
-  if (!vglobal || !vnull) {
+  if (!vglobal || !vnull || !vundefined) {
     goto finish;
   }
   vstream = jn_get_ref(env, cs->stream_ref);
   if (!vstream) { // exception pending
     goto finish;
   }
-  if (cs->document) {
-    vdoc = jn_create_string(env, iwxstr_ptr(cs->document));
-    iwxstr_destroy(cs->document);
-    cs->document = 0;
-  } else if (cs->has_count) {
-    vdoc = jn_create_int64(env, cs->count);
+  if (cs->num) {
+    void *buf;
+    napi_value vab;
+    JNGO(ns, env, napi_create_arraybuffer(env, cs->num * sizeof(double), &buf, &vab), finish);
+    for (size_t i = 0; i < cs->num; ++i) {
+      ((double*) buf)[i] = (double) cs->ids[i];
+    }
+    JNGO(ns, env, napi_create_typedarray(env, napi_float64_array, cs->num, vab, 0, &vids), finish);
+    JNGO(ns, env, napi_create_arraybuffer(env, (cs->num + 1) * sizeof(uint32_t), &buf, &vab), finish);
+    memcpy(buf, cs->offsets, (cs->num + 1) * sizeof(uint32_t));
+    JNGO(ns, env, napi_create_typedarray(env, napi_uint32_array, cs->num + 1, vab, 0, &voffsets), finish);
+    size_t sz = iwxstr_size(cs->documents);
+    ns = napi_create_external_buffer(env, sz, iwxstr_ptr(cs->documents), jn_free_buffer, 0, &vdata);
+    if (ns == napi_ok) {
+      // Buffer memory is owned by `vdata` now
+      iwxstr_destroy_keep_ptr(cs->documents);
+      cs->documents = 0;
+    } else if (ns == napi_no_external_buffers_allowed) {
+      JNGO(ns, env, napi_create_buffer_copy(env, sz, iwxstr_ptr(cs->documents), 0, &vdata), finish);
+    } else {
+      JNCHECK(ns, env);
+      goto finish;
+    }
   } else {
-    vdoc = vnull;
-  }
-  if (!vdoc) {
-    goto finish;
+    vids = vnull;
+    voffsets = vnull;
+    vdata = vnull;
   }
-  vid = jn_create_int64(env, cs->document_id);
-  if (!vid) {
-    goto finish;
+  if (cs->last) {
+    vlast = cs->has_count ? jn_create_int64(env, cs->count) : vnull;
+    if (!vlast) {
+      goto finish;
+    }
+  } else {
+    vlast = vundefined;
   }
   if (cs->log) {
     vlog = jn_create_string(env, iwxstr_ptr(cs->log));
+    if (!vlog) {
+      goto finish;
+    }
   } else {
     vlog = vnull;
   }
 
-  napi_value argv[] = { vstream, vid, vdoc, vlog };
+  napi_value argv[] = { vstream, vids, voffsets, vdata, vlast, vlog };
   const int argc = sizeof(argv) / sizeof(argv[0]);
   JNGO(ns, env, napi_call_function(
          env,
@@ -1498,7 +1703,7 @@ static void jn_resultset_tsf(
          ), finish);
 
 finish:
-  if (cs->document_id < 0) {
+  if (cs->last) {
     uint32_t refs;
     napi_reference_unref(env, cs->stream_ref, &refs);
   }
@@ -1517,6 +1722,7 @@ static void jn_jnqs_destroy_mt(napi_env env, JNQS *qsp) {
   if (qs->jnql) {
     qs->jnql->refs--;
   }
+  jn_cs_destroy(&qs->batch);
   if (qs->stream_ref) {
     napi_reference_unref(env, qs->stream_ref, &rcnt);
     if (!rcnt) {
@@ -1553,8 +1759,21 @@ static iwrc jn_stream_pause_guard(JNQS qs) {
   return rc;
 }
 
+static iwrc jn_stream_flush(JNQS qs) {
+  JNWORK work = &qs->work;
+  if (!qs->batch) {
+    return 0;
+  }
+  napi_status ns = napi_call_threadsafe_function(qs->jbn->resultset_tsf, qs->batch, napi_tsfn_blocking);
+  if (ns) {
+    work->ns = ns;
+    return JN_ERROR_NAPI;
+  }
+  qs->batch = 0; // Owned by `jn_resultset_tsf` now
+  return 0;
+}
+
 static iwrc jn_jql_stream_visitor(EJDB_EXEC *ux, EJDB_DOC doc, int64_t *step) {
-  JNCS cs = 0;
   JNQS qs = ux->opaque;
   JNWORK work = &qs->work;
 
@@ -1562,48 +1781,28 @@ static iwrc jn_jql_stream_visitor(EJDB_EXEC *ux, EJDB_DOC doc, int64_t *step) {
     *step = 0;
     return 0;
   }
+  if (qs->paused && qs->batch) {
+    // Deliver what we have before blocking on paused stream
+    work->rc = jn_stream_flush(qs);
+    RCRET(work->rc);
+  }
   work->rc = jn_stream_pause_guard(qs);
   RCRET(work->rc);
 
-  IWXSTR *xstr = iwxstr_new();
-  if (!xstr) {
-    work->rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
-    return work->rc;
-  }
-  if (doc->node) {
-    work->rc = jbn_as_json(doc->node, jbl_xstr_json_printer, xstr, 0);
-  } else {
-    work->rc = jbl_as_json(doc->raw, jbl_xstr_json_printer, xstr, 0);
+  if (!qs->batch) {
+    work->rc = jn_cs_create(qs, &qs->batch);
+    RCRET(work->rc);
   }
-  RCGO(work->rc, finish);
+  JNCS cs = qs->batch;
+  work->rc = jn_cs_add(cs, doc);
+  RCRET(work->rc);
 
-  cs = malloc(sizeof(*cs));
-  if (!cs) {
-    work->rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
-    goto finish;
+  if (ux->log) {
+    cs->log = ux->log;
+    ux->log = 0;
   }
-  cs->count = 0;
-  cs->has_count = false;
-  cs->stream_ref = qs->stream_ref;
-  cs->log = ux->log;
-  cs->document_id = doc->id;
-  cs->document = xstr;
-
-  napi_status ns = napi_call_threadsafe_function(qs->jbn->resultset_tsf, cs, napi_tsfn_blocking);
-  if (ns) {
-    work->rc = JN_ERROR_NAPI;
-    work->ns = ns;
-    goto finish;
-  }
-  ux->log = 0;
-
-finish:
-  if (work->rc) {
-    iwxstr_destroy(xstr);
-    if (cs) {
-      cs->document = 0; // kept in xstr
-      jn_cs_destroy(&cs);
-    }
+  if ((int64_t) cs->num >= qs->batch_docs || (int64_t) iwxstr_size(cs->documents) >= qs->batch_bytes) {
+    work->rc = jn_stream_flush(qs);
   }
   return work->rc;
 }
@@ -1614,7 +1813,6 @@ static void jn_jql_stream_execute(napi_env env, void *data) {
   JNWORK work = data;
   JNQS qs = work->data;
   JQL q = qs->jnql->jql;
-  JNCS cs = 0;
   EJDB_EXEC ux = { 0 };
   bool has_count = jql_has_aggregate_count(q);
 
@@ -1645,27 +1843,23 @@ static void jn_jql_stream_execute(napi_env env, void *data) {
   work->rc = ejdb_exec(&ux);
   RCGO(work->rc, finish);
 
-  // Stream close event
-  cs = malloc(sizeof(*cs));
-  if (!cs) {
-    work->rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
-    goto finish;
+  // Stream close event, carries the rest of pending documents
+  if (!qs->batch) {
+    work->rc = jn_cs_create(qs, &qs->batch);
+    RCGO(work->rc, finish);
   }
+  JNCS cs = qs->batch;
+  cs->last = true;
   cs->has_count = has_count;
   cs->count = ux.cnt;
-  cs->stream_ref = qs->stream_ref;
-  cs->log = ux.log;
-  cs->document_id = -1;
-  cs->document = 0;
-  ux.log = 0;
-
-  ns = napi_call_threadsafe_function(qs->jbn->resultset_tsf, cs, napi_tsfn_blocking);
-  if (ns) {
-    work->rc = JN_ERROR_NAPI;
-    work->ns = ns;
-    goto finish;
+  if (ux.log) {
+    cs->log = ux.log;
+    ux.log = 0;
   }
 
+  work->rc = jn_stream_flush(qs);
+  RCGO(work->rc, finish);
+
   refs = 0;
 
 finish:
@@ -1675,9 +1869,7 @@ finish:
   if (ux.log) {
     iwxstr_destroy(ux.log);
   }
-  if (work->rc) {
-    jn_cs_destroy(&cs);
-  }
+  jn_cs_destroy(&qs->batch);
 }
 
 static void jn_jql_stream_complete(napi_env env, napi_status ns, void *data) {
@@ -1778,7 +1970,7 @@ finish:
   return jn_undefined(env);
 }
 
-// JQL._impl.jql_stream_attach(this, stream, [opts.limit, opts.explainCallback]);
+// JQL._impl.jql_stream_attach(this, stream, [opts.limit, opts.explainCallback, opts.batchSize, opts.batchBytes]);
 static napi_value jn_jql_stream_attach(napi_env env, napi_callback_info info) {
   iwrc rc = 0;
   napi_status ns;
@@ -1813,6 +2005,16 @@ static napi_value jn_jql_stream_attach(napi_env env, napi_callback_info info) {
   qs->jnql->refs++; // Query in use
   qs->limit = jn_int_at(env, argv[2], true, false, 0, &rc);
   RCGO(rc, finish);
+  qs->batch_docs = jn_int_at(env, argv[2], true, false, 2, &rc);
+  RCGO(rc, finish);
+  if (qs->batch_docs < 1) {
+    qs->batch_docs = JN_STREAM_BATCH_DOCS;
+  }
+  qs->batch_bytes = jn_int_at(env, argv[2], true, false, 3, &rc);
+  RCGO(rc, finish);
+  if (qs->batch_bytes < 1) {
+    qs->batch_bytes = JN_STREAM_BATCH_BYTES;
+  }
 
   JNGO(ns, env, napi_get_element(env, argv[2], 1, &vexplain), finish);
   if (!jn_is_null_or_undefined(env, vexplain)) {
@@ -2005,6 +2207,39 @@ finish:
   return ret ? ret : jn_undefined(env);
 }
 
+// jql_reset(jql);
+// Resets placeholders and match state of query kept alive for reuse.
+// Returns `false` if query is still in use by active stream and cannot be reset.
+static napi_value jn_jql_reset(napi_env env, napi_callback_info info) {
+  iwrc rc = 0;
+  napi_status ns;
+  napi_value ret = 0, argv, this;
+  size_t argc = 1;
+  void *data;
+  JNQL jnql;
+
+  JNGO(ns, env, napi_get_cb_info(env, info, &argc, &argv, &this, &data), finish);
+  if (argc != 1) {
+    rc = JN_ERROR_INVALID_NATIVE_CALL_ARGS;
+    goto finish;
+  }
+  JNGO(ns, env, napi_unwrap(env, argv, &data), finish);
+  jnql = data;
+
+  if (jnql->refs > 0) {
+    JNGO(ns, env, napi_get_boolean(env, false, &ret), finish);
+    goto finish;
+  }
+  jql_reset(jnql->jql, true, true);
+  JNGO(ns, env, napi_get_boolean(env, true, &ret), finish);
+
+finish:
+  if (rc) {
+    JNRC(env, rc);
+  }
+  return ret ? ret : jn_undefined(env);
+}
+
 // ----------------
 
 static const char* jn_ecodefn(locale_t locale, uint32_t ecode) {
@@ -2045,6 +2280,7 @@ napi_value Init(napi_env env, napi_value exports) {
     JNFUNC(open),
     JNFUNC(close),
     JNFUNC(put),
+    JNFUNC(put_batch),
     JNFUNC(patch),
     JNFUNC(patch_or_put),
     JNFUNC(get),
@@ -2057,6 +2293,7 @@ napi_value Init(napi_env env, napi_value exports) {
     JNFUNC(jql_init),
     JNFUNC(jql_set),
     JNFUNC(jql_limit),
+    JNFUNC(jql_reset),
     JNFUNC(jql_stream_destroy),
     JNFUNC(jql_stream_attach),
     JNFUNC(jql_stream_pause),
@@ -61,6 +61,17 @@ declare namespace ejdb2_node {
      */
     json: T;
 
+    /**
+     * Document JSON as string
+     */
+    readonly raw: string;
+
+    /**
+     * UTF-8 encoded document JSON.
+     * Shares memory with query result batch, decoded only on `json` or `raw` access.
+     */
+    readonly buffer: Buffer;
+
     /**
      * String represen
      */
@@ -84,6 +95,18 @@ declare namespace ejdb2_node {
      * Calback used to get query execution log.
      */
     explainCallback?: (log: string) => void;
+
+    /**
+     * Max number of documents delivered from database thread
+     * to the result stream at once. Default: 128
+     */
+    batchSize?: number;
+
+    /**
+     * Max size in bytes of documents JSON delivered from database thread
+     * to the result stream at once. Default: 65536
+     */
+    batchBytes?: number;
   }
 
   /**
@@ -166,6 +189,33 @@ declare namespace ejdb2_node {
     setNull(placeholder: Placeholder): JQL;
   }
 
+  /**
+   * Prepared query.
+   * Query text is parsed once and parsed queries are reused.
+   */
+  class PreparedJQL {
+    /**
+     * Database to which query attached.
+     */
+    readonly db: EJDB2;
+
+    /**
+     * Returns query instance with all placeholders reset.
+     */
+    acquire(): JQL;
+
+    /**
+     * Returns query obtained by `acquire()` back for reuse.
+     */
+    release(jql: JQL): void;
+
+    /**
+     * Acquires query, calls [fn] with it and releases query
+     * once promise returned by [fn] is settled.
+     */
+    use<T>(fn: (jql: JQL) => Promise<T>): Promise<T>;
+  }
+
   interface OpenOptions {
     /**
      * Open databas in read-only mode.
@@ -363,6 +413,13 @@ declare namespace ejdb2_node {
      */
     put(collection: String, json: object | string, id?: number): Promise<number>;
 
+    /**
+     * Saves a batch of `docs` into `collection` under new generated identifiers.
+     * All documents are stored within single collection write lock acquisition.
+     * Returns promise holding array of new document identifiers.
+     */
+    putBatch(collection: String, docs: Array<object | string>): Promise<Array<number>>;
+
     /**
      * Apply rfc6902/rfc7386 JSON [patch] to the document identified by [id].
      */
@@ -449,6 +506,12 @@ declare namespace ejdb2_node {
      */
     createQuery(query: string, collection?: string): JQL;
 
+    /**
+     * Create prepared [query] specified for [collection].
+     * Query is parsed once and reused by subsequent `acquire()` calls.
+     */
+    prepareQuery(query: string, collection?: string, maxIdle?: number): PreparedJQL;
+
     /**
      * Creates an online database backup image and copies it into the specified [fileName].
      * During online backup phase read/write database operations are allowed and not
@@ -32,7 +32,7 @@ if (!semver.satisfies(process.version, engines.node)) {
   process.exit(1);
 }
 
-global.__ejdb_add_stream_result__ = addStreamResult; // Passing it to ejdb2_node init
+global.__ejdb_add_stream_result__ = addStreamResults; // Passing it to ejdb2_node init
 const { EJDB2Impl } = require("./binary")("ejdb2_node");
 const { Readable } = require("stream");
 delete global.__ejdb_add_stream_result__;
@@ -73,14 +73,39 @@ class JBDOC {
     if (this._json != null) {
       return this._json;
     }
-    this._json = JSON.parse(this._raw);
+    this._json = JSON.parse(this.raw);
     this._raw = null;
     return this._json;
   }
 
+  /**
+   * Get document JSON as string
+   */
+  get raw() {
+    if (this._raw == null) {
+      return JSON.stringify(this._json);
+    }
+    if (Buffer.isBuffer(this._raw)) {
+      this._raw = this._raw.toString("utf8");
+    }
+    return this._raw;
+  }
+
+  /**
+   * Get UTF-8 encoded document JSON as Buffer.
+   * Buffer returned by query stream shares memory with native result batch
+   * and decoded only on `json` or `raw` access. Whole document is decoded at once.
+   */
+  get buffer() {
+    if (Buffer.isBuffer(this._raw)) {
+      return this._raw;
+    }
+    return Buffer.from(String(this.raw), "utf8");
+  }
+
   /**
    * @param {number} id Document ID
-   * @param {string} raw Document JSON as string
+   * @param {string|Buffer} raw Document JSON as string or UTF-8 buffer
    */
   constructor(id, raw) {
     this.id = id;
@@ -89,7 +114,7 @@ class JBDOC {
   }
 
   toString() {
-    return `JBDOC: ${this.id} ${this._raw != null ? this._raw : JSON.stringify(this.json)}`;
+    return `JBDOC: ${this.id} ${this.raw}`;
   }
 }
 
@@ -121,7 +146,7 @@ class JBDOCStream extends Readable {
     this.jql = jql;
     this.opts = opts;
     this.promise = this._impl
-      .jql_stream_attach(jql, this, [opts.limit, opts.explainCallback])
+      .jql_stream_attach(jql, this, [opts.limit, opts.explainCallback, opts.batchSize, opts.batchBytes])
       .catch((err) => this.destroy(err));
   }
 
@@ -188,7 +213,22 @@ class JBDOCStream extends Readable {
   }
 }
 
-// Global module function for add results to query stream
+// Global module function called by native code to add batch of results to query stream.
+// Documents JSON are concatenated into `data` buffer, `offsets` has `ids.length + 1` elements.
+// Documents are passed as `data` views, no copying or decoding is done here.
+// `last` is `undefined` until stream close event.
+function addStreamResults(stream, ids, offsets, data, last, log) {
+  if (ids != null) {
+    for (let i = 0; i < ids.length; ++i) {
+      addStreamResult(stream, ids[i], data.subarray(offsets[i], offsets[i + 1]), log);
+      log = null;
+    }
+  }
+  if (last !== undefined) {
+    addStreamResult(stream, -1, last, log);
+  }
+}
+
 function addStreamResult(stream, id, jsondoc, log) {
   if (stream._destroyed) {
     return;
@@ -260,6 +300,8 @@ class JQL {
   /**
    * Executes a query and returns a
    * readable stream of matched documents.
+   * Documents are delivered from database thread in batches
+   * limited by `opts.batchSize` documents and `opts.batchBytes` bytes.
    *
    * @param {Object} [opts]
    * @return {ReadableStream<JBDOC>}
@@ -449,6 +491,73 @@ class JQL {
   }
 }
 
+/**
+ * Prepared query.
+ * Query text is parsed once and parsed JQL instances are kept
+ * for reuse by subsequent `acquire()` calls.
+ */
+class PreparedJQL {
+  /**
+   * @param {EJDB2} db
+   * @param {string} query
+   * @param {string} [collection]
+   * @param {number} [maxIdle] Maximum number of idle queries kept for reuse.
+   */
+  constructor(db, query, collection, maxIdle) {
+    this.db = db;
+    this.query = query;
+    this.collection = collection;
+    this.maxIdle = maxIdle > 0 ? maxIdle : 16;
+    // Parse query eagerly to report syntax errors on creation
+    this._idle = [new JQL(db, query, collection)];
+  }
+
+  /**
+   * Returns query instance with all placeholders reset.
+   * Reuses idle query released by `release()` or creates a new one.
+   * @return {JQL}
+   */
+  acquire() {
+    for (let i = this._idle.length - 1; i >= 0; --i) {
+      const q = this._idle[i];
+      // Query may be still referenced by stream pending destruction
+      if (q._impl.jql_reset(q)) {
+        this._idle.splice(i, 1);
+        q.collection = this.collection;
+        return q;
+      }
+    }
+    return new JQL(this.db, this.query, this.collection);
+  }
+
+  /**
+   * Returns query obtained by `acquire()` back for reuse.
+   * Query must not be used by caller after this call.
+   * @param {JQL} jql
+   */
+  release(jql) {
+    if (jql != null && this._idle.length < this.maxIdle) {
+      this._idle.push(jql);
+    }
+  }
+
+  /**
+   * Acquires query, calls [fn] with it and releases query
+   * once promise returned by [fn] is settled.
+   *
+   * @param {function(JQL): Promise<*>} fn
+   * @return {Promise<*>}
+   */
+  async use(fn) {
+    const q = this.acquire();
+    try {
+      return await fn(q);
+    } finally {
+      this.release(q);
+    }
+  }
+}
+
 /**
  * EJDB2 Nodejs wrapper.
  */
@@ -522,6 +631,22 @@ class EJDB2 {
     return this._impl.put(collection, json, id);
   }
 
+  /**
+   * Saves a batch of [docs] into [collection] under new generated identifiers.
+   * Documents are parsed and stored by single native call within
+   * single collection write lock acquisition. Batch is not atomic:
+   * on error documents stored before failed one are kept.
+   * Returns promise holding array of new document identifiers.
+   *
+   * @param {String} collection
+   * @param {Array<Object|string>} docs
+   * @returns {Promise<Array<number>>}
+   */
+  putBatch(collection, docs) {
+    const jsons = docs.map((json) => (typeof json !== "string" ? JSON.stringify(json) : json));
+    return this._impl.put_batch(collection, jsons);
+  }
+
   /**
    * Apply rfc6902/rfc7386 JSON [patch] to the document identified by [id].
    *
@@ -702,6 +827,19 @@ class EJDB2 {
     return new JQL(this, query, collection);
   }
 
+  /**
+   * Create prepared [query] specified for [collection].
+   * Query is parsed once and reused by subsequent `acquire()` calls.
+   *
+   * @param {String} query
+   * @param {String} [collection]
+   * @param {number} [maxIdle] Maximum number of idle queries kept for reuse.
+   * @returns {PreparedJQL}
+   */
+  prepareQuery(query, collection, maxIdle) {
+    return new PreparedJQL(this, query, collection, maxIdle);
+  }
+
   /**
    * Creates an online database backup image and copies it into the specified [fileName].
    * During online backup phase read/write database operations are allowed and not
@@ -221,6 +221,33 @@ test('Main', async (t) => {
   doc = await db.get('cc2', id);
   t.deepEqual(doc, { 'foo': 1 });
 
+  // Batched stream delivery
+  const bdocs = [];
+  for (let i = 0; i < 300; ++i) {
+    bdocs.push({ 'n': i, 's': 'жёлудь' });
+  }
+  const bids = await db.putBatch('bc', bdocs);
+  t.is(bids.length, 300);
+  t.is(bids[0], 1);
+  t.is(bids[299], 300);
+  rbuf.length = 0;
+  for await (const doc of db.createQuery('@bc/* | asc /n').stream({ batchSize: 7, batchBytes: 256 })) {
+    t.true(Buffer.isBuffer(doc.buffer));
+    t.is(doc.json.s, 'жёлудь');
+    rbuf.push(doc.json.n);
+  }
+  t.is(rbuf.length, 300);
+  t.is(rbuf[0], 0);
+  t.is(rbuf[299], 299);
+
+  const pq = db.prepareQuery('/[n = :?] | count', 'bc');
+  const pq1 = pq.acquire();
+  t.is(await pq1.setNumber(0, 5).scalarInt(), 1);
+  pq.release(pq1);
+  count = await pq.use((q) => q.setNumber(0, 500).scalarInt());
+  t.is(count, 0);
+  t.is(await pq.use((q) => q.setNumber(0, 7).scalarInt()), 1);
+
   const ts0 = +new Date();
   const ts = await db.onlineBackup('hello-bkp.db');
   t.true(ts0 < ts);
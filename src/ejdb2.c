@@ -1,5 +1,6 @@
 #include "ejdb2_internal.h"
 #include <iowow/wyhash32.h>
+#include <iowow/iwp.h>
 
 #ifdef IW_BLOCKS
 #include <Block.h>
@@ -9,6 +10,50 @@ static iwrc _jb_put_new_lw(struct jbcoll *jbc, struct jbl *jbl, int64_t *id);
 
 static const struct iwkv_val EMPTY_VAL = { 0 };
 
+// Upper bounds of latency histogram buckets in microseconds, the last `+Inf` bucket is implicit
+static const uint64_t _jb_hist_bounds[JB_HIST_BUCKETS - 1] = {
+  100, 250, 500, 1000, 2500, 5000, 10000, 25000, 50000, 100000, 250000, 500000, 1000000, 5000000
+};
+
+static const char *_jb_scanner_names[JB_SCANNER_NUM] = { "pk", "uniq", "dup", "fts", "full", "distinct" };
+
+static uint64_t _jb_time_us(void) {
+  struct timespec ts;
+  clock_gettime(CLOCK_MONOTONIC, &ts);
+  return (uint64_t) ts.tv_sec * 1000000 + (uint64_t) ts.tv_nsec / 1000;
+}
+
+static void _jb_hist_observe(struct jbhist *h, uint64_t v) {
+  int i = 0;
+  while (i < JB_HIST_BUCKETS - 1 && v > _jb_hist_bounds[i]) {
+    ++i;
+  }
+  JB_METRIC_ADD(h->buckets[i], 1);
+  JB_METRIC_ADD(h->count, 1);
+  JB_METRIC_ADD(h->sum, v);
+}
+
+// Only contended lock acquisitions are timed
+int jb_rwlock_rdlock(pthread_rwlock_t *rwl, struct jbhist *wait) {
+  int rci = pthread_rwlock_tryrdlock(rwl);
+  if (rci == EBUSY) {
+    uint64_t ts = _jb_time_us();
+    rci = pthread_rwlock_rdlock(rwl);
+    _jb_hist_observe(wait, _jb_time_us() - ts);
+  }
+  return rci;
+}
+
+int jb_rwlock_wrlock(pthread_rwlock_t *rwl, struct jbhist *wait) {
+  int rci = pthread_rwlock_trywrlock(rwl);
+  if (rci == EBUSY) {
+    uint64_t ts = _jb_time_us();
+    rci = pthread_rwlock_wrlock(rwl);
+    _jb_hist_observe(wait, _jb_time_us() - ts);
+  }
+  return rci;
+}
+
 IW_INLINE iwrc _jb_meta_nrecs_removedb(struct ejdb *db, uint32_t dbid) {
   dbid = IW_HTOIL(dbid);
   struct iwkv_val key = {
@@ -66,6 +111,192 @@ static void _jb_coll_release(struct jbcoll *jbc) {
   free(jbc);
 }
 
+// Cached document, entry itself is used as map key
+struct jbdcentry {
+  int64_t  id;
+  uint32_t dbid;
+  uint32_t size;              /**< Document data size */
+  struct jbdcshard *shard;
+  uint8_t data[];
+};
+
+static int _jb_dcache_cmp(const void *v1, const void *v2) {
+  const struct jbdcentry *e1 = v1;
+  const struct jbdcentry *e2 = v2;
+  int ret = e1->id > e2->id ? 1 : e1->id < e2->id ? -1 : 0;
+  if (!ret) {
+    return e1->dbid > e2->dbid ? 1 : e1->dbid < e2->dbid ? -1 : 0;
+  }
+  return ret;
+}
+
+static uint32_t _jb_dcache_hash(const void *key) {
+  const struct jbdcentry *e = key;
+  return wyhash32(&e->id, sizeof(e->id), e->dbid);
+}
+
+// Called with shard mutex locked
+static void _jb_dcache_kvfree(void *key, void *val) {
+  struct jbdcentry *e = val;
+  e->shard->size -= sizeof(*e) + e->size;
+  free(e);
+}
+
+static bool _jb_dcache_eviction_needed(IWHMAP *hm, void *op) {
+  struct jbdcshard *s = op;
+  return s->size > s->max_size;
+}
+
+IW_INLINE struct jbdcshard* _jb_dcache_shard(struct jbdcache *dc, const struct jbdcentry *k) {
+  return &dc->shards[(_jb_dcache_hash(k) >> 16) % JB_DCACHE_SHARDS];
+}
+
+static void _jb_dcache_destroy(struct ejdb *db) {
+  struct jbdcache *dc = db->dcache;
+  if (!dc) {
+    return;
+  }
+  db->dcache = 0;
+  for (int i = 0; i < JB_DCACHE_SHARDS; ++i) {
+    struct jbdcshard *s = &dc->shards[i];
+    if (s->map) {
+      iwhmap_destroy(s->map);
+      pthread_mutex_destroy(&s->mtx);
+    }
+  }
+  free(dc);
+}
+
+static iwrc _jb_dcache_init(struct ejdb *db) {
+  struct jbdcache *dc = calloc(1, sizeof(*dc));
+  if (!dc) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  db->dcache = dc;
+  for (int i = 0; i < JB_DCACHE_SHARDS; ++i) {
+    struct jbdcshard *s = &dc->shards[i];
+    s->max_size = db->opts.document_cache_sz / JB_DCACHE_SHARDS;
+    s->map = iwhmap_create(_jb_dcache_cmp, _jb_dcache_hash, _jb_dcache_kvfree);
+    if (!s->map) {
+      _jb_dcache_destroy(db);
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    iwhmap_lru_init(s->map, _jb_dcache_eviction_needed, s);
+    pthread_mutex_init(&s->mtx, 0);
+  }
+  return 0;
+}
+
+// Lookups document holding only database lock.
+// `*jblp` is left zero on cache miss.
+static iwrc _jb_dcache_get(struct ejdb *db, const char *coll, int64_t id, struct jbl **jblp) {
+  int rci;
+  iwrc rc = 0;
+  void *buf = 0;
+  size_t bufsz = 0;
+  API_RLOCK(db, rci);
+
+  struct jbcoll *jbc = iwhmap_get(db->mcolls, coll);
+  if (jbc) {
+    struct jbdcentry k = { .id = id, .dbid = jbc->dbid };
+    struct jbdcshard *s = _jb_dcache_shard(db->dcache, &k);
+    pthread_mutex_lock(&s->mtx);
+    struct jbdcentry *e = iwhmap_get(s->map, &k);
+    if (e) {
+      buf = malloc(e->size);
+      if (buf) {
+        memcpy(buf, e->data, e->size);
+        bufsz = e->size;
+      } else {
+        rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      }
+    }
+    pthread_mutex_unlock(&s->mtx);
+    if (buf) {
+      rc = jbl_from_buf_keep(jblp, buf, bufsz, false);
+      if (rc) {
+        free(buf);
+      } else {
+        JB_METRIC_ADD(jbc->metrics.gets, 1);
+        JB_METRIC_ADD(db->metrics.dcache_hits, 1);
+      }
+    }
+  }
+
+  API_UNLOCK(db, rci, rc);
+  return rc;
+}
+
+// Must be called holding collection lock, so cache is consistent with concurrent writers
+static void _jb_dcache_put(struct jbcoll *jbc, int64_t id, const void *data, size_t size) {
+  struct jbdcache *dc = jbc->db->dcache;
+  struct jbdcentry k = { .id = id, .dbid = jbc->dbid };
+  struct jbdcshard *s = _jb_dcache_shard(dc, &k);
+  if (size > s->max_size / 4) { // Large documents are not cached
+    return;
+  }
+  struct jbdcentry *e = malloc(sizeof(*e) + size);
+  if (!e) {
+    return;
+  }
+  memcpy(e, &k, sizeof(k));
+  e->size = size;
+  e->shard = s;
+  memcpy(e->data, data, size);
+
+  pthread_mutex_lock(&s->mtx);
+  if (iwhmap_get(s->map, &k)) { // Filled by concurrent reader
+    free(e);
+  } else {
+    s->size += sizeof(*e) + size;
+    if (iwhmap_put(s->map, e, e)) {
+      s->size -= sizeof(*e) + size;
+      free(e);
+    }
+  }
+  pthread_mutex_unlock(&s->mtx);
+}
+
+static void _jb_dcache_remove(struct jbcoll *jbc, int64_t id) {
+  struct jbdcache *dc = jbc->db->dcache;
+  if (!dc) {
+    return;
+  }
+  struct jbdcentry k = { .id = id, .dbid = jbc->dbid };
+  struct jbdcshard *s = _jb_dcache_shard(dc, &k);
+  pthread_mutex_lock(&s->mtx);
+  iwhmap_remove(s->map, &k);
+  pthread_mutex_unlock(&s->mtx);
+}
+
+static void _jb_dcache_clear(struct ejdb *db) {
+  struct jbdcache *dc = db->dcache;
+  if (!dc) {
+    return;
+  }
+  for (int i = 0; i < JB_DCACHE_SHARDS; ++i) {
+    struct jbdcshard *s = &dc->shards[i];
+    pthread_mutex_lock(&s->mtx);
+    iwhmap_clear(s->map);
+    pthread_mutex_unlock(&s->mtx);
+  }
+}
+
+static size_t _jb_dcache_size(struct ejdb *db) {
+  size_t ret = 0;
+  struct jbdcache *dc = db->dcache;
+  if (!dc) {
+    return 0;
+  }
+  for (int i = 0; i < JB_DCACHE_SHARDS; ++i) {
+    struct jbdcshard *s = &dc->shards[i];
+    pthread_mutex_lock(&s->mtx);
+    ret += s->size;
+    pthread_mutex_unlock(&s->mtx);
+  }
+  return ret;
+}
+
 static iwrc _jb_coll_load_index_lr(struct jbcoll *jbc, struct iwkv_val *mval) {
   iwrc rc;
   binn *bn;
@@ -343,6 +574,17 @@ static iwrc _jb_db_release(struct ejdb **dbp) {
     IWRC(iwkv_close(&db->iwkv), rc);
   }
   pthread_rwlock_destroy(&db->rwl);
+  if (db->slowlog.entries) {
+    for (uint32_t i = 0; i < db->slowlog.cap; ++i) {
+      struct jbslowq *e = &db->slowlog.entries[i];
+      free(e->coll);
+      free(e->query);
+      free(e->plan);
+    }
+    free(db->slowlog.entries);
+  }
+  pthread_mutex_destroy(&db->slowlog.mtx);
+  _jb_dcache_destroy(db);
 
   struct ejdb_http *http = &db->opts.http;
   if (http->bind) {
@@ -370,7 +612,8 @@ static iwrc _jb_coll_acquire_keeplock2(
 
   jbc = iwhmap_get(db->mcolls, coll);
   if (jbc) {
-    wl ? pthread_rwlock_wrlock(&jbc->rwl) : pthread_rwlock_rdlock(&jbc->rwl);
+    wl ? jb_rwlock_wrlock(&jbc->rwl, &db->metrics.coll_lock_wait)
+    : jb_rwlock_rdlock(&jbc->rwl, &db->metrics.coll_lock_wait);
     *jbcp = jbc;
   } else {
     pthread_rwlock_unlock(&db->rwl); // relock
@@ -380,7 +623,7 @@ static iwrc _jb_coll_acquire_keeplock2(
     API_WLOCK(db, rci);
     jbc = iwhmap_get(db->mcolls, coll);
     if (jbc) {
-      pthread_rwlock_rdlock(&jbc->rwl);
+      jb_rwlock_rdlock(&jbc->rwl, &db->metrics.coll_lock_wait);
       *jbcp = jbc;
     } else {
       struct jbl *meta = 0;
@@ -435,7 +678,8 @@ create_finish:
           _jb_coll_release(jbc);
         }
       } else {
-        rci = wl ? pthread_rwlock_wrlock(&jbc->rwl) : pthread_rwlock_rdlock(&jbc->rwl); // -V522
+        rci = wl ? jb_rwlock_wrlock(&jbc->rwl, &db->metrics.coll_lock_wait)   // -V522
+              : jb_rwlock_rdlock(&jbc->rwl, &db->metrics.coll_lock_wait);
         if (rci) {
           rc = iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci);
           goto finish;
@@ -471,6 +715,11 @@ static iwrc _jb_idx_record_add(struct jbidx *idx, int64_t id, struct jbl *jbl, s
   int64_t delta = 0; // delta of added/removed index records
   bool compound = idx->idbf & IWDB_COMPOUND_KEYS;
 
+  if (idx->mode & EJDB_IDX_FTS) { // Full-text index keeps number of indexed documents
+    rc = jbi_fts_record_add(idx, id, jbl, jblprev, &delta);
+    goto finish;
+  }
+
   jbvprev_found = jblprev ? _jbl_at(jblprev, idx->ptr, &jbvprev) : false;
   jbv_found = jbl ? _jbl_at(jbl, idx->ptr, &jbv) : false;
 
@@ -642,6 +891,112 @@ static iwrc _jb_idx_fill(struct jbidx *idx) {
   return rc;
 }
 
+// Saves index meta into metadb
+static iwrc _jb_idx_meta_put(struct jbidx *idx, const char *path) {
+  iwrc rc = 0;
+  struct iwkv_val key, val;
+  char keybuf[sizeof(KEY_PREFIX_IDXMETA) + 1 + 2UL * IWNUMBUF_SIZE]; // Full key format: i.<coldbid>.<idxdbid>
+  binn *imeta = binn_object();
+  if (!imeta) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  if (  !binn_object_set_str(imeta, "ptr", path)
+     || !binn_object_set_uint32(imeta, "mode", idx->mode)
+     || !binn_object_set_uint32(imeta, "idbf", idx->idbf)
+     || !binn_object_set_uint32(imeta, "dbid", idx->dbid)) {
+    rc = JBL_ERROR_CREATION;
+    goto finish;
+  }
+  key.data = keybuf;
+  key.size = snprintf(keybuf, sizeof(keybuf), KEY_PREFIX_IDXMETA "%u" "." "%u", idx->jbc->dbid, idx->dbid);
+  if (key.size >= sizeof(keybuf)) {
+    rc = IW_ERROR_OVERFLOW;
+    goto finish;
+  }
+  val.data = binn_ptr(imeta);
+  val.size = binn_size(imeta);
+  rc = iwkv_put(idx->jbc->db->metadb, &key, &val, 0);
+
+finish:
+  binn_free(imeta);
+  return rc;
+}
+
+static iwrc _jb_idx_meta_del(struct ejdb *db, uint32_t coll_dbid, uint32_t idx_dbid) {
+  struct iwkv_val key;
+  char keybuf[sizeof(KEY_PREFIX_IDXMETA) + 1 + 2UL * IWNUMBUF_SIZE]; // Full key format: i.<coldbid>.<idxdbid>
+  key.data = keybuf;
+  key.size = snprintf(keybuf, sizeof(keybuf), KEY_PREFIX_IDXMETA "%u" "." "%u", coll_dbid, idx_dbid);
+  if (key.size >= sizeof(keybuf)) {
+    return IW_ERROR_OVERFLOW;
+  }
+  return iwkv_del(db->metadb, &key, 0);
+}
+
+// Rebuilds `EJDB_IDX_F64` index having text keys into a new database with binary keys.
+// Index is left untouched on failure.
+static iwrc _jb_idx_migrate_keys(struct jbidx *idx) {
+  struct ejdb *db = idx->jbc->db;
+  struct iwdb *oidb = idx->idb;
+  uint32_t odbid = idx->dbid;
+  iwdb_flags_t oidbf = idx->idbf;
+  int64_t ornum = idx->rnum;
+  bool meta_saved = false;
+
+  struct iwxstr *xstr = iwxstr_new();
+  if (!xstr) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  iwrc rc = jbl_ptr_serialize(idx->ptr, xstr);
+  RCGO(rc, finish);
+
+  idx->idb = 0;
+  idx->rnum = 0;
+  idx->idbf &= ~IWDB_REALNUM_KEYS;
+
+  RCC(rc, finish, iwkv_new_db(db->iwkv, idx->idbf, &idx->dbid, &idx->idb));
+  RCC(rc, finish, _jb_idx_fill(idx));
+  RCC(rc, finish, _jb_idx_meta_put(idx, iwxstr_ptr(xstr)));
+  meta_saved = true;
+  RCC(rc, finish, _jb_idx_meta_del(db, idx->jbc->dbid, odbid));
+
+  _jb_meta_nrecs_removedb(db, odbid);
+  iwkv_db_destroy(&oidb);
+
+finish:
+  if (rc) {
+    if (meta_saved) {
+      _jb_idx_meta_del(db, idx->jbc->dbid, idx->dbid);
+    }
+    if (idx->idb) {
+      _jb_meta_nrecs_removedb(db, idx->dbid);
+      iwkv_db_destroy(&idx->idb);
+    }
+    idx->idb = oidb;
+    idx->dbid = odbid;
+    idx->idbf = oidbf;
+    idx->rnum = ornum;
+  }
+  iwxstr_destroy(xstr);
+  return rc;
+}
+
+static void _jb_db_migrate_indexes(struct ejdb *db) {
+  struct iwhmap_iter iter;
+  iwhmap_iter_init(db->mcolls, &iter);
+  while (iwhmap_iter_next(&iter)) {
+    struct jbcoll *jbc = (void*) iter.val;
+    for (struct jbidx *idx = jbc->idx; idx; idx = idx->next) {
+      if ((idx->mode & EJDB_IDX_F64) && JBI_IDX_F64_TEXT_KEYS(idx)) {
+        iwrc rc = _jb_idx_migrate_keys(idx);
+        if (rc) { // Legacy index is still usable
+          iwlog_ecode_error3(rc);
+        }
+      }
+    }
+  }
+}
+
 // Used to avoid deadlocks within a `iwkv_put` context
 static iwrc _jb_put_handler_after(iwrc rc, struct _jb_put_handler_ctx *ctx) {
   struct iwkv_val *oldval = &ctx->oldval;
@@ -654,6 +1009,10 @@ static iwrc _jb_put_handler_after(iwrc rc, struct _jb_put_handler_ctx *ctx) {
   struct jbl *prev;
   struct jbl jblprev;
   struct jbcoll *jbc = ctx->jbc;
+  _jb_dcache_remove(jbc, ctx->id);
+#ifdef JB_HTTP
+  jbr_cache_invalidate(jbc->db->jbr, jbc->name, ctx->id);
+#endif
   if (oldval->size) {
     rc = jbl_from_buf_keep_onstack(&jblprev, oldval->data, oldval->size);
     RCRET(rc);
@@ -673,6 +1032,7 @@ static iwrc _jb_put_handler_after(iwrc rc, struct _jb_put_handler_ctx *ctx) {
     _jb_meta_nrecs_update(jbc->db, jbc->dbid, 1);
     jbc->rnum += 1;
   }
+  JB_METRIC_ADD(jbc->metrics.puts, 1);
 
 finish:
   if (oldval->size) {
@@ -697,6 +1057,21 @@ static iwrc _jb_put_handler(const struct iwkv_val *key, const struct iwkv_val *v
   return 0;
 }
 
+// Keyset resume tokens are supported only for plain cursor scans in natural order of collection or index
+static bool _jb_exec_is_resumable(struct jbexec *ctx) {
+  if (  ctx->sorting || ctx->grouping
+     || (ctx->scanner == jbi_pk_scanner) || (ctx->scanner == jbi_fts_scanner)) {
+    return false;
+  }
+  if (ctx->midx.expr1) {
+    jqp_op_t op = ctx->midx.expr1->op->value;
+    if ((op == JQP_OP_IN) || ((op == JQP_OP_EQ) && (ctx->scanner == jbi_uniq_scanner))) {
+      return false;
+    }
+  }
+  return true;
+}
+
 static iwrc _jb_exec_scan_init(struct jbexec *ctx) {
   ctx->istep = 1;
   ctx->jblbufsz = ctx->jbc->db->opts.document_buffer_sz;
@@ -706,6 +1081,7 @@ static iwrc _jb_exec_scan_init(struct jbexec *ctx) {
     return iwrc_set_errno(IW_ERROR_ALLOC, errno);
   }
   struct jqp_aux *aux = ctx->ux->q->aux;
+  ctx->grouping = (aux->qmode & JQP_QRY_GROUP) != 0;
   if (aux->expr->flags & JQP_EXPR_NODE_FLAG_PK) { // Select by primary key
     ctx->scanner = jbi_pk_scanner;
     if (ctx->ux->log) {
@@ -716,7 +1092,11 @@ static iwrc _jb_exec_scan_init(struct jbexec *ctx) {
   iwrc rc = jbi_selection(ctx);
   RCRET(rc);
   if (ctx->midx.idx) {
-    if (ctx->midx.idx->idbf & IWDB_COMPOUND_KEYS) {
+    if (ctx->gsc.index_only) {
+      ctx->scanner = jbi_distinct_scanner;
+    } else if (ctx->midx.idx->mode & EJDB_IDX_FTS) {
+      ctx->scanner = jbi_fts_scanner;
+    } else if (ctx->midx.idx->idbf & IWDB_COMPOUND_KEYS) {
       ctx->scanner = jbi_dup_scanner;
     } else {
       ctx->scanner = jbi_uniq_scanner;
@@ -727,6 +1107,10 @@ static iwrc _jb_exec_scan_init(struct jbexec *ctx) {
       iwxstr_cat2(ctx->ux->log, "[INDEX] NO");
     }
   }
+  ctx->resumable = _jb_exec_is_resumable(ctx);
+  if (ctx->ux->resume && iwxstr_size(ctx->ux->resume) && !ctx->resumable) {
+    return EJDB_ERROR_INVALID_RESUME_TOKEN;
+  }
   return 0;
 }
 
@@ -819,12 +1203,91 @@ finish:
   return rc;
 }
 
-//----------------------- Public API
+// Records copy of `sq` into slow queries log
+static void _jb_slowlog_add(struct ejdb *db, const struct jbslowq *sq) {
+  struct jbslowlog *slog = &db->slowlog;
+  struct jbslowq e = *sq;
+  e.coll = strdup(sq->coll);
+  e.query = strdup(sq->query ? sq->query : "");
+  e.plan = strdup(sq->plan ? sq->plan : "");
+  iwp_current_time_ms(&e.ts, false);
+  if (!e.coll || !e.query || !e.plan) {
+    free(e.coll);
+    free(e.query);
+    free(e.plan);
+    return;
+  }
+  pthread_mutex_lock(&slog->mtx);
+  struct jbslowq *se = &slog->entries[slog->num++ % slog->cap];
+  free(se->coll);
+  free(se->query);
+  free(se->plan);
+  *se = e;
+  pthread_mutex_unlock(&slog->mtx);
+}
+
+// Formats execution plan of already executed query for the slow queries log.
+// Index selection is repeated only for queries exceeding `slow_query_ms` threshold,
+// so regular queries don't pay for plan formatting.
+static struct iwxstr* _jb_exec_plan(struct ejdb_exec *ux) {
+  int rci;
+  struct iwxstr *log = ux->log, *resume = ux->resume;
+  struct jbexec ctx = {
+    .ux = ux
+  };
+  struct iwxstr *plan = iwxstr_new();
+  if (!plan) {
+    return 0;
+  }
+  iwrc rc = _jb_coll_acquire_keeplock2(ux->db, ux->q->coll, JB_COLL_ACQUIRE_EXISTING, &ctx.jbc);
+  if (rc) {
+    iwxstr_destroy(plan);
+    return 0;
+  }
+  ux->log = plan;
+  ux->resume = 0;
+  rc = _jb_exec_scan_init(&ctx);
+  if (!rc) {
+    iwxstr_cat2(plan, ctx.grouping ? " [COLLECTOR] GROUP\n"
+                : ctx.sorting ? " [COLLECTOR] SORTER\n" : " [COLLECTOR] PLAIN\n");
+  }
+  ux->log = log;
+  ux->resume = resume;
+  _jb_exec_scan_release(&ctx);
+  API_COLL_UNLOCK(ctx.jbc, rci, rc);
+  jql_reset(ux->q, true, false);
+  if (rc) {
+    iwlog_ecode_error3(rc);
+    iwxstr_destroy(plan);
+    return 0;
+  }
+  return plan;
+}
 
-iwrc ejdb_exec(struct ejdb_exec *ux) {
-  if (!ux || !ux->db || !ux->q) {
-    return IW_ERROR_INVALID_ARGS;
+static jb_scanner_t _jb_scanner_type(struct jbexec *ctx) {
+  if (ctx->scanner == jbi_pk_scanner) {
+    return JB_SCANNER_PK;
+  } else if (ctx->scanner == jbi_uniq_scanner) {
+    return JB_SCANNER_UNIQ;
+  } else if (ctx->scanner == jbi_dup_scanner) {
+    return JB_SCANNER_DUP;
+  } else if (ctx->scanner == jbi_fts_scanner) {
+    return JB_SCANNER_FTS;
+  } else if (ctx->scanner == jbi_distinct_scanner) {
+    return JB_SCANNER_DISTINCT;
+  } else {
+    return JB_SCANNER_FULL;
   }
+}
+
+/**
+ * Executes query with already resolved `ux->limit` and `ux->skip`.
+ *
+ * If `ux->yield_batch` is set and query plan supports keyset resumption
+ * scan is performed by batches of `ux->yield_batch` documents, collection lock
+ * is released between batches and next batch continues from resume token position.
+ */
+static iwrc _jb_exec(struct ejdb_exec *ux) {
   int rci;
   iwrc rc = 0;
   if (!ux->visitor) {
@@ -835,9 +1298,125 @@ iwrc ejdb_exec(struct ejdb_exec *ux) {
     // set terminating NULL to current pos of log
     iwxstr_cat(ux->log, 0, 0);
   }
-  struct jbexec ctx = {
-    .ux = ux
-  };
+  struct jbexec ctx;
+  struct iwxstr *log = ux->log;
+  struct iwxstr *resume = ux->resume;
+  int64_t limit = ux->limit, istep = 1;
+  bool yielding = ux->yield_batch > 0 && !jql_has_apply(ux->q);
+  jb_scanner_t stype = JB_SCANNER_NUM;
+  uint64_t ts = _jb_time_us(), scanned = 0, matched = 0;
+  bool spilled = false, log_muted = false;
+
+  if (yielding && !resume) {
+    ux->resume = iwxstr_new();
+    if (!ux->resume) {
+      ux->resume = resume;
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+  }
+  do {
+    int64_t cnt = ux->cnt;
+    ctx = (struct jbexec) {
+      .ux = ux
+    };
+    rc = _jb_coll_acquire_keeplock2(ux->db, ux->q->coll,
+                                    jql_has_apply(ux->q) ? JB_COLL_ACQUIRE_WRITE : JB_COLL_ACQUIRE_EXISTING,
+                                    &ctx.jbc);
+    if (rc) {
+      if (rc == IW_ERROR_NOT_EXISTS) {
+        rc = 0;
+      }
+      break;
+    }
+
+    RCC(rc, finish, _jb_exec_scan_init(&ctx));
+    if (stype == JB_SCANNER_NUM) {
+      stype = _jb_scanner_type(&ctx);
+      JB_METRIC_ADD(ctx.jbc->metrics.queries, 1);
+    }
+    ctx.istep = istep;
+    if (yielding && ctx.resumable) {
+      ux->limit = MIN(ux->yield_batch, limit);
+    } else {
+      yielding = false;
+      ux->limit = limit;
+    }
+    if (ux->log) {
+      iwxstr_cat2(ux->log, ctx.grouping ? " [COLLECTOR] GROUP\n"
+                  : ctx.sorting ? " [COLLECTOR] SORTER\n" : " [COLLECTOR] PLAIN\n");
+    }
+    if (ctx.grouping) {
+      rc = ctx.scanner(&ctx, jbi_group_consumer);
+    } else if (ctx.sorting) {
+      rc = ctx.scanner(&ctx, jbi_sorter_consumer);
+    } else {
+      rc = ctx.scanner(&ctx, jbi_consumer);
+    }
+    RCGO(rc, finish);
+    if ((ux->cnt == 0) && jql_has_apply_upsert(ux->q)) {
+      // No records found trying to upsert new record
+      rc = _jb_exec_upsert_lw(&ctx);
+    }
+
+finish:
+    scanned += ctx.scanned;
+    matched += ctx.matched;
+    spilled |= ctx.spilled;
+    JB_METRIC_ADD(ux->db->metrics.scanned, ctx.scanned);
+    JB_METRIC_ADD(ux->db->metrics.matched, ctx.matched);
+    _jb_exec_scan_release(&ctx);
+    API_COLL_UNLOCK(ctx.jbc, rci, rc);
+    jql_reset(ux->q, true, false);
+    if (yielding && !rc) {
+      // Continue if batch is exhausted and visitor didn't stop the scan
+      limit -= ux->cnt - cnt;
+      istep = ctx.istep;
+      yielding = limit > 0 && ux->limit < 1 && istep != 0;
+      ux->limit = limit;
+      if (log && ux->log == log) {
+        ux->log = 0; // Log only the first batch plan
+        log_muted = true;
+      }
+    }
+  } while (yielding && !rc);
+
+  if (stype < JB_SCANNER_NUM) {
+    ts = _jb_time_us() - ts;
+    _jb_hist_observe(&ux->db->metrics.exec[stype], ts);
+    if (ux->db->opts.slow_query_ms && ts >= ux->db->opts.slow_query_ms * 1000ULL) {
+      struct iwxstr *plan = _jb_exec_plan(ux);
+      struct jbslowq sq = {
+        .coll     = (char*) ux->q->coll,
+        .query    = (char*) ux->q->aux->buf,
+        .plan     = plan ? iwxstr_ptr(plan) : 0,
+        .duration = ts,
+        .scanned  = scanned,
+        .matched  = matched,
+        .cnt      = ux->cnt,
+        .spilled  = spilled
+      };
+      _jb_slowlog_add(ux->db, &sq);
+      iwxstr_destroy(plan);
+    }
+  }
+  if (ux->resume != resume) {
+    iwxstr_destroy(ux->resume);
+    ux->resume = resume;
+  }
+  if (log_muted) {
+    // Visitor may take ownership of the log (bindings do it), so restore only what we have muted
+    ux->log = log;
+  }
+  return rc;
+}
+
+//----------------------- Public API
+
+iwrc ejdb_exec(struct ejdb_exec *ux) {
+  if (!ux || !ux->db || !ux->q) {
+    return IW_ERROR_INVALID_ARGS;
+  }
+  iwrc rc;
   if (ux->limit < 1) {
     rc = jql_get_limit(ux->q, &ux->limit);
     RCRET(rc);
@@ -849,38 +1428,7 @@ iwrc ejdb_exec(struct ejdb_exec *ux) {
     rc = jql_get_skip(ux->q, &ux->skip);
     RCRET(rc);
   }
-  rc = _jb_coll_acquire_keeplock2(ux->db, ux->q->coll,
-                                  jql_has_apply(ux->q) ? JB_COLL_ACQUIRE_WRITE : JB_COLL_ACQUIRE_EXISTING,
-                                  &ctx.jbc);
-  if (rc == IW_ERROR_NOT_EXISTS) {
-    return 0;
-  } else {
-    RCRET(rc);
-  }
-
-  RCC(rc, finish, _jb_exec_scan_init(&ctx));
-  if (ctx.sorting) {
-    if (ux->log) {
-      iwxstr_cat2(ux->log, " [COLLECTOR] SORTER\n");
-    }
-    rc = ctx.scanner(&ctx, jbi_sorter_consumer);
-  } else {
-    if (ux->log) {
-      iwxstr_cat2(ux->log, " [COLLECTOR] PLAIN\n");
-    }
-    rc = ctx.scanner(&ctx, jbi_consumer);
-  }
-  RCGO(rc, finish);
-  if ((ux->cnt == 0) && jql_has_apply_upsert(ux->q)) {
-    // No records found trying to upsert new record
-    rc = _jb_exec_upsert_lw(&ctx);
-  }
-
-finish:
-  _jb_exec_scan_release(&ctx);
-  API_COLL_UNLOCK(ctx.jbc, rci, rc);
-  jql_reset(ux->q, true, false);
-  return rc;
+  return _jb_exec(ux);
 }
 
 #ifdef IW_BLOCKS
@@ -1115,30 +1663,133 @@ void ejdb_list_destroy(struct ejdb_list **listp) {
   }
 }
 
-iwrc ejdb_remove_index(struct ejdb *db, const char *coll, const char *path, ejdb_idx_mode_t mode) {
-  if (!db || !coll || !path) {
+iwrc ejdb_cursor_open(struct ejdb *db, struct jql *q, int64_t batch_size, struct ejdb_cursor **curp) {
+  if (!db || !q || !curp || batch_size < 0) {
     return IW_ERROR_INVALID_ARGS;
   }
-  int rci;
-  struct jbcoll *jbc;
-  struct iwkv_val key;
-  struct jbl_ptr *ptr = 0;
-  char keybuf[sizeof(KEY_PREFIX_IDXMETA) + 1 + 2UL * IWNUMBUF_SIZE]; // Full key format: i.<coldbid>.<idxdbid>
-
-  iwrc rc = _jb_coll_acquire_keeplock2(db, coll, JB_COLL_ACQUIRE_WRITE | JB_COLL_ACQUIRE_EXISTING, &jbc);
-  RCRET(rc);
+  *curp = 0;
+  if (jql_has_apply(q)) {
+    return IW_ERROR_INVALID_ARGS;
+  }
+  iwrc rc = 0;
+  struct ejdb_cursor *cur = calloc(1, sizeof(*cur));
+  if (!cur) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  cur->db = db;
+  cur->q = q;
+  cur->batch = batch_size ? batch_size : JB_CURSOR_BATCH_DEFAULT;
+  RCC(rc, finish, jql_get_skip(q, &cur->skip));
+  RCC(rc, finish, jql_get_limit(q, &cur->limit));
+  if (cur->limit < 1) {
+    cur->limit = INT64_MAX;
+  }
+  cur->resume = iwxstr_new();
+  if (!cur->resume) {
+    rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+
+finish:
+  if (rc) {
+    ejdb_cursor_close(&cur);
+  } else {
+    *curp = cur;
+  }
+  return rc;
+}
+
+iwrc ejdb_cursor_next(struct ejdb_cursor *cur, struct ejdb_doc **first, int64_t *count) {
+  if (!cur || !first) {
+    return IW_ERROR_INVALID_ARGS;
+  }
+  iwrc rc = 0;
+  *first = 0;
+  if (count) {
+    *count = 0;
+  }
+  if (cur->pool) {
+    iwpool_destroy(cur->pool);
+    cur->pool = 0;
+  }
+  if (cur->eof) {
+    return 0;
+  }
+  cur->pool = iwpool_create(1024);
+  if (!cur->pool) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  // Continue from the last returned document if plan supports keyset resumption,
+  // otherwise re-execute query skipping documents returned so far.
+  bool resumed = iwxstr_size(cur->resume) > 0;
+  int64_t limit = MIN(cur->batch, cur->limit); // `ux.limit` is decremented by execution
+  struct _list_visitor_ctx lvc = { 0 };
+  struct ejdb_exec ux = {
+    .db = cur->db,
+    .q = cur->q,
+    .visitor = _jb_exec_list_visitor,
+    .pool = cur->pool,
+    .limit = limit,
+    .skip = resumed ? 0 : cur->skip,
+    .resume = cur->resume,
+    .opaque = &lvc
+  };
+  rc = _jb_exec(&ux);
+  RCGO(rc, finish);
+
+  // Resume token stays empty for plans not supporting keyset resumption
+  if (iwxstr_size(cur->resume)) {
+    cur->skip = 0;
+  } else {
+    cur->skip += ux.cnt;
+  }
+  cur->limit -= ux.cnt;
+  if (ux.cnt < limit || cur->limit < 1) {
+    cur->eof = true;
+  }
+  *first = lvc.head;
+  if (count) {
+    *count = ux.cnt;
+  }
+
+finish:
+  if (rc) {
+    cur->eof = true;
+  }
+  return rc;
+}
+
+void ejdb_cursor_close(struct ejdb_cursor **curp) {
+  if (curp) {
+    struct ejdb_cursor *cur = *curp;
+    if (cur) {
+      if (cur->pool) {
+        iwpool_destroy(cur->pool);
+      }
+      if (cur->resume) {
+        iwxstr_destroy(cur->resume);
+      }
+      free(cur);
+    }
+    *curp = 0;
+  }
+}
+
+iwrc ejdb_remove_index(struct ejdb *db, const char *coll, const char *path, ejdb_idx_mode_t mode) {
+  if (!db || !coll || !path) {
+    return IW_ERROR_INVALID_ARGS;
+  }
+  int rci;
+  struct jbcoll *jbc;
+  struct jbl_ptr *ptr = 0;
+
+  iwrc rc = _jb_coll_acquire_keeplock2(db, coll, JB_COLL_ACQUIRE_WRITE | JB_COLL_ACQUIRE_EXISTING, &jbc);
+  RCRET(rc);
 
   RCC(rc, finish, jbl_ptr_alloc(path, &ptr));
 
   for (struct jbidx *idx = jbc->idx, *prev = 0; idx; idx = idx->next) {
     if (((idx->mode & ~EJDB_IDX_UNIQUE) == (mode & ~EJDB_IDX_UNIQUE)) && !jbl_ptr_cmp(idx->ptr, ptr)) {
-      key.data = keybuf;
-      key.size = snprintf(keybuf, sizeof(keybuf), KEY_PREFIX_IDXMETA "%u" "." "%u", jbc->dbid, idx->dbid);
-      if (key.size >= sizeof(keybuf)) {
-        rc = IW_ERROR_OVERFLOW;
-        goto finish;
-      }
-      RCC(rc, finish, iwkv_del(db->metadb, &key, 0));
+      RCC(rc, finish, _jb_idx_meta_del(db, jbc->dbid, idx->dbid));
       _jb_meta_nrecs_removedb(db, idx->dbid);
       if (prev) {
         prev->next = idx->next;
@@ -1166,18 +1817,19 @@ iwrc ejdb_ensure_index(struct ejdb *db, const char *coll, const char *path, ejdb
   }
   int rci;
   struct jbcoll *jbc;
-  struct iwkv_val key, val;
-  char keybuf[sizeof(KEY_PREFIX_IDXMETA) + 1 + 2UL * IWNUMBUF_SIZE]; // Full key format: i.<coldbid>.<idxdbid>
-
   struct jbidx *idx = 0;
   struct jbl_ptr *ptr = 0;
-  binn *imeta = 0;
 
-  switch (mode & (EJDB_IDX_STR | EJDB_IDX_I64 | EJDB_IDX_F64)) {
+  switch (mode & (EJDB_IDX_STR | EJDB_IDX_I64 | EJDB_IDX_F64 | EJDB_IDX_FTS)) {
     case EJDB_IDX_STR:
     case EJDB_IDX_I64:
     case EJDB_IDX_F64:
       break;
+    case EJDB_IDX_FTS:
+      if (mode & EJDB_IDX_UNIQUE) {
+        return EJDB_ERROR_INVALID_INDEX_MODE;
+      }
+      break;
     default:
       return EJDB_ERROR_INVALID_INDEX_MODE;
   }
@@ -1209,8 +1861,6 @@ iwrc ejdb_ensure_index(struct ejdb *db, const char *coll, const char *path, ejdb
   idx->idbf = 0;
   if (mode & EJDB_IDX_I64) {
     idx->idbf |= IWDB_VNUM64_KEYS;
-  } else if (mode & EJDB_IDX_F64) {
-    idx->idbf |= IWDB_REALNUM_KEYS;
   }
   if (!(mode & EJDB_IDX_UNIQUE)) {
     idx->idbf |= IWDB_COMPOUND_KEYS;
@@ -1218,32 +1868,7 @@ iwrc ejdb_ensure_index(struct ejdb *db, const char *coll, const char *path, ejdb
 
   RCC(rc, finish, iwkv_new_db(db->iwkv, idx->idbf, &idx->dbid, &idx->idb));
   RCC(rc, finish, _jb_idx_fill(idx));
-
-  // save index meta into metadb
-  imeta = binn_object();
-  if (!imeta) {
-    rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
-    goto finish;
-  }
-
-  if (  !binn_object_set_str(imeta, "ptr", path)
-     || !binn_object_set_uint32(imeta, "mode", idx->mode)
-     || !binn_object_set_uint32(imeta, "idbf", idx->idbf)
-     || !binn_object_set_uint32(imeta, "dbid", idx->dbid)) {
-    rc = JBL_ERROR_CREATION;
-    goto finish;
-  }
-
-  key.data = keybuf;
-  // Full key format: i.<coldbid>.<idxdbid>
-  key.size = snprintf(keybuf, sizeof(keybuf), KEY_PREFIX_IDXMETA "%u" "." "%u", jbc->dbid, idx->dbid);
-  if (key.size >= sizeof(keybuf)) {
-    rc = IW_ERROR_OVERFLOW;
-    goto finish;
-  }
-  val.data = binn_ptr(imeta);
-  val.size = binn_size(imeta);
-  RCC(rc, finish, iwkv_put(db->metadb, &key, &val, 0));
+  RCC(rc, finish, _jb_idx_meta_put(idx, path));
 
   idx->next = jbc->idx;
   jbc->idx = idx;
@@ -1259,7 +1884,6 @@ finish:
     }
   }
   free(ptr);
-  binn_free(imeta);
   API_COLL_UNLOCK(jbc, rci, rc);
   return rc;
 }
@@ -1361,7 +1985,9 @@ static iwrc _jb_wal_lock_interceptor(bool before, void *op) {
   assert(db);
   if (before) {
     API_WLOCK2(db, rci);
+    db->metrics.wal_checkpoint_ts = _jb_time_us();
   } else {
+    _jb_hist_observe(&db->metrics.wal_checkpoint, _jb_time_us() - db->metrics.wal_checkpoint_ts);
     API_UNLOCK(db, rci, rc);
   }
   return rc;
@@ -1468,6 +2094,32 @@ iwrc ejdb_put_new_jbn(struct ejdb *db, const char *coll, struct jbl_node *jbn, i
   return rc;
 }
 
+iwrc ejdb_put_new_batch(struct ejdb *db, const char *coll, struct jbl **jbls, size_t num, int64_t *oids) {
+  if (!jbls || !oids) {
+    return IW_ERROR_INVALID_ARGS;
+  }
+  int rci;
+  struct jbcoll *jbc;
+  memset(oids, 0, num * sizeof(oids[0]));
+  if (!num) {
+    return 0;
+  }
+  iwrc rc = _jb_coll_acquire_keeplock(db, coll, true, &jbc);
+  RCRET(rc);
+
+  for (size_t i = 0; i < num; ++i) {
+    if (!jbls[i]) {
+      rc = IW_ERROR_INVALID_ARGS;
+      break;
+    }
+    rc = _jb_put_new_lw(jbc, jbls[i], &oids[i]);
+    RCBREAK(rc);
+  }
+
+  API_COLL_UNLOCK(jbc, rci, rc);
+  return rc;
+}
+
 iwrc jb_get(struct ejdb *db, const char *coll, int64_t id, jb_coll_acquire_t acm, struct jbl **jblp) {
   if (!id || !jblp) {
     return IW_ERROR_INVALID_ARGS;
@@ -1475,18 +2127,31 @@ iwrc jb_get(struct ejdb *db, const char *coll, int64_t id, jb_coll_acquire_t acm
   *jblp = 0;
 
   int rci;
+  iwrc rc;
   struct jbcoll *jbc;
   struct jbl *jbl = 0;
   struct iwkv_val val = { 0 };
   struct iwkv_val key = { .data = &id, .size = sizeof(id) };
 
-  iwrc rc = _jb_coll_acquire_keeplock2(db, coll, acm, &jbc);
+  if (db->dcache && coll) { // Cache hits skip collection lock and storage access
+    rc = _jb_dcache_get(db, coll, id, jblp);
+    if (rc || *jblp) {
+      return rc;
+    }
+    JB_METRIC_ADD(db->metrics.dcache_misses, 1);
+  }
+
+  rc = _jb_coll_acquire_keeplock2(db, coll, acm, &jbc);
   RCRET(rc);
 
   RCC(rc, finish, iwkv_get(jbc->cdb, &key, &val));
+  if (db->dcache) {
+    _jb_dcache_put(jbc, id, val.data, val.size);
+  }
   RCC(rc, finish, jbl_from_buf_keep(&jbl, val.data, val.size, false));
 
   *jblp = jbl;
+  JB_METRIC_ADD(jbc->metrics.gets, 1);
 
 finish:
   if (rc) {
@@ -1504,6 +2169,102 @@ iwrc ejdb_get(struct ejdb *db, const char *coll, int64_t id, struct jbl **jblp)
   return jb_get(db, coll, id, JB_COLL_ACQUIRE_EXISTING, jblp);
 }
 
+struct _jb_get_many_ref {
+  int64_t id;
+  size_t  idx;  /**< Position in user identifiers array */
+};
+
+static int _jb_get_many_ref_cmp(const void *v1, const void *v2) {
+  const struct _jb_get_many_ref *r1 = v1;
+  const struct _jb_get_many_ref *r2 = v2;
+  return r1->id > r2->id ? 1 : r1->id < r2->id ? -1 : 0;
+}
+
+iwrc ejdb_get_many(
+  struct ejdb *db, const char *coll, const int64_t *ids, size_t num,
+  struct iwpool *pool, struct jbl **out) {
+  if (!ids || !pool || !out) {
+    return IW_ERROR_INVALID_ARGS;
+  }
+  memset(out, 0, num * sizeof(out[0]));
+  if (!num) {
+    return 0;
+  }
+
+  int rci;
+  iwrc rc;
+  uint64_t found = 0;
+  struct jbcoll *jbc;
+  struct iwkv_cursor *cur = 0;
+  size_t bufsz = db->opts.document_buffer_sz;
+  uint8_t *buf = 0;
+  struct _jb_get_many_ref *refs = malloc(num * sizeof(refs[0]));
+  if (!refs) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  for (size_t i = 0; i < num; ++i) {
+    refs[i].id = ids[i];
+    refs[i].idx = i;
+  }
+  // Sorted keys are fetched by single cursor keeping locality of storage pages
+  qsort(refs, num, sizeof(refs[0]), _jb_get_many_ref_cmp);
+
+  rc = _jb_coll_acquire_keeplock2(db, coll, JB_COLL_ACQUIRE_EXISTING, &jbc);
+  if (rc) {
+    free(refs);
+    return rc;
+  }
+  RCB(finish, buf = malloc(bufsz));
+  RCC(rc, finish, iwkv_cursor_open(jbc->cdb, &cur, IWKV_CURSOR_BEFORE_FIRST, 0));
+
+  for (size_t i = 0; i < num; ++i) {
+    size_t vsz = 0;
+    int64_t id = refs[i].id;
+    if (i > 0 && id == refs[i - 1].id) { // Duplicated identifier
+      out[refs[i].idx] = out[refs[i - 1].idx];
+      continue;
+    }
+    struct iwkv_val key = { .data = &id, .size = sizeof(id) };
+    rc = iwkv_cursor_to_key(cur, IWKV_CURSOR_EQ, &key);
+    if (rc == IWKV_ERROR_NOTFOUND) {
+      rc = 0;
+      continue;
+    }
+    RCGO(rc, finish);
+    RCC(rc, finish, iwkv_cursor_copy_val(cur, buf, bufsz, &vsz));
+    if (vsz > bufsz) {
+      size_t nsize = MAX(vsz, bufsz * 2);
+      void *nbuf = realloc(buf, nsize);
+      if (!nbuf) {
+        rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+        goto finish;
+      }
+      buf = nbuf;
+      bufsz = nsize;
+      RCC(rc, finish, iwkv_cursor_copy_val(cur, buf, bufsz, &vsz));
+    }
+    struct jbl *jbl = iwpool_alloc(sizeof(*jbl) + vsz, pool);
+    RCB(finish, jbl);
+    memcpy((uint8_t*) jbl + sizeof(*jbl), buf, vsz);
+    RCC(rc, finish, jbl_from_buf_keep_onstack(jbl, (uint8_t*) jbl + sizeof(*jbl), vsz));
+    out[refs[i].idx] = jbl;
+    ++found;
+  }
+  JB_METRIC_ADD(jbc->metrics.gets, found);
+
+finish:
+  if (cur) {
+    IWRC(iwkv_cursor_close(&cur), rc);
+  }
+  API_COLL_UNLOCK(jbc, rci, rc);
+  if (rc) {
+    memset(out, 0, num * sizeof(out[0]));
+  }
+  free(buf);
+  free(refs);
+  return rc;
+}
+
 iwrc ejdb_del(struct ejdb *db, const char *coll, int64_t id) {
   int rci;
   struct jbcoll *jbc;
@@ -1522,8 +2283,13 @@ iwrc ejdb_del(struct ejdb *db, const char *coll, int64_t id) {
   }
 
   RCC(rc, finish, iwkv_del(jbc->cdb, &key, 0));
+  _jb_dcache_remove(jbc, id);
   _jb_meta_nrecs_update(jbc->db, jbc->dbid, -1);
   jbc->rnum -= 1;
+#ifdef JB_HTTP
+  jbr_cache_invalidate(db->jbr, jbc->name, id);
+#endif
+  JB_METRIC_ADD(jbc->metrics.dels, 1);
 
 finish:
   if (val.data) {
@@ -1541,8 +2307,13 @@ iwrc jb_del(struct jbcoll *jbc, struct jbl *jbl, int64_t id) {
   }
   rc = iwkv_del(jbc->cdb, &key, 0);
   RCRET(rc);
+  _jb_dcache_remove(jbc, id);
   _jb_meta_nrecs_update(jbc->db, jbc->dbid, -1);
   jbc->rnum -= 1;
+#ifdef JB_HTTP
+  jbr_cache_invalidate(jbc->db->jbr, jbc->name, id);
+#endif
+  JB_METRIC_ADD(jbc->metrics.dels, 1);
   return rc;
 }
 
@@ -1553,8 +2324,13 @@ iwrc jb_cursor_del(struct jbcoll *jbc, struct iwkv_cursor *cur, int64_t id, stru
   }
   rc = iwkv_cursor_del(cur, 0);
   RCRET(rc);
+  _jb_dcache_remove(jbc, id);
   _jb_meta_nrecs_update(jbc->db, jbc->dbid, -1);
   jbc->rnum -= 1;
+#ifdef JB_HTTP
+  jbr_cache_invalidate(jbc->db->jbr, jbc->name, id);
+#endif
+  JB_METRIC_ADD(jbc->metrics.dels, 1);
   return rc;
 }
 
@@ -1602,6 +2378,10 @@ iwrc ejdb_remove_collection(struct ejdb *db, const char *coll) {
     jbc->idx = 0;
     IWRC(iwkv_db_destroy(&jbc->cdb), rc);
     iwhmap_remove(db->mcolls, coll);
+    _jb_dcache_clear(db);
+#ifdef JB_HTTP
+    jbr_cache_invalidate(db->jbr, coll, 0);
+#endif
   }
 
 finish:
@@ -1615,6 +2395,14 @@ iwrc jb_collection_join_resolver(int64_t id, const char *coll, struct jbl **out,
   return jb_get(db, coll, id, JB_COLL_ACQUIRE_EXISTING, out);
 }
 
+iwrc jb_collection_join_resolver_many(
+  const int64_t *ids, size_t num, const char *coll,
+  struct iwpool *pool, struct jbl **out, struct jbexec *ctx) {
+  assert(ids && out && ctx && coll);
+  struct ejdb *db = ctx->jbc->db;
+  return ejdb_get_many(db, coll, ids, num, pool, out);
+}
+
 int jb_proj_node_cache_cmp(const void *v1, const void *v2) {
   const struct jbdocref *r1 = v1;
   const struct jbdocref *r2 = v2;
@@ -1625,13 +2413,24 @@ int jb_proj_node_cache_cmp(const void *v1, const void *v2) {
   return ret;
 }
 
+int jb_proj_node_cache_coll_cmp(const void *v1, const void *v2) {
+  const struct jbdocref *r1 = v1;
+  const struct jbdocref *r2 = v2;
+  int ret = strcmp(r1->coll, r2->coll);
+  if (!ret) {
+    return r1->id > r2->id ? 1 : r1->id < r2->id ? -1 : 0;
+  }
+  return ret;
+}
+
 void jb_proj_node_kvfree(void *key, void *val) {
   free(key);
 }
 
 uint32_t jb_proj_node_hash(const void *key) {
   const struct jbdocref *ref = key;
-  return wyhash32(key, sizeof(ref), 0xd31c3939);
+  uint32_t hash = wyhash32(&ref->id, sizeof(ref->id), 0xd31c3939);
+  return wyhash32(ref->coll, strlen(ref->coll), hash);
 }
 
 iwrc ejdb_rename_collection(struct ejdb *db, const char *coll, const char *new_coll) {
@@ -1687,6 +2486,9 @@ iwrc ejdb_rename_collection(struct ejdb *db, const char *coll, const char *new_c
   jbc->name = new_name;
   jbl_destroy(&jbc->meta);
   jbc->meta = nmeta;
+#ifdef JB_HTTP
+  jbr_cache_invalidate(db->jbr, coll, 0);
+#endif
 
 finish:
   if (jbv) {
@@ -1754,6 +2556,265 @@ finish:
   return rc;
 }
 
+static bool _jb_metrics_hist_add(binn *obj, const char *key, struct jbhist *h) {
+  char nbuf[IWNUMBUF_SIZE];
+  uint64_t cnt = 0;
+  binn *ho = binn_object();
+  binn *bo = binn_object();
+  bool ret = ho && bo;
+  for (int i = 0; ret && i < JB_HIST_BUCKETS; ++i) {
+    cnt += JB_METRIC_GET(h->buckets[i]);
+    if (i < JB_HIST_BUCKETS - 1) {
+      snprintf(nbuf, sizeof(nbuf), "%" PRIu64, _jb_hist_bounds[i]);
+      ret = binn_object_set_uint64(bo, nbuf, cnt);
+    } else {
+      ret = binn_object_set_uint64(bo, "+Inf", cnt);
+    }
+  }
+  ret = ret
+        && binn_object_set_uint64(ho, "count", JB_METRIC_GET(h->count))
+        && binn_object_set_uint64(ho, "sum", JB_METRIC_GET(h->sum))
+        && binn_object_set_object(ho, "buckets", bo)
+        && binn_object_set_object(obj, key, ho);
+  binn_free(bo);
+  binn_free(ho);
+  return ret;
+}
+
+iwrc ejdb_get_metrics(struct ejdb *db, struct jbl **jblp) {
+  int rci;
+  *jblp = 0;
+  struct jbl *jbl;
+  iwrc rc = jbl_create_empty_object(&jbl);
+  RCRET(rc);
+  binn *clist = 0, *eobj = 0, *cobj = 0;
+  struct jbmetrics *m = &db->metrics;
+  API_RLOCK(db, rci);
+
+  RCB(finish, clist = binn_list());
+  struct iwhmap_iter iter;
+  iwhmap_iter_init(db->mcolls, &iter);
+  while (iwhmap_iter_next(&iter)) {
+    struct jbcoll *jbc = (void*) iter.val;
+    RCB(finish, cobj = binn_object());
+    if (  !binn_object_set_str(cobj, "name", jbc->name)
+       || !binn_object_set_uint64(cobj, "puts", JB_METRIC_GET(jbc->metrics.puts))
+       || !binn_object_set_uint64(cobj, "gets", JB_METRIC_GET(jbc->metrics.gets))
+       || !binn_object_set_uint64(cobj, "dels", JB_METRIC_GET(jbc->metrics.dels))
+       || !binn_object_set_uint64(cobj, "queries", JB_METRIC_GET(jbc->metrics.queries))
+       || !binn_list_add_object(clist, cobj)) {
+      rc = JBL_ERROR_CREATION;
+      goto finish;
+    }
+    binn_free(cobj);
+    cobj = 0;
+  }
+
+  RCB(finish, eobj = binn_object());
+  for (int i = 0; i < JB_SCANNER_NUM; ++i) {
+    if (!_jb_metrics_hist_add(eobj, _jb_scanner_names[i], &m->exec[i])) {
+      rc = JBL_ERROR_CREATION;
+      goto finish;
+    }
+  }
+
+  if (  !binn_object_set_list(&jbl->bn, "collections", clist)
+     || !binn_object_set_object(&jbl->bn, "exec", eobj)
+     || !binn_object_set_uint64(&jbl->bn, "scanned", JB_METRIC_GET(m->scanned))
+     || !binn_object_set_uint64(&jbl->bn, "matched", JB_METRIC_GET(m->matched))
+     || !binn_object_set_uint64(&jbl->bn, "sorter_spills", JB_METRIC_GET(m->sorter_spills))
+     || !binn_object_set_uint64(&jbl->bn, "group_spills", JB_METRIC_GET(m->group_spills))
+     || !binn_object_set_uint64(&jbl->bn, "doc_cache_hits", JB_METRIC_GET(m->dcache_hits))
+     || !binn_object_set_uint64(&jbl->bn, "doc_cache_misses", JB_METRIC_GET(m->dcache_misses))
+     || !binn_object_set_uint64(&jbl->bn, "doc_cache_size", _jb_dcache_size(db))
+     || !_jb_metrics_hist_add(&jbl->bn, "db_lock_wait", &m->db_lock_wait)
+     || !_jb_metrics_hist_add(&jbl->bn, "coll_lock_wait", &m->coll_lock_wait)
+     || !_jb_metrics_hist_add(&jbl->bn, "wal_checkpoint", &m->wal_checkpoint)) {
+    rc = JBL_ERROR_CREATION;
+    goto finish;
+  }
+
+finish:
+  API_UNLOCK(db, rci, rc);
+  if (cobj) {
+    binn_free(cobj);
+  }
+  if (eobj) {
+    binn_free(eobj);
+  }
+  if (clist) {
+    binn_free(clist);
+  }
+  if (rc) {
+    jbl_destroy(&jbl);
+  } else {
+    *jblp = jbl;
+  }
+  return rc;
+}
+
+iwrc ejdb_get_slow_queries(struct ejdb *db, struct jbl **jblp) {
+  ENSURE_OPEN(db);
+  *jblp = 0;
+  struct jbl *jbl;
+  struct jbslowlog *slog = &db->slowlog;
+  binn *list = 0, *obj = 0;
+  iwrc rc = jbl_create_empty_object(&jbl);
+  RCRET(rc);
+  RCB(finish, list = binn_list());
+
+  pthread_mutex_lock(&slog->mtx);
+  uint32_t num = MIN(slog->num, slog->cap);
+  for (uint32_t i = slog->num - num; i < slog->num; ++i) {
+    struct jbslowq *e = &slog->entries[i % slog->cap];
+    obj = binn_object();
+    if (  !obj
+       || !binn_object_set_uint64(obj, "ts", e->ts)
+       || !binn_object_set_uint64(obj, "duration", e->duration)
+       || !binn_object_set_str(obj, "collection", e->coll)
+       || !binn_object_set_str(obj, "query", e->query)
+       || !binn_object_set_str(obj, "plan", e->plan)
+       || !binn_object_set_uint64(obj, "scanned", e->scanned)
+       || !binn_object_set_uint64(obj, "matched", e->matched)
+       || !binn_object_set_int64(obj, "count", e->cnt)
+       || !binn_object_set_bool(obj, "spilled", e->spilled)
+       || !binn_list_add_object(list, obj)) {
+      rc = JBL_ERROR_CREATION;
+      break;
+    }
+    binn_free(obj);
+    obj = 0;
+  }
+  if (!rc && !binn_object_set_uint64(&jbl->bn, "total", slog->num)) {
+    rc = JBL_ERROR_CREATION;
+  }
+  pthread_mutex_unlock(&slog->mtx);
+  RCGO(rc, finish);
+
+  if (!binn_object_set_list(&jbl->bn, "queries", list)) {
+    rc = JBL_ERROR_CREATION;
+  }
+
+finish:
+  if (obj) {
+    binn_free(obj);
+  }
+  if (list) {
+    binn_free(list);
+  }
+  if (rc) {
+    jbl_destroy(&jbl);
+  } else {
+    *jblp = jbl;
+  }
+  return rc;
+}
+
+static iwrc _jb_metrics_label_cat(struct iwxstr *xstr, const char *val) {
+  iwrc rc = 0;
+  for (const char *p = val; !rc && *p; ++p) {
+    switch (*p) {
+      case '\\':
+        rc = iwxstr_cat(xstr, "\\\\", 2);
+        break;
+      case '"':
+        rc = iwxstr_cat(xstr, "\\\"", 2);
+        break;
+      case '\n':
+        rc = iwxstr_cat(xstr, "\\n", 2);
+        break;
+      default:
+        rc = iwxstr_cat(xstr, p, 1);
+        break;
+    }
+  }
+  return rc;
+}
+
+// Prints histogram in seconds, `label` is an optional `name="value",` labels prefix
+static iwrc _jb_metrics_hist_print(struct iwxstr *xstr, const char *name, const char *label, struct jbhist *h) {
+  iwrc rc = 0;
+  uint64_t cnt = 0;
+  for (int i = 0; !rc && i < JB_HIST_BUCKETS; ++i) {
+    cnt += JB_METRIC_GET(h->buckets[i]);
+    if (i < JB_HIST_BUCKETS - 1) {
+      rc = iwxstr_printf(xstr, "%s_bucket{%sle=\"%g\"} %" PRIu64 "\n",
+                         name, label, _jb_hist_bounds[i] / 1e6, cnt);
+    } else {
+      rc = iwxstr_printf(xstr, "%s_bucket{%sle=\"+Inf\"} %" PRIu64 "\n", name, label, cnt);
+    }
+  }
+  RCRET(rc);
+  size_t len = strlen(label);
+  if (len) { // Strip trailing comma
+    --len;
+  }
+  rc = iwxstr_printf(xstr, "%s_sum{%.*s} %g\n", name, (int) len, label, JB_METRIC_GET(h->sum) / 1e6);
+  RCRET(rc);
+  return iwxstr_printf(xstr, "%s_count{%.*s} %" PRIu64 "\n", name, (int) len, label, JB_METRIC_GET(h->count));
+}
+
+iwrc jb_metrics_print(struct ejdb *db, struct iwxstr *xstr) {
+  int rci;
+  iwrc rc = 0;
+  struct iwhmap_iter iter;
+  struct jbmetrics *m = &db->metrics;
+  static const char *cnames[] = { "puts", "gets", "dels", "queries" };
+
+  API_RLOCK(db, rci);
+  for (int i = 0; i < (int) (sizeof(cnames) / sizeof(cnames[0])); ++i) {
+    RCC(rc, finish, iwxstr_printf(xstr, "# TYPE ejdb_collection_%s_total counter\n", cnames[i]));
+    iwhmap_iter_init(db->mcolls, &iter);
+    while (iwhmap_iter_next(&iter)) {
+      struct jbcoll *jbc = (void*) iter.val;
+      uint64_t counters[] = {
+        JB_METRIC_GET(jbc->metrics.puts), JB_METRIC_GET(jbc->metrics.gets),
+        JB_METRIC_GET(jbc->metrics.dels), JB_METRIC_GET(jbc->metrics.queries)
+      };
+      RCC(rc, finish, iwxstr_printf(xstr, "ejdb_collection_%s_total{collection=\"", cnames[i]));
+      RCC(rc, finish, _jb_metrics_label_cat(xstr, jbc->name));
+      RCC(rc, finish, iwxstr_printf(xstr, "\"} %" PRIu64 "\n", counters[i]));
+    }
+  }
+
+  RCC(rc, finish, iwxstr_cat2(xstr, "# TYPE ejdb_exec_duration_seconds histogram\n"));
+  for (int i = 0; i < JB_SCANNER_NUM; ++i) {
+    char label[32];
+    snprintf(label, sizeof(label), "scanner=\"%s\",", _jb_scanner_names[i]);
+    RCC(rc, finish, _jb_metrics_hist_print(xstr, "ejdb_exec_duration_seconds", label, &m->exec[i]));
+  }
+  RCC(rc, finish, iwxstr_printf(xstr,
+                                "# TYPE ejdb_documents_scanned_total counter\n"
+                                "ejdb_documents_scanned_total %" PRIu64 "\n"
+                                "# TYPE ejdb_documents_matched_total counter\n"
+                                "ejdb_documents_matched_total %" PRIu64 "\n"
+                                "# TYPE ejdb_sorter_spills_total counter\n"
+                                "ejdb_sorter_spills_total %" PRIu64 "\n"
+                                "# TYPE ejdb_group_spills_total counter\n"
+                                "ejdb_group_spills_total %" PRIu64 "\n"
+                                "# TYPE ejdb_doc_cache_hits_total counter\n"
+                                "ejdb_doc_cache_hits_total %" PRIu64 "\n"
+                                "# TYPE ejdb_doc_cache_misses_total counter\n"
+                                "ejdb_doc_cache_misses_total %" PRIu64 "\n"
+                                "# TYPE ejdb_doc_cache_bytes gauge\n"
+                                "ejdb_doc_cache_bytes %zu\n",
+                                JB_METRIC_GET(m->scanned), JB_METRIC_GET(m->matched),
+                                JB_METRIC_GET(m->sorter_spills), JB_METRIC_GET(m->group_spills),
+                                JB_METRIC_GET(m->dcache_hits), JB_METRIC_GET(m->dcache_misses),
+                                _jb_dcache_size(db)));
+
+  RCC(rc, finish, iwxstr_cat2(xstr, "# TYPE ejdb_lock_wait_seconds histogram\n"));
+  RCC(rc, finish, _jb_metrics_hist_print(xstr, "ejdb_lock_wait_seconds", "lock=\"db\",", &m->db_lock_wait));
+  RCC(rc, finish, _jb_metrics_hist_print(xstr, "ejdb_lock_wait_seconds", "lock=\"collection\",",
+                                         &m->coll_lock_wait));
+  RCC(rc, finish, iwxstr_cat2(xstr, "# TYPE ejdb_wal_checkpoint_duration_seconds histogram\n"));
+  RCC(rc, finish, _jb_metrics_hist_print(xstr, "ejdb_wal_checkpoint_duration_seconds", "", &m->wal_checkpoint));
+
+finish:
+  API_UNLOCK(db, rci, rc);
+  return rc;
+}
+
 iwrc ejdb_online_backup(struct ejdb *db, uint64_t *ts, const char *target_file) {
   ENSURE_OPEN(db);
   return iwkv_online_backup(db->iwkv, ts, target_file);
@@ -1823,6 +2884,14 @@ iwrc ejdb_open(const struct ejdb_opts *_opts, struct ejdb **ejdbp) {
     free(db);
     return rc;
   }
+  pthread_mutex_init(&db->slowlog.mtx, 0);
+  if (db->opts.slow_query_ms) {
+    db->slowlog.cap = db->opts.slow_query_log_sz ? db->opts.slow_query_log_sz : JB_SLOW_QUERY_LOG_SZ_DEFAULT;
+    RCB(finish, db->slowlog.entries = calloc(db->slowlog.cap, sizeof(db->slowlog.entries[0])));
+  }
+  if (db->opts.document_cache_sz) {
+    RCC(rc, finish, _jb_dcache_init(db));
+  }
   RCB(finish, db->mcolls = iwhmap_create_str(_mcolls_map_entry_free));
 
   struct iwkv_opts kvopts;
@@ -1835,6 +2904,9 @@ iwrc ejdb_open(const struct ejdb_opts *_opts, struct ejdb **ejdbp) {
 
   db->oflags = kvopts.oflags;
   RCC(rc, finish, _jb_db_meta_load(db));
+  if (!(db->oflags & IWKV_RDONLY)) {
+    _jb_db_migrate_indexes(db);
+  }
 
   if (db->opts.http.enabled) {
     // Maximum WS/HTTP API body size. Default: 64Mb, Min: 512K
@@ -1922,6 +2994,12 @@ static const char* _ejdb_ecodefn(locale_t locale, uint32_t ecode) {
       return "Target collection exists (EJDB_ERROR_TARGET_COLLECTION_EXISTS)";
     case EJDB_ERROR_PATCH_JSON_NOT_OBJECT:
       return "Patch JSON must be an object (map) (EJDB_ERROR_PATCH_JSON_NOT_OBJECT)";
+    case EJDB_ERROR_INVALID_RESUME_TOKEN:
+      return "Resume token is invalid or doesn't match query execution plan (EJDB_ERROR_INVALID_RESUME_TOKEN)";
+    case EJDB_ERROR_QUERY_TIMEOUT:
+      return "Query execution deadline exceeded (EJDB_ERROR_QUERY_TIMEOUT)";
+    case EJDB_ERROR_QUERY_CANCELLED:
+      return "Query execution cancelled (EJDB_ERROR_QUERY_CANCELLED)";
     default:
       break;
   }
@@ -61,18 +61,18 @@
           return IW_ERROR_INVALID_STATE;        \
         }
 
-#define API_RLOCK(db_, rci_)                       \
-        ENSURE_OPEN(db_);                          \
-        rci_ = pthread_rwlock_rdlock(&(db_)->rwl); \
+#define API_RLOCK(db_, rci_)                                                     \
+        ENSURE_OPEN(db_);                                                        \
+        rci_ = jb_rwlock_rdlock(&(db_)->rwl, &(db_)->metrics.db_lock_wait);      \
         if (rci_) return iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci_)
 
-#define API_WLOCK(db_, rci_)                       \
-        ENSURE_OPEN(db_);                          \
-        rci_ = pthread_rwlock_wrlock(&(db_)->rwl); \
+#define API_WLOCK(db_, rci_)                                                     \
+        ENSURE_OPEN(db_);                                                        \
+        rci_ = jb_rwlock_wrlock(&(db_)->rwl, &(db_)->metrics.db_lock_wait);      \
         if (rci_) return iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci_)
 
-#define API_WLOCK2(db_, rci_)                      \
-        rci_ = pthread_rwlock_wrlock(&(db_)->rwl); \
+#define API_WLOCK2(db_, rci_)                                                    \
+        rci_ = jb_rwlock_wrlock(&(db_)->rwl, &(db_)->metrics.db_lock_wait);      \
         if (rci_) return iwrc_set_errno(IW_ERROR_THREADING_ERRNO, rci_)
 
 #define API_UNLOCK(db_, rci_, rc_)                 \
@@ -89,6 +89,94 @@
 struct jbidx;
 typedef struct jbidx*JBIDX;
 
+/** Relaxed atomic increment of metrics counter */
+#define JB_METRIC_ADD(v_, n_) __atomic_fetch_add(&(v_), (n_), __ATOMIC_RELAXED)
+#define JB_METRIC_GET(v_)     __atomic_load_n(&(v_), __ATOMIC_RELAXED)
+
+/** Number of latency histogram buckets, the last one is `+Inf` */
+#define JB_HIST_BUCKETS 15
+
+/** Latency histogram, values are in microseconds */
+struct jbhist {
+  uint64_t count;
+  uint64_t sum;
+  uint64_t buckets[JB_HIST_BUCKETS]; /**< Non cumulative buckets counters */
+};
+
+/** Scanner types of `ejdb_exec()` latency histograms */
+typedef enum {
+  JB_SCANNER_PK = 0,
+  JB_SCANNER_UNIQ,
+  JB_SCANNER_DUP,
+  JB_SCANNER_FTS,
+  JB_SCANNER_FULL,
+  JB_SCANNER_DISTINCT,
+  JB_SCANNER_NUM,
+} jb_scanner_t;
+
+/** Database wide metrics, updated by relaxed atomic operations */
+struct jbmetrics {
+  struct jbhist exec[JB_SCANNER_NUM]; /**< `ejdb_exec()` latency by scanner type */
+  struct jbhist db_lock_wait;         /**< Contended waits on database lock */
+  struct jbhist coll_lock_wait;       /**< Contended waits on collection locks */
+  struct jbhist wal_checkpoint;       /**< WAL checkpoints durations */
+  uint64_t      wal_checkpoint_ts;    /**< Start time of the current WAL checkpoint */
+  uint64_t      scanned;              /**< Number of documents scanned by queries */
+  uint64_t      matched;              /**< Number of documents matched by queries */
+  uint64_t      sorter_spills;        /**< Number of sort buffer overflows into temp file */
+  uint64_t      group_spills;         /**< Number of grouping buffer overflows into temp file */
+  uint64_t      dcache_hits;          /**< Number of `ejdb_get()` calls served by documents cache */
+  uint64_t      dcache_misses;        /**< Number of documents cache misses */
+};
+
+/** Default max number of entries in slow queries log */
+#define JB_SLOW_QUERY_LOG_SZ_DEFAULT 64
+
+/** Slow queries log entry */
+struct jbslowq {
+  char    *coll;
+  char    *query;     /**< Query text */
+  char    *plan;      /**< Query execution plan */
+  uint64_t ts;        /**< Query completion time in milliseconds since epoch */
+  uint64_t duration;  /**< Query execution time in microseconds */
+  uint64_t scanned;
+  uint64_t matched;
+  int64_t  cnt;
+  bool     spilled;   /**< Sort buffer was spilled into temp file */
+};
+
+/** Slow queries log ring buffer */
+struct jbslowlog {
+  struct jbslowq *entries;
+  uint32_t cap;             /**< Ring buffer capacity */
+  uint32_t num;             /**< Number of entries recorded since database open */
+  pthread_mutex_t mtx;
+};
+
+/** Number of documents cache shards */
+#define JB_DCACHE_SHARDS 16
+
+/** Documents cache shard */
+struct jbdcshard {
+  IWHMAP *map;              /**< LRU map: (collection dbid, document id) => struct jbdcentry */
+  size_t  size;             /**< Total size of cached entries */
+  size_t  max_size;         /**< Max size of cached entries */
+  pthread_mutex_t mtx;
+};
+
+/** Documents cache used by `ejdb_get()`, updated under collection lock */
+struct jbdcache {
+  struct jbdcshard shards[JB_DCACHE_SHARDS];
+};
+
+/** Collection metrics counters */
+struct jbcoll_metrics {
+  uint64_t puts;
+  uint64_t gets;
+  uint64_t dels;
+  uint64_t queries;
+};
+
 /** Database collection */
 typedef struct jbcoll {
   uint32_t      dbid;       /**< IWKV collection database ID */
@@ -100,6 +188,7 @@ typedef struct jbcoll {
   int64_t       rnum;       /**< Number of records stored in collection */
   pthread_rwlock_t rwl;
   int64_t id_seq;
+  struct jbcoll_metrics metrics;
 } *JBCOLL;
 
 /** Database collection index */
@@ -130,6 +219,9 @@ struct ejdb {
   struct iwhmap   *mcolls;
   iwkv_openflags   oflags;
   pthread_rwlock_t rwl;      /**< Main RWL */
+  struct jbmetrics metrics;
+  struct jbslowlog slowlog;
+  struct jbdcache *dcache;   /**< Documents cache, zero if disabled */
   struct ejdb_opts opts;
   volatile bool    open;
 };
@@ -163,6 +255,26 @@ struct jbssc {
   bool      sof_active;
 };
 
+/** Grouping context of aggregate queries (`group`, `distinct`, `sum`, `min`, `max`, `avg`) */
+struct jbgsc {
+  struct iwhmap  *map;        /**< Groups by key, both key and value is a `struct jbgroup` */
+  struct iwpool  *pool;       /**< Groups memory pool */
+  struct jbgroup *last;       /**< Group of the last document, fast path for runs of equal keys */
+  size_t   size;              /**< Approximate memory used by groups */
+  uint8_t *kbuf;              /**< Group key buffer of the current document */
+  size_t   kbuf_asz;          /**< Allocated size of key buffer */
+  uint8_t *ikey;              /**< Index key of the current run of groups (presorted mode) */
+  size_t   ikey_sz;           /**< Index key size */
+  size_t   ikey_asz;          /**< Index key buffer allocated size */
+  int64_t  num;               /**< Number of groups emitted so far */
+  IWFS_EXT sof;               /**< Groups overflow file */
+  off_t    sof_npos;          /**< Next record offset in overflow file */
+  bool     sof_active;
+  bool     presorted;         /**< Documents are scanned in order of group key index */
+  bool     index_only;        /**< Distinct values are read from group key index only */
+  bool     stop;              /**< Visitor stopped groups emission */
+};
+
 struct jbmidx {
   struct jbidx      *idx;             /**< Index matched this filter */
   struct jqp_filter *filter;          /**< Query filter */
@@ -172,6 +284,7 @@ struct jbmidx {
   enum iwkv_cursor_op cursor_init;    /**< Initial index cursor position (optional) */
   enum iwkv_cursor_op cursor_step;    /**< Next index cursor step */
   bool orderby_support;               /**< Index supported first order-by clause */
+  bool covered;                       /**< Whole query filter is evaluated by index expressions */
 };
 
 typedef struct jbexec {
@@ -189,6 +302,14 @@ typedef struct jbexec {
   enum iwkv_cursor_op cursor_step; /**< Next index cursor step */
   struct jbmidx midx;              /**< Index matching context */
   struct jbssc  ssc;               /**< Result set sorting context */
+  struct jbgsc  gsc;               /**< Result set grouping context */
+  bool grouping;                   /**< Aggregate query: matched documents are grouped */
+  struct iwkv_cursor *icur;        /**< Current index cursor used to save resume token (optional) */
+  bool resumable;                  /**< Query execution plan supports keyset resume tokens */
+  uint32_t ticks;                  /**< Number of documents processed since query deadline check */
+  uint64_t scanned;                /**< Number of documents scanned */
+  uint64_t matched;                /**< Number of documents matched */
+  bool     spilled;                /**< Sort buffer was spilled into temp file */
 
   // JQL joned nodes cache
   struct iwhmap *proj_joined_nodes_cache;
@@ -200,11 +321,46 @@ typedef uint8_t jb_coll_acquire_t;
 #define JB_COLL_ACQUIRE_WRITE    ((jb_coll_acquire_t) 0x01U)
 #define JB_COLL_ACQUIRE_EXISTING ((jb_coll_acquire_t) 0x02U)
 
+/** Default number of documents fetched by `ejdb_cursor_next()` */
+#define JB_CURSOR_BATCH_DEFAULT 64
+
+/** Pull-style query cursor, collection lock is acquired per batch */
+struct ejdb_cursor {
+  struct ejdb   *db;
+  struct jql    *q;
+  struct iwpool *pool;    /**< Pool of the current batch documents */
+  struct iwxstr *resume;  /**< Keyset resume token, empty if plan is not resumable */
+  int64_t batch;          /**< Max number of documents per batch */
+  int64_t skip;           /**< Number of documents to skip by next batch */
+  int64_t limit;          /**< Remaining number of documents */
+  bool    eof;
+};
+
 // Index selector empiric constants
 #define JB_IDX_EMPIRIC_MAX_INOP_ARRAY_SIZE  500
 #define JB_IDX_EMPIRIC_MIN_INOP_ARRAY_SIZE  10
 #define JB_IDX_EMPIRIC_MAX_INOP_ARRAY_RATIO 200
 
+/** `EJDB_IDX_F64` index created before binary key format: keys are `iwjson_ftoa()` strings
+    compared by `IWDB_REALNUM_KEYS`. Such indexes are rebuilt by `ejdb_open()`. */
+#define JBI_IDX_F64_TEXT_KEYS(idx_) ((idx_)->idbf & IWDB_REALNUM_KEYS)
+
+/** Keyset resume token header: `| dbid:u32 | id:i64 |` (little endian) followed by index key bytes.
+    `dbid` is either index database or collection database (full scan) identifier. */
+#define JBI_RESUME_TOKEN_HDR_SZ (sizeof(uint32_t) + sizeof(int64_t))
+
+/** Number of processed documents between query deadline and cancellation flag checks */
+#define JBI_EXEC_CHECK_INTERVAL 256
+
+/** Max length in bytes of full-text index term, longer words are truncated */
+#define JBI_FTS_TERM_MAX_LEN 64
+
+/** Full-text tokenizer term visitor */
+typedef iwrc (*jbi_fts_token_visitor)(const char *term, size_t len, uint32_t pos, void *op);
+
+/** Parsed full-text `match` query */
+struct jbi_fts_query;
+
 void jbi_jbl_fill_ikey(struct jbidx *idx, struct jbl *jbv, struct iwkv_val *ikey, char numbuf[static IWNUMBUF_SIZE]);
 void jbi_jqval_fill_ikey(
   struct jbidx *idx, const struct jqval *jqval, struct iwkv_val *ikey,
@@ -213,11 +369,18 @@ void jbi_node_fill_ikey(
   struct jbidx *idx, struct jbl_node *node, struct iwkv_val *ikey,
   char numbuf[static IWNUMBUF_SIZE]);
 
+/** Decodes index key `kbuf` of size `sz` into `jqval`, `kbuf` must have a room for terminating zero */
+iwrc jbi_ikey_to_jqval(struct jbidx *idx, char *kbuf, size_t sz, struct jqval *jqval);
+
 iwrc jbi_consumer(struct jbexec *ctx, struct iwkv_cursor *cur, int64_t id, int64_t *step, bool *matched, iwrc err);
 iwrc jbi_sorter_consumer(
   struct jbexec *ctx, struct iwkv_cursor *cur, int64_t id, int64_t *step, bool *matched,
   iwrc err);
+iwrc jbi_group_consumer(
+  struct jbexec *ctx, struct iwkv_cursor *cur, int64_t id, int64_t *step, bool *matched,
+  iwrc err);
 iwrc jbi_full_scanner(struct jbexec *ctx, jb_scan_consumer consumer);
+iwrc jbi_distinct_scanner(struct jbexec *ctx, jb_scan_consumer consumer);
 iwrc jbi_selection(struct jbexec *ctx);
 iwrc jbi_pk_scanner(struct jbexec *ctx, jb_scan_consumer consumer);
 iwrc jbi_uniq_scanner(struct jbexec *ctx, jb_scan_consumer consumer);
@@ -228,6 +391,20 @@ bool jbi_node_expr_matched(
   struct iwkv_cursor *cur,
   struct jqp_expr    *expr,
   iwrc               *rcp);
+iwrc jbi_resume_cursor_open(
+  struct jbexec *ctx, enum iwkv_cursor_op cursor_step, struct iwkv_cursor **curp,
+  int64_t *stepp);
+iwrc jbi_resume_token_save(struct jbexec *ctx, int64_t id);
+iwrc jbi_exec_check(struct jbexec *ctx);
+
+uint32_t jbi_fts_tokenize(
+  const char *text, size_t len, uint32_t pos,
+  jbi_fts_token_visitor visitor, void *op, iwrc *rcp);
+iwrc jbi_fts_query_parse(const char *text, struct iwpool *pool, struct jbi_fts_query **qp);
+iwrc jbi_fts_query_from_jqval(const struct jqval *jqval, struct iwpool *pool, struct jbi_fts_query **qp);
+bool jbi_fts_jqval_matched(struct jbi_fts_query *fq, const struct jqval *jqval, iwrc *rcp);
+iwrc jbi_fts_record_add(struct jbidx *idx, int64_t id, struct jbl *jbl, struct jbl *jblprev, int64_t *delta);
+iwrc jbi_fts_scanner(struct jbexec *ctx, jb_scan_consumer consumer);
 
 iwrc jb_get(struct ejdb *db, const char *coll, int64_t id, jb_coll_acquire_t acm, struct jbl **jblp);
 iwrc jb_put(struct jbcoll *jbc, struct jbl *jbl, int64_t id);
@@ -236,8 +413,16 @@ iwrc jb_cursor_set(struct jbcoll *jbc, struct iwkv_cursor *cur, int64_t id, JBL
 iwrc jb_cursor_del(struct jbcoll *jbc, struct iwkv_cursor *cur, int64_t id, JBL jbl);
 
 iwrc jb_collection_join_resolver(int64_t id, const char *coll, struct jbl **out, struct jbexec *ctx);
+iwrc jb_collection_join_resolver_many(
+  const int64_t *ids, size_t num, const char *coll,
+  struct iwpool *pool, struct jbl **out, struct jbexec *ctx);
 int jb_proj_node_cache_cmp(const void *v1, const void *v2);
+int jb_proj_node_cache_coll_cmp(const void *v1, const void *v2);
 void jb_proj_node_kvfree(void *key, void *val);
 uint32_t jb_proj_node_hash(const void *key);
 
+int jb_rwlock_rdlock(pthread_rwlock_t *rwl, struct jbhist *wait);
+int jb_rwlock_wrlock(pthread_rwlock_t *rwl, struct jbhist *wait);
+iwrc jb_metrics_print(struct ejdb *db, struct iwxstr *xstr);
+
 #endif
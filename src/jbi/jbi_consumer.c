@@ -5,11 +5,25 @@ iwrc jbi_consumer(struct jbexec *ctx, struct iwkv_cursor *cur, int64_t id, int64
     return err;
   }
 
-  iwrc rc;
   struct jbl jbl;
   size_t vsz = 0;
   struct ejdb_exec *ux = ctx->ux;
   struct iwpool *pool = ux->pool;
+  iwrc rc = jbi_exec_check(ctx);
+  RCRET(rc);
+
+  if (ux->skip > 0) {
+    struct jbmidx *midx = &ctx->midx;
+    if (  midx->covered
+       && (midx->expr1->prematched || (midx->expr1->op->value == JQP_OP_PREFIX))) {
+      // Index scan guarantees document is matched, no need to fetch it
+      *matched = true;
+      ++ctx->scanned;
+      ++ctx->matched;
+      --ux->skip;
+      return 0;
+    }
+  }
 
 start:
   {
@@ -54,6 +68,10 @@ start:
   RCC(rc, finish, jbl_from_buf_keep_onstack(&jbl, ctx->jblbuf, vsz));
 
   rc = jql_matched(ux->q, &jbl, matched);
+  ++ctx->scanned;
+  if (*matched) {
+    ++ctx->matched;
+  }
   if (rc || !*matched || (ux->skip && (ux->skip-- > 0))) {
     goto finish;
   }
@@ -65,6 +83,9 @@ start:
   if (!ctx->istep) {
     struct jql *q = ux->q;
     ctx->istep = 1;
+    if (ux->resume && ctx->resumable) {
+      RCC(rc, finish, jbi_resume_token_save(ctx, id));
+    }
     struct jqp_aux *aux = q->aux;
     struct ejdb_doc doc = {
       .id = id,
@@ -3,7 +3,7 @@
 static iwrc _jbi_consume_eq(struct jbexec *ctx, JQVAL *jqval, jb_scan_consumer consumer) {
   iwrc rc;
   bool matched;
-  IWKV_cursor cur;
+  IWKV_cursor cur = 0;
   char numbuf[IWNUMBUF_SIZE];
 
   int64_t step = 1;
@@ -18,12 +18,18 @@ static iwrc _jbi_consume_eq(struct jbexec *ctx, JQVAL *jqval, jb_scan_consumer c
   if (!key.size) {
     return consumer(ctx, 0, 0, 0, 0, 0);
   }
-  rc = iwkv_cursor_open(idx->idb, &cur, IWKV_CURSOR_GE, &key);
-  if (rc == IWKV_ERROR_NOTFOUND) {
-    return consumer(ctx, 0, 0, 0, 0, 0);
+  if (ctx->ux->resume && iwxstr_size(ctx->ux->resume)) {
+    rc = jbi_resume_cursor_open(ctx, midx->cursor_step, &cur, &step);
+    RCGO(rc, finish);
   } else {
-    RCRET(rc);
+    rc = iwkv_cursor_open(idx->idb, &cur, IWKV_CURSOR_GE, &key);
+    if (rc == IWKV_ERROR_NOTFOUND) {
+      return consumer(ctx, 0, 0, 0, 0, 0);
+    } else {
+      RCRET(rc);
+    }
   }
+  ctx->icur = cur;
 
   do {
     if (step > 0) {
@@ -47,6 +53,7 @@ finish:
     rc = 0;
   }
   if (cur) {
+    ctx->icur = 0;
     iwkv_cursor_close(&cur);
   }
   return consumer(ctx, 0, 0, 0, 0, rc);
@@ -64,7 +71,7 @@ static iwrc _jbi_consume_in_node(struct jbexec *ctx, JQVAL *jqval, jb_scan_consu
   int64_t id;
   bool matched;
   char jqvarrbuf[512];
-  char numbuf[IWNUMBUF_SIZE];
+  char numbuf[IWNUMBUF_SIZE], pnumbuf[IWNUMBUF_SIZE];
 
   iwrc rc = 0;
   int64_t step = 1;
@@ -101,6 +108,14 @@ static iwrc _jbi_consume_in_node(struct jbexec *ctx, JQVAL *jqval, jb_scan_consu
   for (int c = 0; c < i && !rc; ++c) {
     JQVAL *jqv = &jqvarr[c];
     jbi_jqval_fill_ikey(idx, jqv, &key, numbuf);
+    if (c > 0) {
+      // Repeated index keys are adjacent in sorted array, their documents are already visited
+      IWKV_val pkey;
+      jbi_jqval_fill_ikey(idx, &jqvarr[c - 1], &pkey, pnumbuf);
+      if ((pkey.size == key.size) && !memcmp(pkey.data, key.data, key.size)) {
+        continue;
+      }
+    }
     if (cur) {
       iwkv_cursor_close(&cur);
     }
@@ -137,7 +152,7 @@ finish:
 
 static iwrc _jbi_consume_scan(struct jbexec *ctx, JQVAL *jqval, jb_scan_consumer consumer) {
   size_t sz;
-  IWKV_cursor cur;
+  IWKV_cursor cur = 0;
   char numbuf[IWNUMBUF_SIZE];
 
   int64_t step = 1, prev_id = 0;
@@ -152,7 +167,13 @@ static iwrc _jbi_consume_scan(struct jbexec *ctx, JQVAL *jqval, jb_scan_consumer
   }
   key.compound = (midx->cursor_step == IWKV_CURSOR_PREV) ? INT64_MIN : INT64_MAX;
 
-  iwrc rc = iwkv_cursor_open(idx->idb, &cur, midx->cursor_init, &key);
+  iwrc rc;
+  if (ctx->ux->resume && iwxstr_size(ctx->ux->resume)) {
+    RCC(rc, finish, jbi_resume_cursor_open(ctx, midx->cursor_step, &cur, &step));
+    goto start;
+  }
+
+  rc = iwkv_cursor_open(idx->idb, &cur, midx->cursor_init, &key);
   if ((rc == IWKV_ERROR_NOTFOUND) && ((expr1_op == JQP_OP_LT) || (expr1_op == JQP_OP_LTE))) {
     iwkv_cursor_close(&cur);
     key.compound = INT64_MAX;
@@ -170,6 +191,8 @@ static iwrc _jbi_consume_scan(struct jbexec *ctx, JQVAL *jqval, jb_scan_consumer
     RCC(rc, finish, iwkv_cursor_to(cur, midx->cursor_step));
   }
 
+start:
+  ctx->icur = cur;
   IWKV_cursor_op cursor_reverse_step = (midx->cursor_step == IWKV_CURSOR_PREV)
                                        ? IWKV_CURSOR_NEXT : IWKV_CURSOR_PREV;
   do {
@@ -209,6 +232,7 @@ finish:
     rc = 0;
   }
   if (cur) {
+    ctx->icur = 0;
     iwkv_cursor_close(&cur);
   }
   return consumer(ctx, 0, 0, 0, 0, rc);
@@ -217,16 +241,21 @@ finish:
 static iwrc _jbi_consume_noxpr_scan(struct jbexec *ctx, jb_scan_consumer consumer) {
   iwrc rc;
   size_t sz;
-  IWKV_cursor cur;
+  IWKV_cursor cur = 0;
   int64_t step = 1, prev_id = 0;
   struct jbmidx *midx = &ctx->midx;
   IWKV_cursor_op cursor_reverse_step = (midx->cursor_step == IWKV_CURSOR_PREV)
                                        ? IWKV_CURSOR_NEXT : IWKV_CURSOR_PREV;
 
-  RCC(rc, finish, iwkv_cursor_open(midx->idx->idb, &cur, midx->cursor_init, 0));
-  if (midx->cursor_init < IWKV_CURSOR_NEXT) { // IWKV_CURSOR_BEFORE_FIRST || IWKV_CURSOR_AFTER_LAST
-    RCC(rc, finish, iwkv_cursor_to(cur, midx->cursor_step));
+  if (ctx->ux->resume && iwxstr_size(ctx->ux->resume)) {
+    RCC(rc, finish, jbi_resume_cursor_open(ctx, midx->cursor_step, &cur, &step));
+  } else {
+    RCC(rc, finish, iwkv_cursor_open(midx->idx->idb, &cur, midx->cursor_init, 0));
+    if (midx->cursor_init < IWKV_CURSOR_NEXT) { // IWKV_CURSOR_BEFORE_FIRST || IWKV_CURSOR_AFTER_LAST
+      RCC(rc, finish, iwkv_cursor_to(cur, midx->cursor_step));
+    }
   }
+  ctx->icur = cur;
   do {
     if (step > 0) {
       --step;
@@ -250,6 +279,7 @@ finish:
     rc = 0;
   }
   if (cur) {
+    ctx->icur = 0;
     iwkv_cursor_close(&cur);
   }
   return consumer(ctx, 0, 0, 0, 0, rc);
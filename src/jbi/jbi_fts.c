@@ -0,0 +1,859 @@
+#include "ejdb2_internal.h"
+
+// Full-text index layout (`IWDB_COMPOUND_KEYS` database):
+//
+//   <term>:<id> => uint32_t positions[] (little endian, ascending)
+//   \0:<id>     => uint32_t number of tokens in document `id`
+//   \0:0        => int64_t  total number of tokens in all indexed documents
+//
+// Terms never contain zero bytes so service records are kept apart from postings.
+
+#define FTS_SVC_KEY     "\0"
+#define FTS_SVC_KEY_LEN 1
+
+// BM25 parameters
+#define FTS_BM25_K1 1.2
+#define FTS_BM25_B  0.75
+
+typedef struct _fts_token {
+  const char *term;
+  uint32_t    len;
+  uint32_t    pos;
+} FTS_TOKEN;
+
+/** Document tokens collector */
+typedef struct _fts_tokens {
+  struct iwpool *pool;
+  FTS_TOKEN     *arr;
+  uint32_t       num;
+  uint32_t       asz;
+} FTS_TOKENS;
+
+/** Sequence of adjacent terms. Single query term is a phrase of length one. */
+typedef struct _fts_phrase {
+  struct _fts_phrase *next;
+  const char **terms;
+  uint32_t    *lens;
+  uint32_t     num;
+} FTS_PHRASE;
+
+/** AND joined phrases */
+typedef struct _fts_group {
+  struct _fts_group  *next;
+  struct _fts_phrase *phrases;
+} FTS_GROUP;
+
+/** OR joined groups */
+struct jbi_fts_query {
+  struct _fts_group *groups;
+};
+
+typedef struct _fts_posting {
+  int64_t   id;
+  uint32_t *pos;
+  uint32_t  npos;
+} FTS_POSTING;
+
+/** Postings list of single term */
+typedef struct _fts_plist {
+  struct _fts_plist *next;
+  const char  *term;
+  uint32_t     len;
+  uint32_t     num;
+  FTS_POSTING *arr;
+  double       idf;
+} FTS_PLIST;
+
+typedef struct _fts_hit {
+  int64_t id;
+  double  score;
+} FTS_HIT;
+
+typedef struct _fts_hits {
+  FTS_HIT *arr;
+  uint32_t num;
+} FTS_HITS;
+
+/** Full-text index scan context */
+typedef struct _fts_scan {
+  struct jbidx  *idx;
+  struct iwpool *pool;
+  FTS_PLIST     *plists;
+  int64_t ndocs;
+  double  avgdl;
+} FTS_SCAN;
+
+uint32_t jbi_fts_tokenize(
+  const char *text, size_t len, uint32_t pos,
+  jbi_fts_token_visitor visitor, void *op, iwrc *rcp) {
+  size_t blen = 0;
+  char buf[JBI_FTS_TERM_MAX_LEN];
+  *rcp = 0;
+  for (size_t i = 0; i <= len; ++i) {
+    uint8_t c = (i < len) ? (uint8_t) text[i] : 0;
+    if (  (c >= 0x80) // Keep multibyte UTF-8 sequences as is
+       || ((c >= '0') && (c <= '9'))
+       || ((c >= 'a') && (c <= 'z'))
+       || ((c >= 'A') && (c <= 'Z'))) {
+      if (blen < sizeof(buf)) { // Long words are truncated
+        buf[blen++] = ((c >= 'A') && (c <= 'Z')) ? (char) (c + ('a' - 'A')) : (char) c;
+      }
+    } else if (blen) {
+      *rcp = visitor(buf, blen, pos++, op);
+      if (*rcp) {
+        break;
+      }
+      blen = 0;
+    }
+  }
+  return pos;
+}
+
+static iwrc _fts_tokens_add(const char *term, size_t len, uint32_t pos, void *op) {
+  FTS_TOKENS *tokens = op;
+  if (tokens->num >= tokens->asz) {
+    uint32_t nsz = tokens->asz ? tokens->asz * 2 : 64;
+    FTS_TOKEN *narr = realloc(tokens->arr, nsz * sizeof(*narr));
+    if (!narr) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    tokens->arr = narr;
+    tokens->asz = nsz;
+  }
+  char *t = iwpool_alloc(len, tokens->pool);
+  if (!t) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  memcpy(t, term, len);
+  tokens->arr[tokens->num++] = (FTS_TOKEN) {
+    .term = t,
+    .len = len,
+    .pos = pos
+  };
+  return 0;
+}
+
+IW_INLINE int _fts_term_cmp(const char *t1, uint32_t l1, const char *t2, uint32_t l2) {
+  int ret = memcmp(t1, t2, MIN(l1, l2));
+  if (!ret) {
+    return l1 > l2 ? 1 : l1 < l2 ? -1 : 0;
+  }
+  return ret;
+}
+
+static int _fts_token_cmp(const void *v1, const void *v2) {
+  const FTS_TOKEN *t1 = v1, *t2 = v2;
+  int ret = _fts_term_cmp(t1->term, t1->len, t2->term, t2->len);
+  if (!ret) {
+    return t1->pos > t2->pos ? 1 : t1->pos < t2->pos ? -1 : 0;
+  }
+  return ret;
+}
+
+static void _fts_tokens_sort(FTS_TOKENS *tokens) {
+  if (tokens->num > 1) {
+    qsort(tokens->arr, tokens->num, sizeof(tokens->arr[0]), _fts_token_cmp);
+  }
+}
+
+static bool _fts_tokens_has(FTS_TOKENS *tokens, const char *term, uint32_t len, uint32_t pos) {
+  FTS_TOKEN key = {
+    .term = term,
+    .len = len,
+    .pos = pos
+  };
+  return tokens->num && bsearch(&key, tokens->arr, tokens->num, sizeof(tokens->arr[0]), _fts_token_cmp);
+}
+
+/**
+ * @brief Returns the first token of given `term` in sorted tokens array or zero.
+ */
+static FTS_TOKEN* _fts_tokens_find_term(FTS_TOKENS *tokens, const char *term, uint32_t len) {
+  uint32_t l = 0, h = tokens->num;
+  while (l < h) {
+    uint32_t m = l + (h - l) / 2;
+    if (_fts_term_cmp(tokens->arr[m].term, tokens->arr[m].len, term, len) < 0) {
+      l = m + 1;
+    } else {
+      h = m;
+    }
+  }
+  if ((l < tokens->num) && !_fts_term_cmp(tokens->arr[l].term, tokens->arr[l].len, term, len)) {
+    return &tokens->arr[l];
+  }
+  return 0;
+}
+
+static iwrc _fts_tokens_add_jbl(FTS_TOKENS *tokens, struct jbl *jbv) {
+  iwrc rc = 0;
+  uint32_t pos = 0;
+  jbl_type_t type = jbl_type(jbv);
+  if (type == JBV_STR) {
+    jbi_fts_tokenize(jbl_get_str(jbv), jbl_size(jbv), pos, _fts_tokens_add, tokens, &rc);
+  } else if (type == JBV_ARRAY) {
+    struct jbl_node *n;
+    rc = jbl_to_node(jbv, &n, false, tokens->pool);
+    RCRET(rc);
+    for (n = n->child; n; n = n->next) {
+      if (n->type == JBV_STR) {
+        // Gap between array elements prevents phrase matching across them
+        pos = jbi_fts_tokenize(n->vptr, n->vsize, pos, _fts_tokens_add, tokens, &rc) + 1;
+        RCBREAK(rc);
+      }
+    }
+  }
+  return rc;
+}
+
+//----------------------- Index update
+
+static iwrc _fts_stats_update(struct jbidx *idx, int64_t delta) {
+  size_t sz = 0;
+  int64_t llv = 0;
+  struct iwkv_val val = {
+    .data = &llv,
+    .size = sizeof(llv)
+  };
+  struct iwkv_val key = {
+    .data = FTS_SVC_KEY,
+    .size = FTS_SVC_KEY_LEN,
+    .compound = 0
+  };
+  iwrc rc = iwkv_get_copy(idx->idb, &key, &llv, sizeof(llv), &sz);
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    rc = 0;
+  }
+  RCRET(rc);
+  llv = IW_HTOILL(IW_ITOHLL(llv) + delta);
+  return iwkv_put(idx->idb, &key, &val, 0);
+}
+
+static iwrc _fts_doc_remove(struct jbidx *idx, int64_t id, FTS_TOKENS *prev, FTS_TOKENS *next) {
+  iwrc rc = 0;
+  struct iwkv_val key;
+  for (uint32_t i = 0; i < prev->num; ++i) {
+    FTS_TOKEN *t = &prev->arr[i];
+    if (i && !_fts_term_cmp(t->term, t->len, prev->arr[i - 1].term, prev->arr[i - 1].len)) {
+      continue;
+    }
+    if (next && _fts_tokens_find_term(next, t->term, t->len)) {
+      continue; // Term will be overwritten by new positions
+    }
+    key.data = (void*) t->term;
+    key.size = t->len;
+    key.compound = id;
+    rc = iwkv_del(idx->idb, &key, 0);
+    if (rc == IWKV_ERROR_NOTFOUND) {
+      rc = 0;
+    }
+    RCRET(rc);
+  }
+  key.data = FTS_SVC_KEY;
+  key.size = FTS_SVC_KEY_LEN;
+  key.compound = id;
+  rc = iwkv_del(idx->idb, &key, 0);
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    rc = 0;
+  }
+  return rc;
+}
+
+static iwrc _fts_doc_add(struct jbidx *idx, int64_t id, FTS_TOKENS *tokens) {
+  iwrc rc = 0;
+  uint32_t dlen = IW_HTOIL(tokens->num);
+  struct iwkv_val key, val;
+  uint32_t *pbuf = malloc(tokens->num * sizeof(*pbuf));
+  if (!pbuf) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  for (uint32_t i = 0, j; i < tokens->num; i = j) {
+    FTS_TOKEN *t = &tokens->arr[i];
+    for (j = i; j < tokens->num && !_fts_term_cmp(t->term, t->len, tokens->arr[j].term, tokens->arr[j].len); ++j) {
+      pbuf[j - i] = IW_HTOIL(tokens->arr[j].pos);
+    }
+    key.data = (void*) t->term;
+    key.size = t->len;
+    key.compound = id;
+    val.data = pbuf;
+    val.size = (j - i) * sizeof(*pbuf);
+    RCC(rc, finish, iwkv_put(idx->idb, &key, &val, 0));
+  }
+  key.data = FTS_SVC_KEY;
+  key.size = FTS_SVC_KEY_LEN;
+  key.compound = id;
+  val.data = &dlen;
+  val.size = sizeof(dlen);
+  rc = iwkv_put(idx->idb, &key, &val, 0);
+
+finish:
+  free(pbuf);
+  return rc;
+}
+
+iwrc jbi_fts_record_add(struct jbidx *idx, int64_t id, struct jbl *jbl, struct jbl *jblprev, int64_t *delta) {
+  struct jbl jbv = { 0 }, jbvprev = { 0 };
+  bool jbv_found = jbl ? _jbl_at(jbl, idx->ptr, &jbv) : false;
+  bool jbvprev_found = jblprev ? _jbl_at(jblprev, idx->ptr, &jbvprev) : false;
+
+  *delta = 0;
+  if (!jbv_found && !jbvprev_found) {
+    return 0;
+  }
+  if (  jbv_found && jbvprev_found
+     && (jbl_type(&jbv) == JBV_STR) && _jbl_is_eq_atomic_values(&jbv, &jbvprev)) {
+    return 0;
+  }
+
+  iwrc rc = 0;
+  int64_t tdelta = 0;
+  struct iwpool *pool = iwpool_create(1024);
+  if (!pool) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  FTS_TOKENS tokens = { .pool = pool }, ptokens = { .pool = pool };
+
+  if (jbv_found) {
+    RCC(rc, finish, _fts_tokens_add_jbl(&tokens, &jbv));
+    _fts_tokens_sort(&tokens);
+  }
+  if (jbvprev_found) {
+    RCC(rc, finish, _fts_tokens_add_jbl(&ptokens, &jbvprev));
+    _fts_tokens_sort(&ptokens);
+  }
+  if (ptokens.num) {
+    RCC(rc, finish, _fts_doc_remove(idx, id, &ptokens, tokens.num ? &tokens : 0));
+    tdelta -= ptokens.num;
+    *delta -= 1;
+  }
+  if (tokens.num) {
+    RCC(rc, finish, _fts_doc_add(idx, id, &tokens));
+    tdelta += tokens.num;
+    *delta += 1;
+  }
+  if (tdelta) {
+    rc = _fts_stats_update(idx, tdelta);
+  }
+
+finish:
+  free(tokens.arr);
+  free(ptokens.arr);
+  iwpool_destroy(pool);
+  return rc;
+}
+
+//----------------------- Query
+
+static iwrc _fts_phrase_create(FTS_TOKENS *tokens, struct iwpool *pool, FTS_PHRASE **out) {
+  *out = 0;
+  if (!tokens->num) {
+    return 0;
+  }
+  FTS_PHRASE *p = iwpool_calloc(sizeof(*p), pool);
+  if (!p) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  p->terms = iwpool_alloc(tokens->num * sizeof(p->terms[0]), pool);
+  p->lens = iwpool_alloc(tokens->num * sizeof(p->lens[0]), pool);
+  if (!p->terms || !p->lens) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  for (uint32_t i = 0; i < tokens->num; ++i) {
+    p->terms[i] = tokens->arr[i].term;
+    p->lens[i] = tokens->arr[i].len;
+  }
+  p->num = tokens->num;
+  tokens->num = 0;
+  *out = p;
+  return 0;
+}
+
+iwrc jbi_fts_query_parse(const char *text, struct iwpool *pool, struct jbi_fts_query **qp) {
+  *qp = 0;
+  iwrc rc = 0;
+  FTS_PHRASE *p;
+  FTS_GROUP *g = 0, *gl = 0;
+  FTS_TOKENS tokens = { .pool = pool };
+  struct jbi_fts_query *q = iwpool_calloc(sizeof(*q), pool);
+  if (!q) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  for (const char *c = text; *c; ) {
+    const char *s;
+    bool group_end = false;
+    if ((*c == ' ') || (*c == '\t') || (*c == '\r') || (*c == '\n')) {
+      ++c;
+      continue;
+    }
+    if (*c == '|') {
+      group_end = true;
+      ++c;
+    } else if (*c == '"') { // Phrase
+      for (s = ++c; *c && *c != '"'; ++c);
+      jbi_fts_tokenize(s, c - s, 0, _fts_tokens_add, &tokens, &rc);
+      RCGO(rc, finish);
+      if (*c) {
+        ++c;
+      }
+    } else {
+      for (s = c; *c && *c != ' ' && *c != '\t' && *c != '\r' && *c != '\n' && *c != '|' && *c != '"'; ++c);
+      if ((c - s == 2) && !strncmp(s, "OR", 2)) {
+        group_end = true;
+      } else { // Word delimiters within a single query word form a phrase, eg: `e-mail`
+        jbi_fts_tokenize(s, c - s, 0, _fts_tokens_add, &tokens, &rc);
+        RCGO(rc, finish);
+      }
+    }
+    if (group_end) {
+      g = 0;
+      continue;
+    }
+    RCC(rc, finish, _fts_phrase_create(&tokens, pool, &p));
+    if (!p) {
+      continue;
+    }
+    if (!g) {
+      g = iwpool_calloc(sizeof(*g), pool);
+      if (!g) {
+        rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+        goto finish;
+      }
+      if (gl) {
+        gl->next = g;
+      } else {
+        q->groups = g;
+      }
+      gl = g;
+    }
+    p->next = g->phrases;
+    g->phrases = p;
+  }
+  *qp = q;
+
+finish:
+  free(tokens.arr);
+  return rc;
+}
+
+iwrc jbi_fts_query_from_jqval(const struct jqval *jqval, struct iwpool *pool, struct jbi_fts_query **qp) {
+  *qp = 0;
+  if (jqval->type == JQVAL_STR) {
+    return jbi_fts_query_parse(jqval->vstr, pool, qp);
+  } else if ((jqval->type == JQVAL_JBLNODE) && (jqval->vnode->type == JBV_STR)) {
+    iwrc rc = 0;
+    char *text = iwpool_strndup(pool, jqval->vnode->vptr, jqval->vnode->vsize, &rc);
+    RCRET(rc);
+    return jbi_fts_query_parse(text, pool, qp);
+  }
+  return 0;
+}
+
+static bool _fts_doc_matched(struct jbi_fts_query *fq, FTS_TOKENS *tokens) {
+  for (FTS_GROUP *g = fq->groups; g; g = g->next) {
+    FTS_PHRASE *p = g->phrases;
+    for ( ; p; p = p->next) {
+      bool pmatched = false;
+      FTS_TOKEN *t = _fts_tokens_find_term(tokens, p->terms[0], p->lens[0]);
+      if (!t) {
+        break;
+      }
+      for ( ; t < tokens->arr + tokens->num && !_fts_term_cmp(t->term, t->len, p->terms[0], p->lens[0]); ++t) {
+        uint32_t i = 1;
+        for ( ; i < p->num && _fts_tokens_has(tokens, p->terms[i], p->lens[i], t->pos + i); ++i);
+        if (i == p->num) {
+          pmatched = true;
+          break;
+        }
+      }
+      if (!pmatched) {
+        break;
+      }
+    }
+    if (!p) {
+      return true;
+    }
+  }
+  return false;
+}
+
+bool jbi_fts_jqval_matched(struct jbi_fts_query *fq, const struct jqval *jqval, iwrc *rcp) {
+  bool ret = false;
+  uint32_t pos = 0;
+  *rcp = 0;
+  if (!fq->groups) {
+    return false;
+  }
+  struct iwpool *pool = iwpool_create(256);
+  if (!pool) {
+    *rcp = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    return false;
+  }
+  FTS_TOKENS tokens = { .pool = pool };
+
+  switch (jqval->type) {
+    case JQVAL_STR:
+      jbi_fts_tokenize(jqval->vstr, strlen(jqval->vstr), pos, _fts_tokens_add, &tokens, rcp);
+      break;
+    case JQVAL_JBLNODE: {
+      struct jbl_node *n = jqval->vnode;
+      if (n->type == JBV_STR) {
+        jbi_fts_tokenize(n->vptr, n->vsize, pos, _fts_tokens_add, &tokens, rcp);
+      } else if (n->type == JBV_ARRAY) {
+        for (n = n->child; n && !*rcp; n = n->next) {
+          if (n->type == JBV_STR) {
+            pos = jbi_fts_tokenize(n->vptr, n->vsize, pos, _fts_tokens_add, &tokens, rcp) + 1;
+          }
+        }
+      }
+      break;
+    }
+    case JQVAL_BINN: {
+      binn *bn = jqval->vbinn;
+      if (bn->type == BINN_STRING) {
+        jbi_fts_tokenize(bn->ptr, strlen(bn->ptr), pos, _fts_tokens_add, &tokens, rcp);
+      } else if (bn->type == BINN_LIST) {
+        binn bv;
+        binn_iter iter;
+        if (!binn_iter_init(&iter, bn, bn->type)) {
+          *rcp = JBL_ERROR_INVALID;
+          break;
+        }
+        while (!*rcp && binn_list_next(&iter, &bv)) {
+          if (bv.type == BINN_STRING) {
+            pos = jbi_fts_tokenize(bv.ptr, strlen(bv.ptr), pos, _fts_tokens_add, &tokens, rcp) + 1;
+          }
+        }
+      }
+      break;
+    }
+    default:
+      break;
+  }
+  if (!*rcp && tokens.num) {
+    _fts_tokens_sort(&tokens);
+    ret = _fts_doc_matched(fq, &tokens);
+  }
+  free(tokens.arr);
+  iwpool_destroy(pool);
+  return ret;
+}
+
+//----------------------- Index scan
+
+static int _fts_posting_cmp(const void *v1, const void *v2) {
+  const FTS_POSTING *p1 = v1, *p2 = v2;
+  return p1->id > p2->id ? 1 : p1->id < p2->id ? -1 : 0;
+}
+
+static int _fts_hit_score_cmp(const void *v1, const void *v2) {
+  const FTS_HIT *h1 = v1, *h2 = v2;
+  if (h1->score != h2->score) {
+    return h1->score < h2->score ? 1 : -1;
+  }
+  return h1->id < h2->id ? 1 : h1->id > h2->id ? -1 : 0; // Recent documents first
+}
+
+static int _fts_u32_cmp(const void *v1, const void *v2) {
+  uint32_t p1 = *(const uint32_t*) v1, p2 = *(const uint32_t*) v2;
+  return p1 > p2 ? 1 : p1 < p2 ? -1 : 0;
+}
+
+static iwrc _fts_plist_get(FTS_SCAN *sctx, const char *term, uint32_t len, FTS_PLIST **out) {
+  *out = 0;
+  for (FTS_PLIST *pl = sctx->plists; pl; pl = pl->next) {
+    if (!_fts_term_cmp(pl->term, pl->len, term, len)) {
+      *out = pl;
+      return 0;
+    }
+  }
+
+  iwrc rc;
+  bool matched;
+  IWKV_cursor cur = 0;
+  struct iwkv_val val;
+  IWXSTR *xstr = iwxstr_new();
+  if (!xstr) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  FTS_PLIST *pl = iwpool_calloc(sizeof(*pl), sctx->pool);
+  if (!pl) {
+    rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    goto finish;
+  }
+  pl->term = term;
+  pl->len = len;
+
+  IWKV_val key = {
+    .data = (void*) term,
+    .size = len,
+    .compound = INT64_MIN
+  };
+  rc = iwkv_cursor_open(sctx->idx->idb, &cur, IWKV_CURSOR_GE, &key);
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    rc = 0;
+    goto finish;
+  }
+  RCGO(rc, finish);
+
+  do {
+    FTS_POSTING p;
+    RCC(rc, finish, iwkv_cursor_is_matched_key(cur, &key, &matched, &p.id));
+    if (!matched) {
+      break;
+    }
+    RCC(rc, finish, iwkv_cursor_val(cur, &val));
+    p.npos = val.size / sizeof(uint32_t);
+    p.pos = iwpool_alloc(p.npos * sizeof(uint32_t) + 1, sctx->pool);
+    if (!p.pos) {
+      rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      iwkv_val_dispose(&val);
+      goto finish;
+    }
+    memcpy(p.pos, val.data, p.npos * sizeof(uint32_t));
+    iwkv_val_dispose(&val);
+    for (uint32_t i = 0; i < p.npos; ++i) {
+      p.pos[i] = IW_ITOHL(p.pos[i]);
+    }
+    RCC(rc, finish, iwxstr_cat(xstr, &p, sizeof(p)));
+  } while (!(rc = iwkv_cursor_to(cur, IWKV_CURSOR_PREV)));
+
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    rc = 0;
+  }
+
+finish:
+  if (cur) {
+    iwkv_cursor_close(&cur);
+  }
+  if (!rc) {
+    pl->num = iwxstr_size(xstr) / sizeof(FTS_POSTING);
+    if (pl->num) {
+      pl->arr = iwpool_alloc(iwxstr_size(xstr), sctx->pool);
+      if (!pl->arr) {
+        rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      } else {
+        memcpy(pl->arr, iwxstr_ptr(xstr), iwxstr_size(xstr));
+        qsort(pl->arr, pl->num, sizeof(pl->arr[0]), _fts_posting_cmp);
+      }
+    }
+    if (!rc) {
+      double n = (double) sctx->ndocs, df = (double) pl->num;
+      pl->idf = log(1.0 + (n - df + 0.5) / (df + 0.5));
+      pl->next = sctx->plists;
+      sctx->plists = pl;
+      *out = pl;
+    }
+  }
+  iwxstr_destroy(xstr);
+  return rc;
+}
+
+static double _fts_doclen(FTS_SCAN *sctx, int64_t id) {
+  size_t sz = 0;
+  uint32_t dlen = 0;
+  struct iwkv_val key = {
+    .data = FTS_SVC_KEY,
+    .size = FTS_SVC_KEY_LEN,
+    .compound = id
+  };
+  if (iwkv_get_copy(sctx->idx->idb, &key, &dlen, sizeof(dlen), &sz) || (sz != sizeof(dlen))) {
+    return sctx->avgdl;
+  }
+  return (double) IW_ITOHL(dlen);
+}
+
+IW_INLINE double _fts_bm25(FTS_SCAN *sctx, FTS_PLIST *pl, uint32_t tf, double dl) {
+  double norm = FTS_BM25_K1 * (1.0 - FTS_BM25_B + FTS_BM25_B * dl / sctx->avgdl);
+  return pl->idf * (tf * (FTS_BM25_K1 + 1.0)) / (tf + norm);
+}
+
+/**
+ * @brief Collects documents containing given phrase.
+ *        Hits are sorted by document id.
+ */
+static iwrc _fts_phrase_hits(FTS_SCAN *sctx, FTS_PHRASE *p, FTS_HITS *out) {
+  iwrc rc = 0;
+  FTS_PLIST *pls[p->num];
+  out->arr = 0;
+  out->num = 0;
+
+  for (uint32_t i = 0; i < p->num; ++i) {
+    rc = _fts_plist_get(sctx, p->terms[i], p->lens[i], &pls[i]);
+    RCRET(rc);
+    if (!pls[i]->num) {
+      return 0;
+    }
+  }
+  out->arr = iwpool_alloc(pls[0]->num * sizeof(out->arr[0]), sctx->pool);
+  if (!out->arr) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  for (uint32_t k = 0; k < pls[0]->num; ++k) {
+    FTS_POSTING *p0 = &pls[0]->arr[k];
+    FTS_POSTING *pp[p->num];
+    uint32_t tf = 0, i;
+    pp[0] = p0;
+    for (i = 1; i < p->num; ++i) {
+      pp[i] = bsearch(p0, pls[i]->arr, pls[i]->num, sizeof(*p0), _fts_posting_cmp);
+      if (!pp[i]) {
+        break;
+      }
+    }
+    if (i < p->num) {
+      continue;
+    }
+    if (p->num > 1) { // Count phrase occurrences
+      for (uint32_t j = 0; j < p0->npos; ++j) {
+        for (i = 1; i < p->num; ++i) {
+          uint32_t pos = p0->pos[j] + i;
+          if (!bsearch(&pos, pp[i]->pos, pp[i]->npos, sizeof(pos), _fts_u32_cmp)) {
+            break;
+          }
+        }
+        if (i == p->num) {
+          ++tf;
+        }
+      }
+      if (!tf) {
+        continue;
+      }
+    }
+    double score = 0, dl = _fts_doclen(sctx, p0->id);
+    for (i = 0; i < p->num; ++i) {
+      score += _fts_bm25(sctx, pls[i], p->num > 1 ? tf : pp[i]->npos, dl);
+    }
+    out->arr[out->num++] = (FTS_HIT) {
+      .id = p0->id,
+      .score = score
+    };
+  }
+  return rc;
+}
+
+/**
+ * @brief Computes ranked hits of the whole query.
+ */
+static iwrc _fts_query_hits(FTS_SCAN *sctx, struct jbi_fts_query *fq, FTS_HITS *out) {
+  iwrc rc = 0;
+  out->arr = 0;
+  out->num = 0;
+  for (FTS_GROUP *g = fq->groups; g; g = g->next) {
+    FTS_HITS gh = { 0 };
+    bool first = true;
+    for (FTS_PHRASE *p = g->phrases; p; p = p->next) {
+      FTS_HITS ph;
+      rc = _fts_phrase_hits(sctx, p, &ph);
+      RCRET(rc);
+      if (first) {
+        gh = ph;
+        first = false;
+      } else { // Intersect
+        uint32_t i = 0, j = 0, n = 0;
+        while (i < gh.num && j < ph.num) {
+          if (gh.arr[i].id < ph.arr[j].id) {
+            ++i;
+          } else if (gh.arr[i].id > ph.arr[j].id) {
+            ++j;
+          } else {
+            gh.arr[n].id = gh.arr[i].id;
+            gh.arr[n++].score = gh.arr[i++].score + ph.arr[j++].score;
+          }
+        }
+        gh.num = n;
+      }
+      if (!gh.num) {
+        break;
+      }
+    }
+    if (!gh.num) {
+      continue;
+    }
+    if (!out->num) {
+      *out = gh;
+    } else { // Union
+      uint32_t i = 0, j = 0, n = 0;
+      FTS_HIT *arr = iwpool_alloc((out->num + gh.num) * sizeof(arr[0]), sctx->pool);
+      if (!arr) {
+        return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      }
+      while (i < out->num || j < gh.num) {
+        if ((j >= gh.num) || ((i < out->num) && (out->arr[i].id < gh.arr[j].id))) {
+          arr[n++] = out->arr[i++];
+        } else if ((i >= out->num) || (gh.arr[j].id < out->arr[i].id)) {
+          arr[n++] = gh.arr[j++];
+        } else {
+          arr[n].id = out->arr[i].id;
+          arr[n++].score = MAX(out->arr[i].score, gh.arr[j].score);
+          ++i, ++j;
+        }
+      }
+      out->arr = arr;
+      out->num = n;
+    }
+  }
+  return rc;
+}
+
+iwrc jbi_fts_scanner(struct jbexec *ctx, jb_scan_consumer consumer) {
+  iwrc rc = 0;
+  bool matched;
+  size_t sz = 0;
+  int64_t tokens = 0;
+  FTS_HITS hits = { 0 };
+  struct jbmidx *midx = &ctx->midx;
+  struct jbi_fts_query *fq = midx->expr1->op->opaque;
+  JQVAL *jqval = jql_unit_to_jqval(ctx->ux->q->aux, midx->expr1->right, &rc);
+  RCRET(rc);
+
+  FTS_SCAN sctx = {
+    .idx = midx->idx,
+    .ndocs = midx->idx->rnum
+  };
+  if (!fq) {
+    rc = jbi_fts_query_from_jqval(jqval, ctx->ux->q->aux->pool, &fq);
+    RCRET(rc);
+    midx->expr1->op->opaque = fq;
+  }
+  if (!fq || (sctx.ndocs < 1)) {
+    return consumer(ctx, 0, 0, 0, 0, 0);
+  }
+  RCB(finish, sctx.pool = iwpool_create(4096));
+
+  struct iwkv_val key = {
+    .data = FTS_SVC_KEY,
+    .size = FTS_SVC_KEY_LEN,
+    .compound = 0
+  };
+  rc = iwkv_get_copy(sctx.idx->idb, &key, &tokens, sizeof(tokens), &sz);
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    rc = 0;
+  }
+  RCGO(rc, finish);
+  tokens = IW_ITOHLL(tokens);
+  sctx.avgdl = tokens > 0 ? (double) tokens / sctx.ndocs : 1.0;
+
+  RCC(rc, finish, _fts_query_hits(&sctx, fq, &hits));
+  if (hits.num > 1) {
+    qsort(hits.arr, hits.num, sizeof(hits.arr[0]), _fts_hit_score_cmp);
+  }
+  if (ctx->ux->log) {
+    iwxstr_printf(ctx->ux->log, "[FTS] HITS: %" PRIu32 "\n", hits.num);
+  }
+  if (hits.num) {
+    int64_t i = 0, step = 1;
+    do {
+      if (step > 0) {
+        --step;
+      } else if (step < 0) {
+        ++step;
+      }
+      if (!step) {
+        step = 1;
+        RCC(rc, finish, consumer(ctx, 0, hits.arr[i].id, &step, &matched, 0));
+      }
+    } while (step && (step > 0 ? (++i < hits.num) : (--i >= 0)));
+  }
+
+finish:
+  iwpool_destroy(sctx.pool);
+  return consumer(ctx, 0, 0, 0, 0, rc);
+}
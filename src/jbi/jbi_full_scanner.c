@@ -1,16 +1,22 @@
 #include "ejdb2_internal.h"
 
 iwrc jbi_full_scanner(struct jbexec *ctx, jb_scan_consumer consumer) {
+  iwrc rc;
   bool matched;
-  IWKV_cursor cur;
+  IWKV_cursor cur = 0;
   int64_t step = 1;
-  iwrc rc = iwkv_cursor_open(ctx->jbc->cdb, &cur, ctx->cursor_init, 0);
-  RCRET(rc);
-
   IWKV_cursor_op cursor_reverse_step = (ctx->cursor_step == IWKV_CURSOR_NEXT)
                                        ? IWKV_CURSOR_PREV : IWKV_CURSOR_NEXT;
 
-  while (step && !(rc = iwkv_cursor_to(cur, step > 0 ? ctx->cursor_step : cursor_reverse_step))) {
+  if (ctx->ux->resume && iwxstr_size(ctx->ux->resume)) {
+    RCC(rc, finish, jbi_resume_cursor_open(ctx, ctx->cursor_step, &cur, &step));
+  } else {
+    rc = iwkv_cursor_open(ctx->jbc->cdb, &cur, ctx->cursor_init, 0);
+    RCRET(rc);
+    RCC(rc, finish, iwkv_cursor_to(cur, ctx->cursor_step));
+  }
+
+  do {
     if (step > 0) {
       --step;
     } else if (step < 0) {
@@ -31,10 +37,14 @@ iwrc jbi_full_scanner(struct jbexec *ctx, jb_scan_consumer consumer) {
       rc = consumer(ctx, cur, id, &step, &matched, 0);
       RCBREAK(rc);
     }
-  }
+  } while (step && !(rc = iwkv_cursor_to(cur, step > 0 ? ctx->cursor_step : cursor_reverse_step)));
+
+finish:
   if (rc == IWKV_ERROR_NOTFOUND) {
     rc = 0;
   }
-  iwkv_cursor_close(&cur);
+  if (cur) {
+    iwkv_cursor_close(&cur);
+  }
   return consumer(ctx, 0, 0, 0, 0, rc);
 }
@@ -0,0 +1,820 @@
+#include "ejdb2_internal.h"
+#include <iowow/wyhash32.h>
+
+/** Approximate memory overhead of groups hash map entry */
+#define JBI_GROUP_ENTRY_OVERHEAD 32
+
+/** Groups overflow file record header: `| hash:u32 | ksz:u32 | cnt:i64 |`
+    followed by aggregate states and group key */
+#define JBI_GROUP_REC_HDR_SZ (2 * sizeof(uint32_t) + sizeof(int64_t))
+
+/** Accumulated state of aggregate clause */
+struct jbgagg {
+  int64_t num;    /**< Number of numeric values accumulated */
+  int64_t vi64;   /**< Integer part of `sum`/`avg`, integer value of `min`/`max` */
+  double  vf64;   /**< Floating point part of `sum`/`avg`, floating point value of `min`/`max` */
+  bool    real;   /**< Result is floating point number */
+};
+
+/** Group of documents, entry itself is used as map key */
+struct jbgroup {
+  uint32_t hash;
+  uint32_t ksz;           /**< Key size */
+  uint8_t *key;           /**< Key: `| jbl_type_t:u8 | value |`, placed right after aggregate states */
+  int64_t  cnt;           /**< Number of documents in group */
+  struct jbgagg aggs[];   /**< Aggregate states in order of query clauses */
+};
+
+static const char *_jbi_group_ops[] = {
+  [JQP_AGG_SUM] = "sum",
+  [JQP_AGG_MIN] = "min",
+  [JQP_AGG_MAX] = "max",
+  [JQP_AGG_AVG] = "avg"
+};
+
+static int _jbi_group_cmp(const void *v1, const void *v2) {
+  const struct jbgroup *g1 = v1;
+  const struct jbgroup *g2 = v2;
+  if (g1->ksz != g2->ksz) {
+    return g1->ksz > g2->ksz ? 1 : -1;
+  }
+  return memcmp(g1->key, g2->key, g1->ksz);
+}
+
+static uint32_t _jbi_group_hash(const void *key) {
+  const struct jbgroup *g = key;
+  return g->hash;
+}
+
+static void _jbi_group_kvfree(void *key, void *val) {
+  // Groups are allocated in pool
+}
+
+IW_INLINE double _jbi_group_key_f64(const struct jbgroup *g) {
+  int64_t llv;
+  double dv;
+  if (g->key[0] == JBV_I64) {
+    memcpy(&llv, g->key + 1, sizeof(llv));
+    return (double) llv;
+  }
+  memcpy(&dv, g->key + 1, sizeof(dv));
+  return dv;
+}
+
+// Order of emitted groups: booleans, numbers, strings
+static int _jbi_group_key_cmp(const void *o1, const void *o2) {
+  const struct jbgroup *g1 = *(const struct jbgroup**) o1;
+  const struct jbgroup *g2 = *(const struct jbgroup**) o2;
+  if (!g1->ksz || !g2->ksz) {
+    return (int) g1->ksz - (int) g2->ksz;
+  }
+  uint8_t t1 = g1->key[0], t2 = g2->key[0];
+  if (((t1 == JBV_I64) || (t1 == JBV_F64)) && ((t2 == JBV_I64) || (t2 == JBV_F64))) {
+    if ((t1 == JBV_I64) && (t2 == JBV_I64)) {
+      int64_t v1, v2;
+      memcpy(&v1, g1->key + 1, sizeof(v1));
+      memcpy(&v2, g2->key + 1, sizeof(v2));
+      return v1 > v2 ? 1 : v1 < v2 ? -1 : 0;
+    } else {
+      double v1 = _jbi_group_key_f64(g1);
+      double v2 = _jbi_group_key_f64(g2);
+      return v1 > v2 ? 1 : v1 < v2 ? -1 : 0;
+    }
+  }
+  if (t1 != t2) {
+    return (int) t1 - (int) t2;
+  }
+  if (t1 == JBV_STR) {
+    return strcmp((const char*) g1->key + 1, (const char*) g2->key + 1);
+  }
+  return (int) g1->key[1] - (int) g2->key[1];
+}
+
+static int _jbi_group_agg_cmp(const struct jbgagg *a1, const struct jbgagg *a2) {
+  if (!a1->real && !a2->real) {
+    return a1->vi64 > a2->vi64 ? 1 : a1->vi64 < a2->vi64 ? -1 : 0;
+  }
+  double v1 = a1->real ? a1->vf64 : (double) a1->vi64;
+  double v2 = a2->real ? a2->vf64 : (double) a2->vi64;
+  return v1 > v2 ? 1 : v1 < v2 ? -1 : 0;
+}
+
+// Accumulates either a single document value or partial state of the same group
+static void _jbi_group_agg_add(struct jbgagg *a, jqp_agg_op_t op, const struct jbgagg *v) {
+  if (!v->num) {
+    return;
+  }
+  int64_t sum;
+  switch (op) {
+    case JQP_AGG_SUM:
+    case JQP_AGG_AVG:
+      if (__builtin_add_overflow(a->vi64, v->vi64, &sum)) {
+        // Integer part overflown, continue accumulation as floating point
+        a->vf64 += (double) a->vi64 + (double) v->vi64;
+        a->vi64 = 0;
+        a->real = true;
+      } else {
+        a->vi64 = sum;
+      }
+      a->vf64 += v->vf64;
+      a->real |= v->real;
+      break;
+    case JQP_AGG_MIN:
+    case JQP_AGG_MAX:
+      if (!a->num || (_jbi_group_agg_cmp(v, a) * (op == JQP_AGG_MIN ? -1 : 1) > 0)) {
+        a->vi64 = v->vi64;
+        a->vf64 = v->vf64;
+        a->real = v->real;
+      }
+      break;
+  }
+  a->num += v->num;
+}
+
+static bool _jbi_group_agg_set(binn *bn, const char *path, jqp_agg_op_t op, const struct jbgagg *a) {
+  switch (op) {
+    case JQP_AGG_SUM:
+      if (a->real) {
+        return binn_object_set_double(bn, path, (double) a->vi64 + a->vf64);
+      }
+      return binn_object_set_int64(bn, path, a->vi64);
+    case JQP_AGG_AVG:
+      if (!a->num) {
+        return binn_object_set_null(bn, path);
+      }
+      return binn_object_set_double(bn, path, ((double) a->vi64 + a->vf64) / (double) a->num);
+    default:
+      if (!a->num) {
+        return binn_object_set_null(bn, path);
+      } else if (a->real) {
+        return binn_object_set_double(bn, path, a->vf64);
+      }
+      return binn_object_set_int64(bn, path, a->vi64);
+  }
+}
+
+static bool _jbi_group_key_set(binn *bn, const char *name, const struct jbgroup *g) {
+  int64_t llv;
+  switch (g->key[0]) {
+    case JBV_BOOL:
+      return binn_object_set_bool(bn, name, g->key[1]);
+    case JBV_I64:
+      memcpy(&llv, g->key + 1, sizeof(llv));
+      return binn_object_set_int64(bn, name, llv);
+    case JBV_F64:
+      return binn_object_set_double(bn, name, _jbi_group_key_f64(g));
+    case JBV_STR:
+      return binn_object_set_str(bn, name, (char*) g->key + 1);
+    default:
+      return binn_object_set_null(bn, name);
+  }
+}
+
+static iwrc _jbi_group_to_jbl(struct jbexec *ctx, const struct jbgroup *g, struct jbl **jblp) {
+  binn *obj = 0;
+  struct jbl *jbl;
+  struct jqp_aux *aux = ctx->ux->q->aux;
+  iwrc rc = jbl_create_empty_object(&jbl);
+  RCRET(rc);
+
+  if (aux->groupby_ptr && !_jbi_group_key_set(&jbl->bn, "key", g)) {
+    rc = JBL_ERROR_CREATION;
+    goto finish;
+  }
+  if (!(aux->qmode & JQP_QRY_DISTINCT) && !binn_object_set_int64(&jbl->bn, "count", g->cnt)) {
+    rc = JBL_ERROR_CREATION;
+    goto finish;
+  }
+  for (int op = JQP_AGG_SUM; op <= JQP_AGG_AVG; ++op) {
+    int i = 0;
+    for (struct jqp_aggregate *agg = aux->aggregates; agg; agg = agg->next, ++i) {
+      if (agg->op != op) {
+        continue;
+      }
+      if (!obj) {
+        RCB(finish, obj = binn_object());
+      }
+      if (!_jbi_group_agg_set(obj, agg->path, agg->op, &g->aggs[i])) {
+        rc = JBL_ERROR_CREATION;
+        goto finish;
+      }
+    }
+    if (obj) {
+      if (!binn_object_set_object(&jbl->bn, _jbi_group_ops[op], obj)) {
+        rc = JBL_ERROR_CREATION;
+        goto finish;
+      }
+      binn_free(obj);
+      obj = 0;
+    }
+  }
+
+finish:
+  if (obj) {
+    binn_free(obj);
+  }
+  if (rc) {
+    jbl_destroy(&jbl);
+  } else {
+    *jblp = jbl;
+  }
+  return rc;
+}
+
+static iwrc _jbi_group_init(struct jbgsc *gsc) {
+  gsc->map = iwhmap_create(_jbi_group_cmp, _jbi_group_hash, _jbi_group_kvfree);
+  if (!gsc->map) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  gsc->pool = iwpool_create(64 * 1024);
+  if (!gsc->pool) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  return 0;
+}
+
+static iwrc _jbi_group_clear(struct jbgsc *gsc) {
+  iwhmap_clear(gsc->map);
+  iwpool_destroy(gsc->pool);
+  gsc->last = 0;
+  gsc->size = 0;
+  gsc->pool = iwpool_create(64 * 1024);
+  if (!gsc->pool) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  return 0;
+}
+
+static void _jbi_group_release(struct jbexec *ctx) {
+  struct jbgsc *gsc = &ctx->gsc;
+  if (gsc->map) {
+    iwhmap_destroy(gsc->map);
+  }
+  if (gsc->pool) {
+    iwpool_destroy(gsc->pool);
+  }
+  if (gsc->sof_active) {
+    gsc->sof.close(&gsc->sof);
+  }
+  free(gsc->kbuf);
+  free(gsc->ikey);
+  memset(gsc, 0, sizeof(*gsc));
+}
+
+static iwrc _jbi_group_new(
+  struct jbexec   *ctx,
+  uint32_t         hash,
+  const uint8_t   *key,
+  uint32_t         ksz,
+  struct jbgroup **gp) {
+  struct jbgsc *gsc = &ctx->gsc;
+  struct jqp_aux *aux = ctx->ux->q->aux;
+  size_t asz = sizeof(struct jbgroup) + aux->aggregates_num * sizeof(struct jbgagg);
+  struct jbgroup *g = iwpool_calloc(asz + ksz, gsc->pool);
+  if (!g) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  g->hash = hash;
+  g->ksz = ksz;
+  g->key = (uint8_t*) g + asz;
+  memcpy(g->key, key, ksz);
+  iwrc rc = iwhmap_put(gsc->map, g, g);
+  RCRET(rc);
+  gsc->size += asz + ksz + JBI_GROUP_ENTRY_OVERHEAD;
+  *gp = g;
+  return 0;
+}
+
+static iwrc _jbi_group_get(struct jbexec *ctx, uint32_t ksz, struct jbgroup **gp) {
+  struct jbgsc *gsc = &ctx->gsc;
+  struct jbgroup *g = gsc->last;
+  if (g && (g->ksz == ksz) && !memcmp(g->key, gsc->kbuf, ksz)) {
+    *gp = g;
+    return 0;
+  }
+  struct jbgroup k = {
+    .hash = wyhash32(gsc->kbuf, ksz, 0),
+    .ksz  = ksz,
+    .key  = gsc->kbuf
+  };
+  g = iwhmap_get(gsc->map, &k);
+  if (!g) {
+    iwrc rc = _jbi_group_new(ctx, k.hash, gsc->kbuf, ksz, &g);
+    RCRET(rc);
+  }
+  gsc->last = g;
+  *gp = g;
+  return 0;
+}
+
+// Fills `gsc->kbuf` by group key of scalar value of type `t`
+static iwrc _jbi_group_key_fill(
+  struct jbgsc *gsc,
+  jbl_type_t    t,
+  int64_t       llv,
+  double        dv,
+  const char   *str,
+  size_t        len,
+  uint32_t     *kszp) {
+  size_t sz;
+  switch (t) {
+    case JBV_BOOL:
+      sz = 2;
+      break;
+    case JBV_F64:
+      // Integral numbers are grouped together regardless of JSON representation
+      if ((dv >= (double) INT64_MIN) && (dv < (double) INT64_MAX) && (dv == (double) (int64_t) dv)) {
+        t = JBV_I64;
+        llv = (int64_t) dv;
+      }
+      sz = 1 + sizeof(llv);
+      break;
+    case JBV_I64:
+      sz = 1 + sizeof(llv);
+      break;
+    default:
+      sz = 1 + len + 1;
+      break;
+  }
+  if (sz > gsc->kbuf_asz) {
+    size_t nsz = MAX(sz, 2 * gsc->kbuf_asz);
+    void *nbuf = realloc(gsc->kbuf, nsz);
+    if (!nbuf) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    gsc->kbuf = nbuf;
+    gsc->kbuf_asz = nsz;
+  }
+  gsc->kbuf[0] = t;
+  switch (t) {
+    case JBV_BOOL:
+      gsc->kbuf[1] = llv != 0;
+      break;
+    case JBV_I64:
+      memcpy(gsc->kbuf + 1, &llv, sizeof(llv));
+      break;
+    case JBV_F64:
+      memcpy(gsc->kbuf + 1, &dv, sizeof(dv));
+      break;
+    default:
+      memcpy(gsc->kbuf + 1, str, len);
+      gsc->kbuf[sz - 1] = '\0';
+      break;
+  }
+  *kszp = (uint32_t) sz;
+  return 0;
+}
+
+// Fills `gsc->kbuf` by group key of document value.
+// `*kszp` is set to zero if value is not a scalar.
+static iwrc _jbi_group_key(struct jbgsc *gsc, struct jbl *v, uint32_t *kszp) {
+  jbl_type_t t = jbl_type(v);
+  *kszp = 0;
+  switch (t) {
+    case JBV_BOOL:
+      return _jbi_group_key_fill(gsc, t, jbl_get_i32(v), 0, 0, 0, kszp);
+    case JBV_I64:
+      return _jbi_group_key_fill(gsc, t, jbl_get_i64(v), 0, 0, 0, kszp);
+    case JBV_F64:
+      return _jbi_group_key_fill(gsc, t, 0, jbl_get_f64(v), 0, 0, kszp);
+    case JBV_STR:
+      return _jbi_group_key_fill(gsc, t, 0, 0, jbl_get_str(v), jbl_size(v), kszp);
+    default:
+      return 0;
+  }
+}
+
+static iwrc _jbi_group_emit(struct jbexec *ctx, const struct jbgroup *g) {
+  iwrc rc = 0;
+  int64_t step = 1;
+  struct jbl *jbl = 0;
+  struct jbgsc *gsc = &ctx->gsc;
+  struct ejdb_exec *ux = ctx->ux;
+  struct jqp_aux *aux = ux->q->aux;
+
+  if (ux->skip > 0) {
+    --ux->skip;
+    return 0;
+  }
+  if (!(aux->qmode & JQP_QRY_AGGREGATE)) {
+    RCC(rc, finish, _jbi_group_to_jbl(ctx, g, &jbl));
+    struct ejdb_doc doc = {
+      .id  = gsc->num + 1,
+      .raw = jbl
+    };
+    do {
+      step = 1;
+      RCC(rc, finish, ux->visitor(ux, &doc, &step));
+    } while (step == -1);
+  }
+  ++gsc->num;
+  ++ux->cnt;
+  if (!step || (--ux->limit < 1)) {
+    gsc->stop = true;
+  } else if (step > 1) {
+    ux->skip += step - 1;
+  }
+
+finish:
+  jbl_destroy(&jbl);
+  return rc;
+}
+
+// Emits all groups kept in memory ordered by group key
+static iwrc _jbi_group_emit_all(struct jbexec *ctx) {
+  iwrc rc = 0;
+  uint32_t num = 0;
+  struct jbgsc *gsc = &ctx->gsc;
+  struct jbgroup **groups = 0;
+  struct iwhmap_iter iter;
+
+  if (!gsc->map || !(num = iwhmap_count(gsc->map))) {
+    return 0;
+  }
+  groups = malloc(num * sizeof(groups[0]));
+  if (!groups) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  num = 0;
+  iwhmap_iter_init(gsc->map, &iter);
+  while (iwhmap_iter_next(&iter)) {
+    groups[num++] = (void*) iter.val;
+  }
+  qsort(groups, num, sizeof(groups[0]), _jbi_group_key_cmp);
+  for (uint32_t i = 0; i < num && !gsc->stop; ++i) {
+    RCC(rc, finish, _jbi_group_emit(ctx, groups[i]));
+  }
+  rc = _jbi_group_clear(gsc);
+
+finish:
+  free(groups);
+  return rc;
+}
+
+static iwrc _jbi_group_spill_init(struct jbgsc *gsc) {
+  IWFS_EXT_OPTS opts = {
+    .initial_size = 1024 * 1024,
+    .rspolicy = iw_exfile_szpolicy_fibo,
+    .file = {
+      .path = "jb-",
+      .omode = IWFS_OTMP | IWFS_OUNLINK
+    }
+  };
+  iwrc rc = iwfs_exfile_open(&gsc->sof, &opts);
+  RCRET(rc);
+  rc = gsc->sof.add_mmap(&gsc->sof, 0, SIZE_T_MAX, 0);
+  if (rc) {
+    gsc->sof.close(&gsc->sof);
+  } else {
+    gsc->sof_active = true;
+  }
+  return rc;
+}
+
+// Moves all groups kept in memory into overflow file
+static iwrc _jbi_group_flush(struct jbexec *ctx) {
+  iwrc rc = 0;
+  size_t sp;
+  struct iwhmap_iter iter;
+  struct jbgsc *gsc = &ctx->gsc;
+  struct jqp_aux *aux = ctx->ux->q->aux;
+  size_t asz = aux->aggregates_num * sizeof(struct jbgagg);
+
+  if (!gsc->sof_active) {
+    RCRET(_jbi_group_spill_init(gsc));
+  }
+  iwhmap_iter_init(gsc->map, &iter);
+  while (iwhmap_iter_next(&iter)) {
+    const struct jbgroup *g = iter.val;
+    size_t rsz = JBI_GROUP_REC_HDR_SZ + asz + g->ksz;
+    if (rsz > gsc->kbuf_asz) { // Key buffer is reused as record buffer
+      void *nbuf = realloc(gsc->kbuf, rsz);
+      if (!nbuf) {
+        return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      }
+      gsc->kbuf = nbuf;
+      gsc->kbuf_asz = rsz;
+    }
+    uint8_t *wp = gsc->kbuf;
+    memcpy(wp, &g->hash, sizeof(g->hash));
+    wp += sizeof(g->hash);
+    memcpy(wp, &g->ksz, sizeof(g->ksz));
+    wp += sizeof(g->ksz);
+    memcpy(wp, &g->cnt, sizeof(g->cnt));
+    wp += sizeof(g->cnt);
+    memcpy(wp, g->aggs, asz);
+    wp += asz;
+    memcpy(wp, g->key, g->ksz);
+    RCRET(gsc->sof.write(&gsc->sof, gsc->sof_npos, gsc->kbuf, rsz, &sp));
+    gsc->sof_npos += rsz;
+  }
+  return _jbi_group_clear(gsc);
+}
+
+// Merges partial groups from overflow file and emits them.
+// Groups are processed by partitions of key hashes, so each pass holds only a part of groups in memory.
+static iwrc _jbi_group_merge(struct jbexec *ctx) {
+  size_t sp;
+  uint8_t *data;
+  struct jbgsc *gsc = &ctx->gsc;
+  struct jqp_aux *aux = ctx->ux->q->aux;
+  size_t asz = aux->aggregates_num * sizeof(struct jbgagg);
+  iwrc rc = _jbi_group_flush(ctx);
+  RCRET(rc);
+  RCRET(gsc->sof.probe_mmap(&gsc->sof, 0, &data, &sp));
+
+  off_t fsz = gsc->sof_npos;
+  uint32_t parts = 1 + (uint32_t) (2 * fsz / ctx->jbc->db->opts.sort_buffer_sz);
+
+  for (uint32_t p = 0; p < parts && !gsc->stop; ++p) {
+    for (off_t off = 0; off < fsz; ) {
+      struct jbgroup *g, k;
+      int64_t cnt;
+      const uint8_t *rp = data + off;
+      memcpy(&k.hash, rp, sizeof(k.hash));
+      rp += sizeof(k.hash);
+      memcpy(&k.ksz, rp, sizeof(k.ksz));
+      rp += sizeof(k.ksz);
+      memcpy(&cnt, rp, sizeof(cnt));
+      rp += sizeof(cnt);
+      k.key = (uint8_t*) rp + asz;
+      off += JBI_GROUP_REC_HDR_SZ + asz + k.ksz;
+      if (k.hash % parts != p) {
+        continue;
+      }
+      g = iwhmap_get(gsc->map, &k);
+      if (!g) {
+        RCRET(_jbi_group_new(ctx, k.hash, k.key, k.ksz, &g));
+      }
+      g->cnt += cnt;
+      int i = 0;
+      for (struct jqp_aggregate *agg = aux->aggregates; agg; agg = agg->next, ++i) {
+        struct jbgagg a;
+        memcpy(&a, rp + i * sizeof(a), sizeof(a));
+        _jbi_group_agg_add(&g->aggs[i], agg->op, &a);
+      }
+    }
+    RCRET(jbi_exec_check(ctx));
+    RCRET(_jbi_group_emit_all(ctx));
+  }
+  return 0;
+}
+
+// In presorted mode documents come in order of group key index,
+// so when index key changes all groups of previous key are complete.
+static iwrc _jbi_group_presorted_check(struct jbexec *ctx, struct jbl *v) {
+  char numbuf[IWNUMBUF_SIZE];
+  struct iwkv_val ikey;
+  struct jbgsc *gsc = &ctx->gsc;
+
+  jbi_jbl_fill_ikey(ctx->midx.idx, v, &ikey, numbuf);
+  if (gsc->ikey && (ikey.size == gsc->ikey_sz) && !memcmp(ikey.data, gsc->ikey, ikey.size)) {
+    return 0;
+  }
+  iwrc rc = _jbi_group_emit_all(ctx);
+  RCRET(rc);
+  if (!gsc->ikey || (ikey.size > gsc->ikey_asz)) {
+    size_t nsz = MAX(ikey.size, 64);
+    void *nbuf = realloc(gsc->ikey, nsz);
+    if (!nbuf) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    gsc->ikey = nbuf;
+    gsc->ikey_asz = nsz;
+  }
+  memcpy(gsc->ikey, ikey.data, ikey.size);
+  gsc->ikey_sz = ikey.size;
+  return 0;
+}
+
+static iwrc _jbi_group_add(struct jbexec *ctx, struct jbl *jbl, int64_t *step) {
+  iwrc rc = 0;
+  uint32_t ksz = 0;
+  struct jbgroup *g;
+  struct jbgsc *gsc = &ctx->gsc;
+  struct jqp_aux *aux = ctx->ux->q->aux;
+
+  if (!gsc->map) {
+    RCRET(_jbi_group_init(gsc));
+  }
+  if (aux->groupby_ptr) {
+    struct jbl v = { 0 };
+    _jbl_at(jbl, aux->groupby_ptr, &v);
+    RCRET(_jbi_group_key(gsc, &v, &ksz));
+    if (!ksz) { // No scalar value at group path
+      return 0;
+    }
+    if (gsc->presorted) {
+      RCRET(_jbi_group_presorted_check(ctx, &v));
+      if (gsc->stop) {
+        *step = 0;
+        return 0;
+      }
+    }
+  }
+  RCRET(_jbi_group_get(ctx, ksz, &g));
+  ++g->cnt;
+
+  int i = 0;
+  for (struct jqp_aggregate *agg = aux->aggregates; agg; agg = agg->next, ++i) {
+    struct jbl v = { 0 };
+    struct jbgagg a = { .num = 1 };
+    _jbl_at(jbl, agg->ptr, &v);
+    switch (jbl_type(&v)) {
+      case JBV_I64:
+        a.vi64 = jbl_get_i64(&v);
+        break;
+      case JBV_F64:
+        a.vf64 = jbl_get_f64(&v);
+        a.real = true;
+        break;
+      default:
+        continue; // Only numbers are aggregated
+    }
+    _jbi_group_agg_add(&g->aggs[i], agg->op, &a);
+  }
+
+  if (!gsc->presorted && (gsc->size > ctx->jbc->db->opts.sort_buffer_sz)) {
+    rc = _jbi_group_flush(ctx);
+    RCRET(rc);
+    ctx->spilled = true;
+    JB_METRIC_ADD(ctx->jbc->db->metrics.group_spills, 1);
+  }
+  return rc;
+}
+
+static iwrc _jbi_group_finish(struct jbexec *ctx) {
+  iwrc rc = 0;
+  struct jbgroup *g;
+  struct jbgsc *gsc = &ctx->gsc;
+  struct jqp_aux *aux = ctx->ux->q->aux;
+
+  if (!gsc->map && !aux->groupby_ptr) {
+    // Aggregates over empty set are reported as well
+    RCC(rc, finish, _jbi_group_init(gsc));
+    RCC(rc, finish, _jbi_group_get(ctx, 0, &g));
+  }
+  if (gsc->sof_active) {
+    rc = _jbi_group_merge(ctx);
+  } else {
+    rc = _jbi_group_emit_all(ctx);
+  }
+
+finish:
+  _jbi_group_release(ctx);
+  return rc;
+}
+
+iwrc jbi_group_consumer(
+  struct jbexec *ctx, IWKV_cursor cur, int64_t id,
+  int64_t *step, bool *matched, iwrc err) {
+  if (!id) {
+    // End of scan
+    if (err) {
+      _jbi_group_release(ctx);
+      return err;
+    } else {
+      return _jbi_group_finish(ctx);
+    }
+  }
+
+  size_t vsz = 0;
+  struct jbl jbl;
+  iwrc rc = jbi_exec_check(ctx);
+  RCRET(rc);
+
+start:
+  {
+    if (cur) {
+      rc = iwkv_cursor_copy_val(cur, ctx->jblbuf, ctx->jblbufsz, &vsz);
+    } else {
+      IWKV_val key = {
+        .data = &id,
+        .size = sizeof(id)
+      };
+      rc = iwkv_get_copy(ctx->jbc->cdb, &key, ctx->jblbuf, ctx->jblbufsz, &vsz);
+    }
+    if (rc == IWKV_ERROR_NOTFOUND) {
+      return 0;
+    }
+    RCRET(rc);
+    if (vsz > ctx->jblbufsz) {
+      size_t nsize = MAX(vsz, ctx->jblbufsz * 2);
+      void *nbuf = realloc(ctx->jblbuf, nsize);
+      if (!nbuf) {
+        return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      }
+      ctx->jblbuf = nbuf;
+      ctx->jblbufsz = nsize;
+      goto start;
+    }
+  }
+
+  rc = jbl_from_buf_keep_onstack(&jbl, ctx->jblbuf, vsz);
+  RCRET(rc);
+
+  rc = jql_matched(ctx->ux->q, &jbl, matched);
+  ++ctx->scanned;
+  if (rc || !*matched) {
+    return rc;
+  }
+  ++ctx->matched;
+  return _jbi_group_add(ctx, &jbl, step);
+}
+
+// Reads current index key into `gsc->ikey`, one byte is reserved for terminating zero
+static iwrc _jbi_distinct_ikey(struct jbgsc *gsc, IWKV_cursor cur) {
+  size_t sz;
+  iwrc rc = iwkv_cursor_copy_key(cur, gsc->ikey, gsc->ikey_asz ? gsc->ikey_asz - 1 : 0, &sz, 0);
+  RCRET(rc);
+  if (sz + 1 > gsc->ikey_asz) {
+    size_t nsz = MAX(sz + 1, 64);
+    void *nbuf = realloc(gsc->ikey, nsz);
+    if (!nbuf) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    gsc->ikey = nbuf;
+    gsc->ikey_asz = nsz;
+    RCRET(iwkv_cursor_copy_key(cur, gsc->ikey, sz, &sz, 0));
+  }
+  gsc->ikey_sz = sz;
+  return 0;
+}
+
+static iwrc _jbi_distinct_key(struct jbexec *ctx, uint32_t *kszp) {
+  JQVAL jqv;
+  struct jbgsc *gsc = &ctx->gsc;
+  iwrc rc = jbi_ikey_to_jqval(ctx->midx.idx, (char*) gsc->ikey, gsc->ikey_sz, &jqv);
+  RCRET(rc);
+  switch (jqv.type) {
+    case JQVAL_I64:
+      return _jbi_group_key_fill(gsc, JBV_I64, jqv.vi64, 0, 0, 0, kszp);
+    case JQVAL_F64:
+      return _jbi_group_key_fill(gsc, JBV_F64, 0, jqv.vf64, 0, 0, kszp);
+    default:
+      return _jbi_group_key_fill(gsc, JBV_STR, 0, 0, jqv.vstr, strlen(jqv.vstr), kszp);
+  }
+}
+
+// Index only scanner of `distinct` and `group` queries without aggregates.
+// Walks index keys in ascending order: in `distinct` mode cursor jumps over all
+// duplicates of a key by positioning at `(key, INT64_MAX)` compound,
+// in `group` mode duplicates are counted. Collection documents are not fetched.
+iwrc jbi_distinct_scanner(struct jbexec *ctx, jb_scan_consumer consumer) {
+  int64_t id;
+  bool matched;
+  uint32_t ksz;
+  IWKV_cursor cur = 0;
+  struct jbgsc *gsc = &ctx->gsc;
+  struct jbidx *idx = ctx->midx.idx;
+  struct jqp_aux *aux = ctx->ux->q->aux;
+  bool compound = (idx->idbf & IWDB_COMPOUND_KEYS) != 0;
+
+  iwrc crc, rc = iwkv_cursor_open(idx->idb, &cur, IWKV_CURSOR_AFTER_LAST, 0);
+  RCGO(rc, finish);
+  crc = iwkv_cursor_to(cur, IWKV_CURSOR_PREV);
+
+  while (!crc && !gsc->stop) {
+    RCC(rc, finish, jbi_exec_check(ctx));
+    RCC(rc, finish, _jbi_distinct_ikey(gsc, cur));
+    RCC(rc, finish, _jbi_distinct_key(ctx, &ksz));
+
+    struct jbgroup g = {
+      .ksz = ksz,
+      .key = gsc->kbuf,
+      .cnt = 1
+    };
+    IWKV_val ikey = {
+      .data     = gsc->ikey,
+      .size     = gsc->ikey_sz,
+      .compound = INT64_MAX
+    };
+    if (compound && (aux->qmode & JQP_QRY_DISTINCT)) {
+      crc = iwkv_cursor_to_key(cur, IWKV_CURSOR_GE, &ikey);
+    } else {
+      crc = iwkv_cursor_to(cur, IWKV_CURSOR_PREV);
+    }
+    while (compound && !crc) { // Count duplicates of the key
+      crc = iwkv_cursor_is_matched_key(cur, &ikey, &matched, &id);
+      if (crc || !matched) {
+        break;
+      }
+      ++g.cnt;
+      crc = iwkv_cursor_to(cur, IWKV_CURSOR_PREV);
+    }
+    if (crc && (crc != IWKV_ERROR_NOTFOUND)) {
+      rc = crc;
+      goto finish;
+    }
+    RCC(rc, finish, _jbi_group_emit(ctx, &g));
+  }
+
+finish:
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    rc = 0;
+  }
+  if (cur) {
+    iwkv_cursor_close(&cur);
+  }
+  return consumer(ctx, 0, 0, 0, 0, rc);
+}
@@ -1,10 +1,17 @@
 #include "ejdb2_internal.h"
 
+static int _jbi_pk_cmp(const void *v1, const void *v2) {
+  int64_t id1 = *(const int64_t*) v1;
+  int64_t id2 = *(const int64_t*) v2;
+  return id1 > id2 ? 1 : id1 < id2 ? -1 : 0;
+}
+
 // Primary key scanner
 iwrc jbi_pk_scanner(struct jbexec *ctx, jb_scan_consumer consumer) {
   iwrc rc = 0;
-  int64_t id, step;
+  int64_t id, step, dir = 1, *ids = 0;
   bool matched;
+  IWKV_cursor cur = 0;
   struct jqp_aux *aux = ctx->ux->q->aux;
   assert(aux->expr->flags & JQP_EXPR_NODE_FLAG_PK);
   JQP_EXPR_NODE_PK *pk = (void*) aux->expr;
@@ -14,30 +21,69 @@ iwrc jbi_pk_scanner(struct jbexec *ctx, jb_scan_consumer consumer) {
 
   if ((jqvp->type == JQVAL_JBLNODE) && (jqvp->vnode->type == JBV_ARRAY)) {
     JQVAL jqv;
-    JBL_NODE nv = jqvp->vnode->child;
-    if (!nv) {
+    int64_t i = 0, num = 0;
+    for (JBL_NODE nv = jqvp->vnode->child; nv; nv = nv->next) {
+      ++num;
+    }
+    if (!num) {
       goto finish;
     }
-    step = 1;
-    do {
+    ids = malloc(num * sizeof(ids[0]));
+    if (!ids) {
+      rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      goto finish;
+    }
+    num = 0;
+    for (JBL_NODE nv = jqvp->vnode->child; nv; nv = nv->next) {
       jql_node_to_jqval(nv, &jqv);
       if (jql_jqval_as_int(&jqv, &id)) {
-        if (step > 0) {
-          --step;
-        } else if (step < 0) {
-          ++step;
+        ids[num++] = id;
+      }
+    }
+    if (!num) {
+      goto finish;
+    }
+    // Documents are fetched by single cursor in the order given by user.
+    // Ascending keys order is used if results are reordered or just counted anyway.
+    if (aux->orderby_num || ctx->grouping || (aux->qmode & JQP_QRY_COUNT)) {
+      qsort(ids, num, sizeof(ids[0]), _jbi_pk_cmp);
+    }
+    RCC(rc, finish, iwkv_cursor_open(ctx->jbc->cdb, &cur, IWKV_CURSOR_BEFORE_FIRST, 0));
+
+    step = 1;
+    do {
+      if (step > 0) {
+        --step;
+      } else if (step < 0) {
+        ++step;
+      }
+      if (!step) {
+        struct iwkv_val key = {
+          .data = &ids[i],
+          .size = sizeof(ids[i])
+        };
+        step = dir; // Missing ids are skipped in the current scan direction
+        rc = iwkv_cursor_to_key(cur, IWKV_CURSOR_EQ, &key);
+        if (rc == IWKV_ERROR_NOTFOUND) {
+          rc = 0;
+          continue;
         }
-        if (!step) {
-          step = 1;
-          rc = consumer(ctx, 0, id, &step, &matched, 0);
-          RCGO(rc, finish);
+        RCGO(rc, finish);
+        rc = consumer(ctx, cur, ids[i], &step, &matched, 0);
+        RCGO(rc, finish);
+        if (step) {
+          dir = step > 0 ? 1 : -1;
         }
       }
-    } while (step && (step > 0 ? (nv = nv->next) : (nv = nv->prev)));
+    } while (step && (step > 0 ? ++i < num : --i >= 0));
   } else if (jql_jqval_as_int(jqvp, &id)) {
     rc = consumer(ctx, 0, id, &step, &matched, 0);
   }
 
 finish:
+  if (cur) {
+    iwkv_cursor_close(&cur);
+  }
+  free(ids);
   return consumer(ctx, 0, 0, 0, 0, rc);
 }
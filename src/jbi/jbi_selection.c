@@ -27,6 +27,12 @@ static void _jbi_print_index(struct jbidx *idx, IWXSTR *xstr) {
     }
     iwxstr_cat2(xstr, "F64");
   }
+  if (m & EJDB_IDX_FTS) {
+    if (cnt++) {
+      iwxstr_cat2(xstr, "|");
+    }
+    iwxstr_cat2(xstr, "FTS");
+  }
   if (cnt++) {
     iwxstr_cat2(xstr, "|");
   }
@@ -89,7 +95,8 @@ IW_INLINE int _jbi_idx_expr_op_weight(struct jbmidx *midx) {
     case JQP_OP_EQ:
       return 10;
     case JQP_OP_IN:
-      //case JQP_OP_NI: todo
+    //case JQP_OP_NI: todo
+    case JQP_OP_MATCH:
       return 9;
     default:
       break;
@@ -144,6 +151,16 @@ static iwrc _jbi_compute_index_rules(JBEXEC *ctx, struct jbmidx *mctx) {
     if (expr->left->type != JQP_STRING_TYPE) {
       continue;
     }
+    if (mctx->idx->mode & EJDB_IDX_FTS) { // Full-text index is applicable only for `match`
+      if ((op == JQP_OP_MATCH) && ((rv->type == JQVAL_STR) || (rv->type == JQVAL_JBLNODE))) {
+        mctx->cursor_init = IWKV_CURSOR_EQ;
+        mctx->expr1 = expr;
+        mctx->expr2 = 0;
+        mctx->orderby_support = false;
+        return 0;
+      }
+      continue;
+    }
     switch (rv->type) {
       case JQVAL_NULL:
       case JQVAL_RE:
@@ -388,13 +405,36 @@ static int _jbi_idx_cmp(const void *o1, const void *o2) {
   return (d1->idx->ptr->cnt - d2->idx->ptr->cnt);
 }
 
+// Checks if query filter consists only of index expressions of selected index
+static bool _jbi_is_covered_filter(struct jqp_aux *aux, struct jbmidx *midx) {
+  struct jqp_expr_node *en = aux->expr;
+  if (  (en->type != JQP_EXPR_NODE_TYPE)
+     || (en->chain != (struct jqp_expr_node*) midx->filter)
+     || en->chain->next
+     || (en->chain->join && en->chain->join->negate)) {
+    return false;
+  }
+  int i = 1;
+  JQP_NODE *n = midx->filter->node;
+  for ( ; n && i < midx->idx->ptr->cnt; n = n->next, ++i);
+  if (!n || n->next || (n->ntype != JQP_NODE_EXPR) || (&n->value->expr != midx->nexpr)) {
+    return false;
+  }
+  for (JQP_EXPR *expr = midx->nexpr; expr; expr = expr->next) {
+    if ((expr != midx->expr1) && (expr != midx->expr2)) {
+      return false;
+    }
+  }
+  return midx->expr1->op->value != JQP_OP_MATCH;
+}
+
 static struct jbidx* _jbi_select_index_for_orderby(JBEXEC *ctx) {
   struct jqp_aux *aux = ctx->ux->q->aux;
   struct jbl_ptr *obp = aux->orderby_ptrs[0];
   assert(obp);
   for (struct jbidx *idx = ctx->jbc->idx; idx; idx = idx->next) {
     struct jbl_ptr *ptr = idx->ptr;
-    if (obp->cnt != ptr->cnt) {
+    if ((obp->cnt != ptr->cnt) || (idx->mode & EJDB_IDX_FTS)) {
       continue;
     }
     int i = 0;
@@ -416,6 +456,55 @@ static struct jbidx* _jbi_select_index_for_orderby(JBEXEC *ctx) {
   return 0;
 }
 
+IW_INLINE bool _jbi_ptr_eq(const struct jbl_ptr *p1, const struct jbl_ptr *p2) {
+  if (p1->cnt != p2->cnt) {
+    return false;
+  }
+  for (int i = 0; i < p1->cnt; ++i) {
+    if (strcmp(p1->n[i], p2->n[i])) {
+      return false;
+    }
+  }
+  return true;
+}
+
+// Returns true if query filter matches any document: `/*` or `/**`
+static bool _jbi_is_match_all(const struct jqp_expr_node *en) {
+  if (en->next || (en->join && en->join->negate)) {
+    return false;
+  }
+  if (en->type == JQP_EXPR_NODE_TYPE) {
+    return en->chain && _jbi_is_match_all(en->chain);
+  } else if (en->type == JQP_FILTER_TYPE) {
+    const JQP_NODE *n = ((const JQP_FILTER*) en)->node; // -V1027
+    return n && !n->next && ((n->ntype == JQP_NODE_ANY) || (n->ntype == JQP_NODE_ANYS));
+  }
+  return false;
+}
+
+// Full scan of numeric index over group key returns documents clustered by group key,
+// so groups are complete as soon as index key is changed.
+// String indexes are not used since documents with empty strings are not indexed.
+//
+// With `indexonly` option distinct values of all documents (no filter and aggregates)
+// are read from index of any type, values are reported in the form stored in index.
+static struct jbidx* _jbi_select_index_for_groupby(JBEXEC *ctx) {
+  struct jqp_aux *aux = ctx->ux->q->aux;
+  bool index_only = (aux->qmode & JQP_QRY_INDEXONLY) && !aux->aggregates && _jbi_is_match_all(aux->expr);
+  ejdb_idx_mode_t modes = index_only ? (EJDB_IDX_STR | EJDB_IDX_I64 | EJDB_IDX_F64) : (EJDB_IDX_I64 | EJDB_IDX_F64);
+  for (struct jbidx *idx = ctx->jbc->idx; idx; idx = idx->next) {
+    if ((idx->mode & modes) && _jbi_ptr_eq(idx->ptr, aux->groupby_ptr)) {
+      ctx->gsc.index_only = index_only;
+      memset(&ctx->midx, 0, sizeof(ctx->midx));
+      ctx->midx.idx = idx;
+      ctx->midx.cursor_init = ctx->cursor_init;
+      ctx->midx.cursor_step = ctx->cursor_step;
+      return idx;
+    }
+  }
+  return 0;
+}
+
 iwrc jbi_selection(JBEXEC *ctx) {
   iwrc rc = 0;
   size_t snp = 0;
@@ -444,6 +533,7 @@ iwrc jbi_selection(JBEXEC *ctx) {
       if ((op == JQP_OP_EQ) || (op == JQP_OP_IN) || ((op == JQP_OP_GTE) && (ctx->cursor_init == IWKV_CURSOR_GE))) {
         midx->expr1->prematched = true;
       }
+      midx->covered = _jbi_is_covered_filter(aux, midx);
       if (ctx->ux->log) {
         iwxstr_cat2(ctx->ux->log, "[INDEX] SELECTED ");
         _jbi_log_index_rules(ctx->ux->log, &ctx->midx);
@@ -459,7 +549,16 @@ iwrc jbi_selection(JBEXEC *ctx) {
         iwxstr_cat2(ctx->ux->log, "[INDEX] SELECTED ");
         _jbi_log_index_rules(ctx->ux->log, &ctx->midx);
       }
+    } else if (ctx->grouping && aux->groupby_ptr) {
+      if (_jbi_select_index_for_groupby(ctx) && ctx->ux->log) {
+        iwxstr_cat2(ctx->ux->log, ctx->gsc.index_only ? "[INDEX] DISTINCT " : "[INDEX] SELECTED ");
+        _jbi_log_index_rules(ctx->ux->log, &ctx->midx);
+      }
     }
   }
+  if (  ctx->grouping && aux->groupby_ptr && ctx->midx.idx
+     && !(ctx->midx.idx->mode & EJDB_IDX_FTS) && _jbi_ptr_eq(ctx->midx.idx->ptr, aux->groupby_ptr)) {
+    ctx->gsc.presorted = true;
+  }
   return rc;
 }
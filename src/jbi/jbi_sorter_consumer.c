@@ -103,6 +103,7 @@ static iwrc _jbi_scan_sorter_do(struct jbexec *ctx) {
   }
 
   for (int64_t i = ux->skip; step && i < rnum && i >= 0; ) {
+    RCC(rc, finish, jbi_exec_check(ctx));
     uint8_t *rp = ssc->docs + ssc->refs[i];
     memcpy(&id, rp, sizeof(id));
     rp += sizeof(id);
@@ -184,12 +185,13 @@ iwrc jbi_sorter_consumer(
     }
   }
 
-  iwrc rc;
   size_t vsz = 0;
   struct jbl jbl;
   struct jbssc *ssc = &ctx->ssc;
   EJDB db = ctx->jbc->db;
   IWFS_EXT *sof = &ssc->sof;
+  iwrc rc = jbi_exec_check(ctx);
+  RCRET(rc);
 
 start:
   {
@@ -223,9 +225,11 @@ start:
   RCRET(rc);
 
   rc = jql_matched(ctx->ux->q, &jbl, matched);
+  ++ctx->scanned;
   if (!*matched) {
     return 0;
   }
+  ++ctx->matched;
 
   if (!ssc->refs) {
     ssc->refs_asz = db->opts.document_buffer_sz;
@@ -265,6 +269,8 @@ start2:
           free(ssc->docs);
           ssc->docs = 0;
           ssc->sof_active = true;
+          ctx->spilled = true;
+          JB_METRIC_ADD(db->metrics.sorter_spills, 1);
           goto start2;
         } else {
           void *nbuf = realloc(ssc->docs, ssc->docs_asz);
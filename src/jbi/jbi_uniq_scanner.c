@@ -28,6 +28,21 @@ static iwrc _jbi_consume_eq(struct jbexec *ctx, JQVAL *jqval, jb_scan_consumer c
   return consumer(ctx, 0, 0, 0, 0, rc);
 }
 
+// Returns true if index key of IN list node `nv` is the same as key of one of preceding nodes
+static bool _jbi_in_key_repeated(JBIDX idx, JBL_NODE first, JBL_NODE nv, const IWKV_val *key) {
+  JQVAL jqv;
+  IWKV_val pkey;
+  char numbuf[IWNUMBUF_SIZE];
+  for (JBL_NODE pn = first; pn && pn != nv; pn = pn->next) {
+    jql_node_to_jqval(pn, &jqv);
+    jbi_jqval_fill_ikey(idx, &jqv, &pkey, numbuf);
+    if ((pkey.size == key->size) && !memcmp(pkey.data, key->data, key->size)) {
+      return true;
+    }
+  }
+  return false;
+}
+
 static iwrc _jbi_consume_in_node(struct jbexec *ctx, JQVAL *jqval, jb_scan_consumer consumer) {
   JQVAL jqv;
   size_t sz;
@@ -47,8 +62,8 @@ static iwrc _jbi_consume_in_node(struct jbexec *ctx, JQVAL *jqval, jb_scan_consu
   do {
     jql_node_to_jqval(nv, &jqv);
     jbi_jqval_fill_ikey(midx->idx, &jqv, &key, numbuf);
-    if (!key.size) {
-      continue;
+    if (!key.size || _jbi_in_key_repeated(midx->idx, jqval->vnode->child, nv, &key)) {
+      continue; // Document of repeated key is already visited
     }
     rc = iwkv_get_copy(midx->idx->idb, &key, numbuf, sizeof(numbuf), &sz);
     if (rc) {
@@ -77,7 +92,7 @@ finish:
 
 static iwrc _jbi_consume_scan(struct jbexec *ctx, JQVAL *jqval, jb_scan_consumer consumer) {
   size_t sz;
-  IWKV_cursor cur;
+  IWKV_cursor cur = 0;
   char numbuf[IWNUMBUF_SIZE];
 
   int64_t step = 1;
@@ -88,7 +103,13 @@ static iwrc _jbi_consume_scan(struct jbexec *ctx, JQVAL *jqval, jb_scan_consumer
   IWKV_val key;
   jbi_jqval_fill_ikey(idx, jqval, &key, numbuf);
 
-  iwrc rc = iwkv_cursor_open(idx->idb, &cur, midx->cursor_init, &key);
+  iwrc rc;
+  if (ctx->ux->resume && iwxstr_size(ctx->ux->resume)) {
+    RCC(rc, finish, jbi_resume_cursor_open(ctx, midx->cursor_step, &cur, &step));
+    goto start;
+  }
+
+  rc = iwkv_cursor_open(idx->idb, &cur, midx->cursor_init, &key);
   if ((rc == IWKV_ERROR_NOTFOUND) && ((expr1_op == JQP_OP_LT) || (expr1_op == JQP_OP_LTE))) {
     iwkv_cursor_close(&cur);
     midx->cursor_init = IWKV_CURSOR_BEFORE_FIRST;
@@ -101,12 +122,14 @@ static iwrc _jbi_consume_scan(struct jbexec *ctx, JQVAL *jqval, jb_scan_consumer
     goto finish;
   }
 
-  IWKV_cursor_op cursor_reverse_step = (midx->cursor_step == IWKV_CURSOR_NEXT)
-                                       ? IWKV_CURSOR_PREV : IWKV_CURSOR_NEXT;
-
   if (midx->cursor_init < IWKV_CURSOR_NEXT) { // IWKV_CURSOR_BEFORE_FIRST || IWKV_CURSOR_AFTER_LAST
     RCC(rc, finish, iwkv_cursor_to(cur, midx->cursor_step));
   }
+
+start:
+  ctx->icur = cur;
+  IWKV_cursor_op cursor_reverse_step = (midx->cursor_step == IWKV_CURSOR_NEXT)
+                                       ? IWKV_CURSOR_PREV : IWKV_CURSOR_NEXT;
   do {
     if (step > 0) {
       --step;
@@ -148,6 +171,7 @@ finish:
     rc = 0;
   }
   if (cur) {
+    ctx->icur = 0;
     iwkv_cursor_close(&cur);
   }
   return consumer(ctx, 0, 0, 0, 0, rc);
@@ -156,17 +180,22 @@ finish:
 iwrc _jbi_consume_noxpr_scan(struct jbexec *ctx, jb_scan_consumer consumer) {
   iwrc rc;
   size_t sz;
-  IWKV_cursor cur;
+  IWKV_cursor cur = 0;
   char numbuf[IWNUMBUF_SIZE];
   int64_t step = 1;
   struct jbmidx *midx = &ctx->midx;
   IWKV_cursor_op cursor_reverse_step = (midx->cursor_step == IWKV_CURSOR_NEXT)
                                        ? IWKV_CURSOR_PREV : IWKV_CURSOR_NEXT;
 
-  RCC(rc, finish, iwkv_cursor_open(midx->idx->idb, &cur, midx->cursor_init, 0));
-  if (midx->cursor_init < IWKV_CURSOR_NEXT) { // IWKV_CURSOR_BEFORE_FIRST || IWKV_CURSOR_AFTER_LAST
-    RCC(rc, finish, iwkv_cursor_to(cur, midx->cursor_step));
+  if (ctx->ux->resume && iwxstr_size(ctx->ux->resume)) {
+    RCC(rc, finish, jbi_resume_cursor_open(ctx, midx->cursor_step, &cur, &step));
+  } else {
+    RCC(rc, finish, iwkv_cursor_open(midx->idx->idb, &cur, midx->cursor_init, 0));
+    if (midx->cursor_init < IWKV_CURSOR_NEXT) { // IWKV_CURSOR_BEFORE_FIRST || IWKV_CURSOR_AFTER_LAST
+      RCC(rc, finish, iwkv_cursor_to(cur, midx->cursor_step));
+    }
   }
+  ctx->icur = cur;
   do {
     if (step > 0) {
       --step;
@@ -194,6 +223,7 @@ finish:
     rc = 0;
   }
   if (cur) {
+    ctx->icur = 0;
     iwkv_cursor_close(&cur);
   }
   return consumer(ctx, 0, 0, 0, 0, rc);
@@ -1,8 +1,45 @@
 #include "ejdb2_internal.h"
 #include <iowow/iwutils.h>
+#include <iowow/iwp.h>
 
 // ---------------------------------------------------------------------------
 
+// Order preserving binary form of double: big-endian IEEE754 bits where
+// the sign bit is flipped for positive values and all bits are inverted for negative ones.
+static void _jbi_f64_encode(double v, char out[static sizeof(uint64_t)]) {
+  uint64_t u;
+  if (v == 0.0) { // -V550
+    v = 0.0; // Same key for -0.0 and 0.0
+  }
+  memcpy(&u, &v, sizeof(u));
+  u = (u & 0x8000000000000000ULL) ? ~u : (u | 0x8000000000000000ULL);
+  for (int i = (int) sizeof(u) - 1; i >= 0; --i) {
+    out[i] = (char) (u & 0xffU);
+    u >>= 8;
+  }
+}
+
+static double _jbi_f64_decode(const char in[static sizeof(uint64_t)]) {
+  double v;
+  uint64_t u = 0;
+  for (int i = 0; i < (int) sizeof(u); ++i) {
+    u = (u << 8) | (uint8_t) in[i];
+  }
+  u = (u & 0x8000000000000000ULL) ? (u & ~0x8000000000000000ULL) : ~u;
+  memcpy(&v, &u, sizeof(v));
+  return v;
+}
+
+static void _jbi_f64_fill_ikey(JBIDX idx, double v, IWKV_val *ikey, char numbuf[static IWNUMBUF_SIZE]) {
+  ikey->data = numbuf;
+  if (JBI_IDX_F64_TEXT_KEYS(idx)) {
+    iwjson_ftoa(v, numbuf, &ikey->size);
+  } else {
+    _jbi_f64_encode(v, numbuf);
+    ikey->size = sizeof(uint64_t);
+  }
+}
+
 // fixme: code duplication below
 void jbi_jbl_fill_ikey(JBIDX idx, JBL jbv, IWKV_val *ikey, char numbuf[static IWNUMBUF_SIZE]) {
   int64_t *llv = (void*) numbuf;
@@ -63,10 +100,10 @@ void jbi_jbl_fill_ikey(JBIDX idx, JBL jbv, IWKV_val *ikey, char numbuf[static IW
         case JBV_F64:
         case JBV_I64:
         case JBV_BOOL:
-          iwjson_ftoa(jbl_get_f64(jbv), numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, jbl_get_f64(jbv), ikey, numbuf);
           break;
         case JBV_STR:
-          iwjson_ftoa(iwatof(jbl_get_str(jbv)), numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, iwatof(jbl_get_str(jbv)), ikey, numbuf);
           break;
         default:
           ikey->size = 0; // -V1048
@@ -135,16 +172,16 @@ void jbi_jqval_fill_ikey(JBIDX idx, const JQVAL *jqval, IWKV_val *ikey, char num
     case EJDB_IDX_F64:
       switch (jqvt) {
         case JQVAL_F64:
-          iwjson_ftoa(jqval->vf64, numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, jqval->vf64, ikey, numbuf);
           break;
         case JQVAL_I64:
-          iwjson_ftoa(jqval->vi64, numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, (double) jqval->vi64, ikey, numbuf);
           break;
         case JQVAL_BOOL:
-          iwjson_ftoa(jqval->vbool, numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, jqval->vbool, ikey, numbuf);
           break;
         case JQVAL_STR:
-          iwjson_ftoa(iwatof(jqval->vstr), numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, iwatof(jqval->vstr), ikey, numbuf);
           break;
         default:
           ikey->data = 0;
@@ -213,16 +250,16 @@ void jbi_node_fill_ikey(JBIDX idx, JBL_NODE node, IWKV_val *ikey, char numbuf[st
     case EJDB_IDX_F64:
       switch (jbvt) {
         case JBV_F64:
-          iwjson_ftoa(node->vf64, numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, node->vf64, ikey, numbuf);
           break;
         case JBV_I64:
-          iwjson_ftoa(node->vi64, numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, (double) node->vi64, ikey, numbuf);
           break;
         case JBV_BOOL:
-          iwjson_ftoa(node->vbool, numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, node->vbool, ikey, numbuf);
           break;
         case JBV_STR:
-          iwjson_ftoa(iwatof(node->vptr), numbuf, &ikey->size);
+          _jbi_f64_fill_ikey(idx, iwatof(node->vptr), ikey, numbuf);
           break;
         default:
           ikey->data = 0;
@@ -234,6 +271,30 @@ void jbi_node_fill_ikey(JBIDX idx, JBL_NODE node, IWKV_val *ikey, char numbuf[st
   }
 }
 
+iwrc jbi_ikey_to_jqval(JBIDX idx, char *kbuf, size_t sz, JQVAL *jqval) {
+  if (idx->mode & EJDB_IDX_STR) {
+    kbuf[sz] = '\0';
+    jqval->type = JQVAL_STR;
+    jqval->vstr = kbuf;
+  } else if (idx->mode & EJDB_IDX_I64) {
+    memcpy(&jqval->vi64, kbuf, sizeof(jqval->vi64));
+    jqval->type = JQVAL_I64;
+  } else if (idx->mode & EJDB_IDX_F64) {
+    jqval->type = JQVAL_F64;
+    if (JBI_IDX_F64_TEXT_KEYS(idx)) {
+      kbuf[sz] = '\0';
+      jqval->vf64 = (double) iwatof(kbuf);
+    } else if (sz == sizeof(uint64_t)) {
+      jqval->vf64 = _jbi_f64_decode(kbuf);
+    } else {
+      return IW_ERROR_INVALID_STATE;
+    }
+  } else {
+    return IW_ERROR_INVALID_STATE;
+  }
+  return 0;
+}
+
 bool jbi_node_expr_matched(JQP_AUX *aux, JBIDX idx, IWKV_cursor cur, JQP_EXPR *expr, iwrc *rcp) {
   size_t sz;
   char skey[1024];
@@ -250,26 +311,15 @@ bool jbi_node_expr_matched(JQP_AUX *aux, JBIDX idx, IWKV_cursor cur, JQP_EXPR *e
   rc = iwkv_cursor_copy_key(cur, kbuf, sizeof(skey) - 1, &sz, 0);
   RCGO(rc, finish);
   if (sz > sizeof(skey) - 1) {
-    kbuf = malloc(sz);
+    kbuf = malloc(sz + 1);
     if (!kbuf) {
       rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
       goto finish;
     }
-    rc = iwkv_cursor_copy_key(cur, kbuf, sizeof(skey) - 1, &sz, 0);
+    rc = iwkv_cursor_copy_key(cur, kbuf, sz, &sz, 0);
     RCGO(rc, finish);
   }
-  if (idx->mode & EJDB_IDX_STR) {
-    kbuf[sz] = '\0';
-    lv.type = JQVAL_STR;
-    lv.vstr = kbuf;
-  } else if (idx->mode & EJDB_IDX_I64) {
-    memcpy(&lv.vi64, kbuf, sizeof(lv.vi64));
-    lv.type = JQVAL_I64;
-  } else if (idx->mode & EJDB_IDX_F64) {
-    kbuf[sz] = '\0';
-    lv.type = JQVAL_F64;
-    lv.vf64 = (double) iwatof(kbuf);
-  }
+  RCC(rc, finish, jbi_ikey_to_jqval(idx, kbuf, sz, &lv));
 
   ret = jql_match_jqval_pair(aux, &lv, expr->op, rv, &rc);
 
@@ -280,3 +330,126 @@ finish:
   *rcp = rc;
   return ret;
 }
+
+iwrc jbi_resume_cursor_open(
+  struct jbexec *ctx, IWKV_cursor_op cursor_step, IWKV_cursor *curp,
+  int64_t *stepp) {
+  iwrc rc;
+  bool matched;
+  int64_t id, cid;
+  uint32_t dbid;
+  IWKV_val key = { 0 };
+  JBIDX idx = ctx->midx.idx;
+  struct iwdb *db = idx ? idx->idb : ctx->jbc->cdb;
+  const char *token = iwxstr_ptr(ctx->ux->resume);
+  size_t tsz = iwxstr_size(ctx->ux->resume);
+
+  *curp = 0;
+  *stepp = 1;
+  if (tsz < JBI_RESUME_TOKEN_HDR_SZ) {
+    return EJDB_ERROR_INVALID_RESUME_TOKEN;
+  }
+  memcpy(&dbid, token, sizeof(dbid));
+  memcpy(&id, token + sizeof(dbid), sizeof(id));
+  dbid = IW_ITOHL(dbid);
+  id = IW_ITOHLL(id);
+  if (dbid != (idx ? idx->dbid : ctx->jbc->dbid)) {
+    return EJDB_ERROR_INVALID_RESUME_TOKEN;
+  }
+  if (idx) {
+    key.data = (void*) (token + JBI_RESUME_TOKEN_HDR_SZ);
+    key.size = tsz - JBI_RESUME_TOKEN_HDR_SZ;
+    key.compound = id;
+    if (!key.size) {
+      return EJDB_ERROR_INVALID_RESUME_TOKEN;
+    }
+  } else {
+    key.data = &id;
+    key.size = sizeof(id);
+  }
+
+  // Cursor is placed at the lowest entry greater or equal to token position
+  rc = iwkv_cursor_open(db, curp, IWKV_CURSOR_GE, &key);
+  if (rc == IWKV_ERROR_NOTFOUND) {
+    if (*curp) {
+      iwkv_cursor_close(curp);
+    }
+    if (cursor_step == IWKV_CURSOR_PREV) { // No entries left in ascending order
+      return rc;
+    }
+    // All entries are lower than token, start descending scan from the greatest one
+    rc = iwkv_cursor_open(db, curp, IWKV_CURSOR_BEFORE_FIRST, 0);
+    RCRET(rc);
+    return iwkv_cursor_to(*curp, IWKV_CURSOR_NEXT);
+  }
+  RCRET(rc);
+
+  if (cursor_step == IWKV_CURSOR_NEXT) {
+    *stepp = 2; // Next lower entry is strictly after the token in descending order
+  } else {
+    rc = iwkv_cursor_is_matched_key(*curp, &key, &matched, &cid);
+    RCRET(rc);
+    if (matched && (!idx || !(idx->idbf & IWDB_COMPOUND_KEYS) || (cid == id))) {
+      *stepp = 2; // Entry of token itself
+    }
+  }
+  return 0;
+}
+
+iwrc jbi_exec_check(struct jbexec *ctx) {
+  struct ejdb_exec *ux = ctx->ux;
+  if (!(ux->deadline || ux->cancel) || (++ctx->ticks < JBI_EXEC_CHECK_INTERVAL)) {
+    return 0;
+  }
+  ctx->ticks = 0;
+  if (ux->cancel && *ux->cancel) {
+    return EJDB_ERROR_QUERY_CANCELLED;
+  }
+  if (ux->deadline) {
+    uint64_t ts;
+    iwrc rc = iwp_current_time_ms(&ts, true);
+    RCRET(rc);
+    if (ts >= ux->deadline) {
+      return EJDB_ERROR_QUERY_TIMEOUT;
+    }
+  }
+  return 0;
+}
+
+iwrc jbi_resume_token_save(struct jbexec *ctx, int64_t id) {
+  iwrc rc = 0;
+  size_t sz = 0;
+  char kbuf[1024];
+  char *kp = kbuf;
+  JBIDX idx = ctx->midx.idx;
+  IWXSTR *xstr = ctx->ux->resume;
+  uint32_t dbid = IW_HTOIL(idx ? idx->dbid : ctx->jbc->dbid);
+  int64_t llv = IW_HTOILL(id);
+
+  if (idx) {
+    if (!ctx->icur) {
+      return IW_ERROR_INVALID_STATE;
+    }
+    rc = iwkv_cursor_copy_key(ctx->icur, kbuf, sizeof(kbuf), &sz, 0);
+    RCRET(rc);
+    if (sz > sizeof(kbuf)) {
+      kp = malloc(sz);
+      if (!kp) {
+        return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      }
+      RCC(rc, finish, iwkv_cursor_copy_key(ctx->icur, kp, sz, &sz, 0));
+    }
+  }
+  iwxstr_clear(xstr);
+  RCC(rc, finish, iwxstr_cat(xstr, &dbid, sizeof(dbid)));
+  RCC(rc, finish, iwxstr_cat(xstr, &llv, sizeof(llv)));
+  if (sz) {
+    rc = iwxstr_cat(xstr, kp, sz);
+  }
+
+finish:
+  if (kp != kbuf) {
+    free(kp);
+  }
+  return rc;
+}
@@ -4,6 +4,8 @@
 #include <iwnet/iwn_ws_server.h>
 #include <iwnet/iwn_pairs.h>
 #include <iowow/iwconv.h>
+#include <iowow/iwtp.h>
+#include <iowow/iwp.h>
 
 #include <pthread.h>
 #include <ctype.h>
@@ -11,10 +13,21 @@
 #define JBR_MAX_KEY_LEN          36
 #define JBR_WS_STR_PREMATURE_END "Premature end of message"
 
+// Size of query output buffer handed over to HTTP response writer
+#define JBR_QUERY_BUF_SZ 65536
+// Max number of filled query output buffers queued for writing
+#define JBR_QUERY_BUFS_MAX 8
+// Max number of documents stored by bulk import within single collection lock acquisition
+#define JBR_BULK_BATCH_SZ 1024
+// Default max number of websocket queries executed concurrently for single session
+#define JBR_WS_MAX_INFLIGHT_DEFAULT 16
+
 typedef enum {
   _JBR_ERROR_START = (IW_ERROR_START + 15000UL + 3000),
-  JBR_ERROR_WS_INVALID_MESSAGE, /**< Invalid message recieved (JBR_ERROR_WS_INVALID_MESSAGE) */
-  JBR_ERROR_WS_ACCESS_DENIED,   /**< Access denied (JBR_ERROR_WS_ACCESS_DENIED) */
+  JBR_ERROR_WS_INVALID_MESSAGE,   /**< Invalid message recieved (JBR_ERROR_WS_INVALID_MESSAGE) */
+  JBR_ERROR_WS_ACCESS_DENIED,     /**< Access denied (JBR_ERROR_WS_ACCESS_DENIED) */
+  JBR_ERROR_HTTP_WRITE,           /**< Failed to write HTTP response (JBR_ERROR_HTTP_WRITE) */
+  JBR_ERROR_WS_TOO_MANY_REQUESTS, /**< Too many in-flight websocket requests (JBR_ERROR_WS_TOO_MANY_REQUESTS) */
   _JBR_ERROR_END,
 } jbr_ecode_t;
 
@@ -23,33 +36,95 @@ struct jbr {
   pthread_t poller_thread;
   const EJDB_HTTP   *http;
   struct iwn_wf_ctx *ctx;
+  IWTP ws_tp;        /**< Websocket queries worker pool */
+  int  ws_max_inflight;
   EJDB db;
+  IWHMAP  *cache;           /**< GET responses cache: `<collection>\t<id>` => struct centry */
+  uint64_t cache_gen;       /**< Cache invalidations counter */
+  uint64_t cache_seq;       /**< Sequence used for ETag generation */
+  uint64_t cache_epoch;     /**< Server start time used for ETag generation */
+  pthread_mutex_t cache_mtx;
+};
+
+// Cached JSON response of GET /{collection}/{id}
+struct centry {
+  int    refs;    /**< Number of references guarded by `jbr.cache_mtx` */
+  size_t len;     /**< JSON body length */
+  char   etag[2 * IWNUMBUF_SIZE + 4];
+  char   body[];
+};
+
+// Binary documents representation for `Accept: application/x-binn`
+#define JBR_MIME_BINN "application/x-binn"
+
+// Query output buffer
+struct qbuf {
+  IWXSTR      *xstr;
+  struct qbuf *next;
 };
 
 struct rctx {
   struct iwn_wf_req  *req;
   struct iwn_ws_sess *ws;
   struct jbr     *jbr;
-  struct iwn_vals vals;
+  struct qbuf    *qfirst;  /**< Filled query output buffers queued for writing */
+  struct qbuf    *qlast;
+  struct qbuf    *qspare;  /**< Written query output buffers available for reuse */
+  struct qbuf    *qbuf;    /**< Query output buffer filled by visitor */
   pthread_mutex_t mtx;
   pthread_cond_t  cond;
   EJDB_EXEC       ux;
   int64_t   id;
   pthread_t request_thread;
+  int       qnum;          /**< Number of queued buffers */
   bool      read_anon;
   bool      visitor_started;
   bool      visitor_finished;
+  bool      write_failed;
+  volatile bool cancelled; /**< Query cancellation flag, set if client gone */
+  bool      binn;          /**< Respond with binn encoded documents */
+  bool      bulk;          /**< Bulk import request: `POST /{collection}/_bulk` */
+  struct bulk *bulk_st;    /**< Bulk import parser state */
+  bool      metrics;       /**< Metrics request: `GET /_metrics` */
+  bool      slowlog;       /**< Slow queries log request: `GET /_slowlog` */
+  int64_t   timeout;       /**< Query timeout in milliseconds from `X-Timeout` header */
+  int       ws_inflight;   /**< Number of websocket queries scheduled for execution */
+  bool      ws_disposed;   /**< Websocket session is gone, context is released by the last worker */
+  struct wstask *ws_tasks; /**< Websocket queries scheduled for execution */
   char      cname[EJDB_COLLECTION_NAME_MAX_LEN + 1];
 };
 
+// Incremental parser state of bulk import request
+struct bulk {
+  IWXSTR *line;     /**< Partial line carried between request body chunks */
+  int64_t lineno;
+  size_t  num;      /**< Number of parsed documents in `jbls` batch */
+  iwrc    rc;       /**< Import error, the rest of request body is discarded */
+  bool    bad_json;
+  bool    streamed; /**< Request body is read by chunks */
+  JBL     jbls[JBR_BULK_BATCH_SZ];
+};
+
 struct mctx {
-  struct rctx *ctx;
-  IWXSTR      *wbuf;
-  int64_t      id;
+  struct rctx   *ctx;
+  struct wstask *task;  /**< Worker task if message is executed by worker thread */
+  IWXSTR  *wbuf;
+  int64_t  id;
+  bool binn;   /**< Respond with binn encoded documents */
   char cname[EJDB_COLLECTION_NAME_MAX_LEN + 1];
   char key[JBR_MAX_KEY_LEN + 1];
 };
 
+// Websocket query executed by worker thread
+struct wstask {
+  struct wstask *next;
+  struct mctx    mctx;
+  volatile bool  cancelled;
+  bool explain;
+  bool batch; /**< Coalesce result documents into messages of up to `JBR_QUERY_BUF_SZ` bytes */
+  char query[];
+};
+
 #define JBR_RC_REPORT(ret_, r_, rc_)                                       \
         do {                                                               \
           if ((ret_) >= 500) iwlog_ecode_error3(rc_);                      \
@@ -67,6 +142,67 @@ void jbr_shutdown_request(EJDB db) {
   }
 }
 
+static void _cache_entry_release(struct centry *ce) {
+  if (--ce->refs == 0) {
+    free(ce);
+  }
+}
+
+static void _cache_kvfree(void *key, void *val) {
+  free(key);
+  if (val) {
+    _cache_entry_release(val);
+  }
+}
+
+static iwrc _cache_init(struct jbr *jbr) {
+  if (jbr->http->cache_size < 1) {
+    return 0;
+  }
+  iwrc rc = iwp_current_time_ms(&jbr->cache_epoch, false);
+  RCRET(rc);
+  jbr->cache = iwhmap_create_str(_cache_kvfree);
+  if (!jbr->cache) {
+    return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+  }
+  iwhmap_lru_init(jbr->cache, iwhmap_lru_eviction_max_count, (void*) (intptr_t) jbr->http->cache_size);
+  pthread_mutex_init(&jbr->cache_mtx, 0);
+  return 0;
+}
+
+static void _cache_destroy(struct jbr *jbr) {
+  if (jbr->cache) {
+    iwhmap_destroy(jbr->cache);
+    jbr->cache = 0;
+    pthread_mutex_destroy(&jbr->cache_mtx);
+  }
+}
+
+static char* _cache_key(const char *coll, int64_t id) {
+  size_t len = strlen(coll) + IWNUMBUF_SIZE + 2;
+  char *key = malloc(len);
+  if (key) {
+    snprintf(key, len, "%s\t%" PRId64, coll, id);
+  }
+  return key;
+}
+
+void jbr_cache_invalidate(struct jbr *jbr, const char *coll, int64_t id) {
+  if (!jbr || !jbr->cache) {
+    return;
+  }
+  char *key = id ? _cache_key(coll, id) : 0;
+  pthread_mutex_lock(&jbr->cache_mtx);
+  ++jbr->cache_gen;
+  if (key) {
+    iwhmap_remove(jbr->cache, key);
+  } else {
+    iwhmap_clear(jbr->cache);
+  }
+  pthread_mutex_unlock(&jbr->cache_mtx);
+  free(key);
+}
+
 void jbr_shutdown_wait(struct jbr *jbr) {
   if (jbr) {
     pthread_t t = jbr->poller_thread;
@@ -75,6 +211,10 @@ void jbr_shutdown_wait(struct jbr *jbr) {
       jbr->poller_thread = 0;
       pthread_join(t, 0);
     }
+    if (jbr->ws_tp) {
+      iwtp_shutdown(&jbr->ws_tp, true);
+    }
+    _cache_destroy(jbr);
     free(jbr);
   }
 }
@@ -86,14 +226,45 @@ static void* _poller_worker(void *op) {
   return 0;
 }
 
+static struct qbuf* _qbuf_create(void) {
+  struct qbuf *qb = malloc(sizeof(*qb));
+  if (!qb) {
+    return 0;
+  }
+  qb->next = 0;
+  qb->xstr = iwxstr_new2(JBR_QUERY_BUF_SZ + JBR_QUERY_BUF_SZ / 4);
+  if (!qb->xstr) {
+    free(qb);
+    return 0;
+  }
+  return qb;
+}
+
+static void _qbuf_destroy(struct qbuf *qb) {
+  while (qb) {
+    struct qbuf *n = qb->next;
+    iwxstr_destroy(qb->xstr);
+    free(qb);
+    qb = n;
+  }
+}
+
+static void _bulk_destroy(struct bulk *b) {
+  if (b) {
+    for (size_t i = 0; i < b->num; ++i) {
+      jbl_destroy(&b->jbls[i]);
+    }
+    iwxstr_destroy(b->line);
+    free(b);
+  }
+}
+
 static void _rctx_dispose(struct rctx *ctx) {
   if (ctx) {
-    for (struct iwn_val *v = ctx->vals.first; v; ) {
-      struct iwn_val *n = v->next;
-      free(v->buf);
-      free(v);
-      v = n;
-    }
+    _bulk_destroy(ctx->bulk_st);
+    _qbuf_destroy(ctx->qfirst);
+    _qbuf_destroy(ctx->qspare);
+    _qbuf_destroy(ctx->qbuf);
     pthread_mutex_destroy(&ctx->mtx);
     pthread_cond_destroy(&ctx->cond);
     free(ctx);
@@ -102,10 +273,169 @@ static void _rctx_dispose(struct rctx *ctx) {
 
 static void _on_http_request_dispose(struct iwn_http_req *req) {
   struct rctx *ctx = req->user_data;
+  if (ctx) {
+    // Connection is gone while request thread may still stream query results:
+    // cancel query, wake up visitor waiting for queue space and wait until it's done with context
+    pthread_mutex_lock(&ctx->mtx);
+    if (ctx->visitor_started) {
+      ctx->write_failed = true;
+      ctx->cancelled = true;
+      pthread_cond_broadcast(&ctx->cond);
+      while (!ctx->visitor_finished) {
+        pthread_cond_wait(&ctx->cond, &ctx->mtx);
+      }
+    }
+    pthread_mutex_unlock(&ctx->mtx);
+  }
   _rctx_dispose(ctx);
 }
 
+static bool _accepts_binn(struct iwn_http_req *req) {
+  struct iwn_val val = iwn_http_request_header_get(req, "accept", IW_LLEN("accept"));
+  if (val.len) {
+    char buf[val.len + 1];
+    memcpy(buf, val.buf, val.len);
+    buf[val.len] = '\0';
+    return strstr(buf, JBR_MIME_BINN) != 0;
+  }
+  return false;
+}
+
+// Returns value of `X-Timeout` request header in milliseconds or zero
+static int64_t _timeout_header(struct iwn_http_req *req) {
+  struct iwn_val val = iwn_http_request_header_get(req, "x-timeout", IW_LLEN("x-timeout"));
+  if (val.len > 0 && val.len < IWNUMBUF_SIZE) {
+    char buf[IWNUMBUF_SIZE];
+    memcpy(buf, val.buf, val.len);
+    buf[val.len] = '\0';
+    int64_t ret = iwatoi(buf);
+    return ret > 0 ? ret : 0;
+  }
+  return 0;
+}
+
+// Converts query timeout into `EJDB_EXEC.deadline`
+static uint64_t _timeout_deadline(int64_t timeout) {
+  uint64_t ts;
+  if (timeout < 1 || iwp_current_time_ms(&ts, true)) {
+    return 0;
+  }
+  return ts + timeout;
+}
+
+// Appends binn data of document to `xstr`.
+// Stored documents are copied as is, projected documents are encoded into binn.
+static iwrc _doc_binn_cat(EJDB_DOC doc, IWXSTR *xstr) {
+  iwrc rc;
+  if (doc->node) {
+    struct jbl sn = { 0 };
+    rc = _jbl_from_node(&sn, doc->node);
+    if (!rc) {
+      rc = iwxstr_cat(xstr, sn.bn.ptr, sn.bn.size);
+    }
+    binn_free(&sn.bn);
+  } else {
+    rc = iwxstr_cat(xstr, doc->raw->bn.ptr, doc->raw->bn.size);
+  }
+  return rc;
+}
+
+// Returns true if `If-None-Match` request header matches given `etag`
+static bool _etag_matched(struct iwn_http_req *req, const char *etag) {
+  struct iwn_val val = iwn_http_request_header_get(req, "if-none-match", IW_LLEN("if-none-match"));
+  if (!val.len) {
+    return false;
+  }
+  if (val.len == 1 && *val.buf == '*') {
+    return true;
+  }
+  size_t len = strlen(etag);
+  for (const char *p = val.buf, *ep = val.buf + val.len; p + len <= ep; ++p) {
+    if (!strncmp(p, etag, len)) {
+      return true;
+    }
+  }
+  return false;
+}
+
+// GET /{collection}/{id} served by responses cache
+static int _on_get_cached(struct rctx *ctx) {
+  JBL jbl = 0;
+  IWXSTR *xstr = 0;
+  struct centry *ce = 0;
+  struct jbr *jbr = ctx->jbr;
+  struct iwn_http_req *http = ctx->req->http;
+  int ret = 500;
+  iwrc rc = 0;
+
+  char *key = _cache_key(ctx->cname, ctx->id);
+  if (!key) {
+    return 500;
+  }
+
+  pthread_mutex_lock(&jbr->cache_mtx);
+  uint64_t gen = jbr->cache_gen;
+  ce = iwhmap_get(jbr->cache, key);
+  if (ce) {
+    ++ce->refs;
+  }
+  pthread_mutex_unlock(&jbr->cache_mtx);
+
+  if (!ce) {
+    rc = ejdb_get(jbr->db, ctx->cname, ctx->id, &jbl);
+    if (rc) {
+      if ((rc == IWKV_ERROR_NOTFOUND) || (rc == IW_ERROR_NOT_EXISTS)) {
+        rc = 0;
+        ret = 404;
+      }
+      goto finish;
+    }
+    RCA(xstr = iwxstr_new2((size_t) jbl->bn.size * 2), finish);
+    RCC(rc, finish, jbl_as_json(jbl, jbl_xstr_json_printer, xstr, JBL_PRINT_PRETTY));
+    RCA(ce = malloc(sizeof(*ce) + iwxstr_size(xstr)), finish);
+    ce->refs = 1;
+    ce->len = iwxstr_size(xstr);
+    memcpy(ce->body, iwxstr_ptr(xstr), ce->len);
+
+    pthread_mutex_lock(&jbr->cache_mtx);
+    snprintf(ce->etag, sizeof(ce->etag), "\"%" PRIx64 "-%" PRIx64 "\"", jbr->cache_epoch, ++jbr->cache_seq);
+    // Entry is cached only if document was not changed since lookup
+    if (gen == jbr->cache_gen && !iwhmap_put(jbr->cache, key, ce)) {
+      key = 0; // Owned by cache
+      ++ce->refs;
+    }
+    pthread_mutex_unlock(&jbr->cache_mtx);
+  }
+
+  RCC(rc, finish, iwn_http_response_header_set(http, "etag", ce->etag, strlen(ce->etag)));
+  if (_etag_matched(http, ce->etag)) {
+    ret = iwn_http_response_write(http, 304, "application/json", 0, 0) ? 1 : -1;
+  } else if (ctx->req->flags & IWN_WF_HEAD) {
+    RCC(rc, finish, iwn_http_response_header_i64_set(http, "content-length", ce->len));
+    ret = iwn_http_response_write(http, 200, "application/json", 0, 0) ? 1 : -1;
+  } else {
+    ret = iwn_http_response_write(http, 200, "application/json", ce->body, ce->len) ? 1 : -1;
+  }
+
+finish:
+  if (rc) {
+    JBR_RC_REPORT(ret, http, rc);
+  }
+  if (ce) {
+    pthread_mutex_lock(&jbr->cache_mtx);
+    _cache_entry_release(ce);
+    pthread_mutex_unlock(&jbr->cache_mtx);
+  }
+  free(key);
+  jbl_destroy(&jbl);
+  iwxstr_destroy(xstr);
+  return ret;
+}
+
 static int _on_get(struct rctx *ctx) {
+  if (ctx->jbr->cache && !_accepts_binn(ctx->req->http)) {
+    return _on_get_cached(ctx);
+  }
   JBL jbl = 0;
   IWXSTR *xstr = 0;
   int nbytes = 0, ret = 500;
@@ -118,6 +448,17 @@ static int _on_get(struct rctx *ctx) {
     goto finish;
   }
 
+  if (_accepts_binn(ctx->req->http)) {
+    // Stored binn document is sent as is
+    bool head = ctx->req->flags & IWN_WF_HEAD;
+    if (head) {
+      RCC(rc, finish, iwn_http_response_header_i64_set(ctx->req->http, "content-length", jbl->bn.size));
+    }
+    ret = iwn_http_response_write(ctx->req->http, 200, JBR_MIME_BINN,
+                                  head ? 0 : jbl->bn.ptr, head ? 0 : jbl->bn.size) ? 1 : -1;
+    goto finish;
+  }
+
   if (ctx->req->flags & IWN_WF_HEAD) {
     RCC(rc, finish, jbl_as_json(jbl, jbl_count_json_printer, &nbytes, JBL_PRINT_PRETTY));
     RCC(rc, finish, iwn_http_response_header_i64_set(ctx->req->http, "content-length", nbytes));
@@ -249,6 +590,48 @@ static int _on_delete(struct rctx *ctx) {
   return 200;
 }
 
+static int _on_metrics(struct rctx *ctx) {
+  int ret = 500;
+  IWXSTR *xstr = iwxstr_new();
+  if (!xstr) {
+    return 500;
+  }
+  iwrc rc = jb_metrics_print(ctx->jbr->db, xstr);
+  if (rc) {
+    JBR_RC_REPORT(ret, ctx->req->http, rc);
+  } else {
+    bool head = ctx->req->flags & IWN_WF_HEAD;
+    if (head && iwn_http_response_header_i64_set(ctx->req->http, "content-length", iwxstr_size(xstr))) {
+      ret = 500;
+    } else {
+      ret = iwn_http_response_write(ctx->req->http, 200, "text/plain; version=0.0.4",
+                                    head ? 0 : iwxstr_ptr(xstr), head ? 0 : (ssize_t) iwxstr_size(xstr)) ? 1 : -1;
+    }
+  }
+  iwxstr_destroy(xstr);
+  return ret;
+}
+
+static int _on_slowlog(struct rctx *ctx) {
+  JBL jbl = 0;
+  IWXSTR *xstr = 0;
+  int ret = 500;
+  iwrc rc = ejdb_get_slow_queries(ctx->jbr->db, &jbl);
+  RCGO(rc, finish);
+  RCA(xstr = iwxstr_new(), finish);
+  RCC(rc, finish, jbl_as_json(jbl, jbl_xstr_json_printer, xstr, JBL_PRINT_PRETTY));
+  ret = iwn_http_response_write(ctx->req->http, 200, "application/json",
+                                iwxstr_ptr(xstr), iwxstr_size(xstr)) ? 1 : -1;
+
+finish:
+  if (rc) {
+    JBR_RC_REPORT(ret, ctx->req->http, rc);
+  }
+  jbl_destroy(&jbl);
+  iwxstr_destroy(xstr);
+  return ret;
+}
+
 static int _on_options(struct rctx *ctx) {
   iwrc rc;
   JBL jbl = 0;
@@ -293,7 +676,7 @@ finish:
 
 static bool _query_chunk_write_next(struct iwn_http_req *req, bool *again) {
   iwrc rc = 0;
-  struct iwn_val *val;
+  struct qbuf *qb;
   struct rctx *ctx = req->user_data;
 
   if (ctx->request_thread == pthread_self()) {
@@ -301,23 +684,32 @@ static bool _query_chunk_write_next(struct iwn_http_req *req, bool *again) {
   }
 
   pthread_mutex_lock(&ctx->mtx);
-start:
-  val = ctx->vals.first;
-  if (val) {
-    ctx->vals.first = val->next;
-    if (ctx->vals.last == val) {
-      ctx->vals.last = 0;
-    }
-  } else if (!ctx->visitor_finished) {
+  while (!(qb = ctx->qfirst) && !ctx->visitor_finished) {
     pthread_cond_wait(&ctx->cond, &ctx->mtx);
-    goto start;
+  }
+  if (qb) {
+    ctx->qfirst = qb->next;
+    if (!ctx->qfirst) {
+      ctx->qlast = 0;
+    }
+    --ctx->qnum;
   }
   pthread_mutex_unlock(&ctx->mtx);
 
-  if (val) {
-    rc = iwn_http_response_chunk_write(req, val->buf, val->len, _query_chunk_write_next, again);
-    free(val->buf);
-    free(val);
+  if (qb) {
+    rc = iwn_http_response_chunk_write(req, iwxstr_ptr(qb->xstr), iwxstr_size(qb->xstr),
+                                       _query_chunk_write_next, again);
+    iwxstr_clear(qb->xstr);
+    // Return buffer for reuse and wake up visitor waiting for queue space
+    pthread_mutex_lock(&ctx->mtx);
+    qb->next = ctx->qspare;
+    ctx->qspare = qb;
+    if (rc) {
+      ctx->write_failed = true;
+      ctx->cancelled = true;
+    }
+    pthread_cond_broadcast(&ctx->cond);
+    pthread_mutex_unlock(&ctx->mtx);
   } else {
     rc = iwn_http_response_chunk_end(req);
   }
@@ -325,11 +717,90 @@ start:
   return rc == 0;
 }
 
+// Hands over filled query output buffer to HTTP response writer.
+// Blocks while `JBR_QUERY_BUFS_MAX` buffers are waiting to be written.
+static iwrc _query_flush(struct rctx *ctx) {
+  iwrc rc = 0;
+  struct qbuf *qb = ctx->qbuf;
+
+  if (!ctx->visitor_started) {
+    // Start chunked response from request thread
+    ctx->visitor_started = true;
+    if (ctx->binn) {
+      rc = iwn_http_response_header_set(ctx->req->http, "content-type", JBR_MIME_BINN, IW_LLEN(JBR_MIME_BINN));
+      if (rc) {
+        iwxstr_clear(qb->xstr);
+        return rc;
+      }
+    }
+    rc = iwn_http_response_chunk_write(
+      ctx->req->http, iwxstr_ptr(qb->xstr), iwxstr_size(qb->xstr), _query_chunk_write_next, 0);
+    iwxstr_clear(qb->xstr);
+    return rc;
+  }
+
+  pthread_mutex_lock(&ctx->mtx);
+  while (ctx->qnum >= JBR_QUERY_BUFS_MAX && !ctx->write_failed) {
+    pthread_cond_wait(&ctx->cond, &ctx->mtx);
+  }
+  if (ctx->write_failed) {
+    pthread_mutex_unlock(&ctx->mtx);
+    return JBR_ERROR_HTTP_WRITE;
+  }
+  if (ctx->qlast) {
+    ctx->qlast->next = qb;
+  } else {
+    ctx->qfirst = qb;
+  }
+  ctx->qlast = qb;
+  ++ctx->qnum;
+  ctx->qbuf = ctx->qspare;
+  if (ctx->qbuf) {
+    ctx->qspare = ctx->qbuf->next;
+    ctx->qbuf->next = 0;
+  }
+  pthread_cond_broadcast(&ctx->cond);
+  pthread_mutex_unlock(&ctx->mtx);
+
+  if (!ctx->qbuf) {
+    RCA(ctx->qbuf = _qbuf_create(), finish);
+  }
+
+finish:
+  return rc;
+}
+
 static iwrc _query_visitor(EJDB_EXEC *ux, EJDB_DOC doc, int64_t *step) {
   iwrc rc = 0;
   struct rctx *ctx = ux->opaque;
-  IWXSTR *xstr = iwxstr_new();
-  RCA(xstr, finish);
+  if (!ctx->qbuf) {
+    RCA(ctx->qbuf = _qbuf_create(), finish);
+  }
+  IWXSTR *xstr = ctx->qbuf->xstr;
+
+  if (ctx->binn) {
+    // Frame: | id:i64 | size:u32 | binn data | (little endian)
+    size_t off = iwxstr_size(xstr);
+    int64_t llv = IW_HTOILL(doc->id);
+    uint32_t lv = 0;
+    if (ux->log) {
+      // Execution plan is sent as the first frame with zero id
+      int64_t zero = 0;
+      lv = IW_HTOIL((uint32_t) iwxstr_size(ux->log));
+      RCC(rc, finish, iwxstr_cat(xstr, &zero, sizeof(zero)));
+      RCC(rc, finish, iwxstr_cat(xstr, &lv, sizeof(lv)));
+      RCC(rc, finish, iwxstr_cat(xstr, iwxstr_ptr(ux->log), iwxstr_size(ux->log)));
+      iwxstr_destroy(ux->log);
+      ux->log = 0;
+      off = iwxstr_size(xstr);
+    }
+    RCC(rc, finish, iwxstr_cat(xstr, &llv, sizeof(llv)));
+    RCC(rc, finish, iwxstr_cat(xstr, &lv, sizeof(lv)));
+    RCC(rc, finish, _doc_binn_cat(doc, xstr));
+    lv = IW_HTOIL((uint32_t) (iwxstr_size(xstr) - off - sizeof(llv) - sizeof(lv)));
+    memcpy(iwxstr_ptr(xstr) + off + sizeof(llv), &lv, sizeof(lv));
+    goto flush;
+  }
 
   if (ux->log) {
     RCC(rc, finish, iwxstr_cat(xstr, iwxstr_ptr(ux->log), iwxstr_size(ux->log)));
@@ -344,27 +815,34 @@ static iwrc _query_visitor(EJDB_EXEC *ux, EJDB_DOC doc, int64_t *step) {
     RCC(rc, finish, jbl_as_json(doc->raw, jbl_xstr_json_printer, xstr, 0));
   }
 
-  if (ctx->visitor_started) {
-    size_t sz = iwxstr_size(xstr);
-    char *buf = iwxstr_destroy_keep_ptr(xstr);
-    pthread_mutex_lock(&ctx->mtx);
-    iwn_val_add_new(&ctx->vals, buf, sz);
-    pthread_cond_broadcast(&ctx->cond);
-    pthread_mutex_unlock(&ctx->mtx);
-  } else {
-    ctx->visitor_started = true;
-    RCC(rc, finish, iwn_http_response_chunk_write(
-          ctx->req->http, iwxstr_ptr(xstr), iwxstr_size(xstr), _query_chunk_write_next, 0));
-    iwxstr_destroy(xstr);
+flush:
+  if (iwxstr_size(xstr) >= JBR_QUERY_BUF_SZ) {
+    rc = _query_flush(ctx);
   }
 
-  xstr = 0;
-
 finish:
-  iwxstr_destroy(xstr);
   return rc;
 }
 
+// Terminates started query response stream by error record
+static void _query_error_write(struct rctx *ctx, iwrc rc) {
+  if (!ctx->qbuf) {
+    return;
+  }
+  IWXSTR *xstr = ctx->qbuf->xstr;
+  const char *err = iwlog_ecode_explained(rc);
+  if (ctx->binn) {
+    // Error frame has `-1` id and text payload
+    int64_t llv = IW_HTOILL((int64_t) -1);
+    uint32_t lv = IW_HTOIL((uint32_t) strlen(err));
+    iwxstr_cat(xstr, &llv, sizeof(llv));
+    iwxstr_cat(xstr, &lv, sizeof(lv));
+    iwxstr_cat(xstr, err, strlen(err));
+  } else {
+    iwxstr_printf(xstr, "\r\nERROR: %s", err);
+  }
+}
+
 static int _on_query(struct rctx *ctx) {
   if (ctx->req->body_len < 1) {
     return 400;
@@ -375,6 +853,7 @@ static int _on_query(struct rctx *ctx) {
   ctx->ux.opaque = ctx;
   ctx->ux.db = ctx->jbr->db;
   ctx->ux.visitor = _query_visitor;
+  ctx->ux.cancel = &ctx->cancelled;
 
   RCC(rc, finish,
       jql_create2(&ctx->ux.q, 0, ctx->req->body, JQL_SILENT_ON_PARSE_ERROR | JQL_KEEP_QUERY_ON_PARSE_ERROR));
@@ -384,6 +863,8 @@ static int _on_query(struct rctx *ctx) {
     return 403;
   }
 
+  ctx->binn = _accepts_binn(ctx->req->http);
+
   struct iwn_val val = iwn_http_request_header_get(ctx->req->http, "x-hints", IW_LLEN("x-hints"));
   if (val.len) {
     char buf[val.len + 1];
@@ -394,31 +875,39 @@ static int _on_query(struct rctx *ctx) {
     }
   }
 
-  rc = ejdb_exec(&ctx->ux);
+  ctx->ux.deadline = _timeout_deadline(_timeout_header(ctx->req->http));
 
-  pthread_mutex_lock(&ctx->mtx);
-  ctx->visitor_finished = true;
-  pthread_cond_broadcast(&ctx->cond);
-  pthread_mutex_unlock(&ctx->mtx);
-  RCGO(rc, finish);
+  rc = ejdb_exec(&ctx->ux);
+  if (rc && ctx->visitor_started) {
+    // Response is already started, so error is reported as the last record
+    if (!ctx->write_failed) {
+      _query_error_write(ctx, rc);
+    }
+    rc = 0;
+  }
+  if (!rc && ctx->qbuf && iwxstr_size(ctx->qbuf->xstr)) {
+    rc = _query_flush(ctx);
+  }
+  if (ctx->visitor_started) {
+    // Chunked response is started so status can't be reported, close connection on write failure
+    ret = rc ? -1 : 1;
+    rc = 0;
+    goto finish;
+  }
 
-  if (!ctx->visitor_started) {
-    if (ctx->ux.log) {
-      iwxstr_cat(ctx->ux.log, "--------------------", 20);
-      if (jql_has_aggregate_count(ctx->ux.q)) {
-        iwxstr_printf(ctx->ux.log, "\n%" PRId64, ctx->ux.cnt);
-      }
-      ret = iwn_http_response_write(ctx->req->http, 200, "text/plain",
-                                    iwxstr_ptr(ctx->ux.log), iwxstr_size(ctx->ux.log))
-            ? 1 : -1;
-    } else if (jql_has_aggregate_count(ctx->ux.q)) {
-      ret = iwn_http_response_printf(ctx->req->http, 200, "text/plain", "%" PRId64, ctx->ux.cnt)
-            ? 1 : -1;
-    } else {
-      ret = 200;
+  if (ctx->ux.log) {
+    iwxstr_cat(ctx->ux.log, "--------------------", 20);
+    if (jql_has_aggregate_count(ctx->ux.q)) {
+      iwxstr_printf(ctx->ux.log, "\n%" PRId64, ctx->ux.cnt);
     }
+    ret = iwn_http_response_write(ctx->req->http, 200, "text/plain",
+                                  iwxstr_ptr(ctx->ux.log), iwxstr_size(ctx->ux.log))
+          ? 1 : -1;
+  } else if (jql_has_aggregate_count(ctx->ux.q)) {
+    ret = iwn_http_response_printf(ctx->req->http, 200, "text/plain", "%" PRId64, ctx->ux.cnt)
+          ? 1 : -1;
   } else {
-    ret = 1;
+    ret = 200;
   }
 
 finish:
@@ -435,6 +924,10 @@ finish:
         ret = 400;
         JBR_RC_REPORT(ret, ctx->req->http, rc);
         break;
+      case EJDB_ERROR_QUERY_TIMEOUT:
+        ret = 504;
+        JBR_RC_REPORT(ret, ctx->req->http, rc);
+        break;
       default:
         JBR_RC_REPORT(ret, ctx->req->http, rc);
         break;
@@ -442,9 +935,164 @@ finish:
   }
   jql_destroy(&ctx->ux.q);
   iwxstr_destroy(ctx->ux.log);
+
+  // Context may be disposed right after this point if response is started
+  pthread_mutex_lock(&ctx->mtx);
+  ctx->visitor_finished = true;
+  pthread_cond_broadcast(&ctx->cond);
+  pthread_mutex_unlock(&ctx->mtx);
   return ret;
 }
 
+// Stores batch of parsed documents and writes their identifiers to the response
+static iwrc _bulk_store(struct rctx *ctx) {
+  struct bulk *b = ctx->bulk_st;
+  int64_t ids[JBR_BULK_BATCH_SZ];
+  IWXSTR *xstr = ctx->qbuf->xstr;
+  iwrc rc = ejdb_put_new_batch(ctx->jbr->db, ctx->cname, b->jbls, b->num, ids);
+  for (size_t i = 0; i < b->num; ++i) {
+    if (ids[i]) {
+      IWRC(iwxstr_printf(xstr, "%" PRId64 "\n", ids[i]), rc);
+    }
+    jbl_destroy(&b->jbls[i]);
+  }
+  b->num = 0;
+  // Response of streamed request is started only when request body is fully read
+  if (!rc && !b->streamed && iwxstr_size(xstr) >= JBR_QUERY_BUF_SZ) {
+    rc = _query_flush(ctx);
+  }
+  return rc;
+}
+
+// Parses accumulated line of newline delimited JSON into the current batch
+static iwrc _bulk_line(struct rctx *ctx) {
+  iwrc rc = 0;
+  struct bulk *b = ctx->bulk_st;
+  char *lp = iwxstr_ptr(b->line), *le = lp + iwxstr_size(b->line);
+  ++b->lineno;
+  for ( ; lp < le && isspace((unsigned char) *lp); ++lp);
+  for ( ; le > lp && isspace((unsigned char) le[-1]); --le);
+  if (lp < le) {
+    *le = '\0';
+    rc = jbl_from_json(&b->jbls[b->num], lp);
+    if (rc) {
+      b->bad_json = true;
+      goto finish;
+    }
+    if (++b->num == JBR_BULK_BATCH_SZ) {
+      rc = _bulk_store(ctx);
+    }
+  }
+
+finish:
+  iwxstr_clear(b->line);
+  return rc;
+}
+
+// Feeds chunk of request body to the bulk import parser.
+// Only incomplete trailing line is kept between chunks, so memory is bounded by line size.
+static void _bulk_feed(struct rctx *ctx, const char *buf, size_t len) {
+  struct bulk *b = ctx->bulk_st;
+  const char *rp = buf, *ep = buf + len;
+  while (!b->rc && rp < ep) {
+    const char *le = memchr(rp, '\n', ep - rp);
+    if (!le) {
+      b->rc = iwxstr_cat(b->line, rp, ep - rp);
+      break;
+    }
+    b->rc = iwxstr_cat(b->line, rp, le - rp);
+    if (!b->rc) {
+      b->rc = _bulk_line(ctx);
+    }
+    rp = le + 1;
+  }
+}
+
+// Stores the rest of parsed documents and completes bulk import response
+static int _bulk_complete(struct rctx *ctx) {
+  struct bulk *b = ctx->bulk_st;
+  iwrc rc = b->rc;
+  int ret = 500;
+
+  if (!rc && iwxstr_size(b->line)) {
+    rc = _bulk_line(ctx); // Last line without newline
+  }
+  if (!rc && b->num) {
+    rc = _bulk_store(ctx);
+  }
+  if (b->streamed) {
+    // Response is written by current thread, see _query_chunk_write_next()
+    ctx->request_thread = pthread_self();
+  }
+  if (!rc && iwxstr_size(ctx->qbuf->xstr)) {
+    rc = _query_flush(ctx);
+  }
+  if (rc && (ctx->visitor_started || iwxstr_size(ctx->qbuf->xstr))) {
+    // Some documents are already stored, report error as the last line after their identifiers
+    IWXSTR *xstr = ctx->qbuf->xstr;
+    if (b->bad_json) {
+      iwxstr_printf(xstr, "ERROR: line %" PRId64 ": %s\n", b->lineno, iwlog_ecode_explained(rc));
+    } else {
+      iwxstr_printf(xstr, "ERROR: %s\n", iwlog_ecode_explained(rc));
+    }
+    _query_flush(ctx);
+  }
+
+  pthread_mutex_lock(&ctx->mtx);
+  ctx->visitor_finished = true;
+  pthread_cond_broadcast(&ctx->cond);
+  pthread_mutex_unlock(&ctx->mtx);
+
+  if (ctx->visitor_started) {
+    ret = 1;
+  } else if (b->bad_json) {
+    ret = iwn_http_response_printf(ctx->req->http, 400, "text/plain",
+                                   "line %" PRId64 ": %s", b->lineno, iwlog_ecode_explained(rc)) ? 1 : -1;
+  } else if (rc) {
+    JBR_RC_REPORT(ret, ctx->req->http, rc);
+  } else {
+    ret = 200;
+  }
+  if (ret > 1 && b->streamed) {
+    // Request handler is already returned, so the response is written here
+    ret = iwn_http_response_write(ctx->req->http, ret, "text/plain", "", 0) ? 1 : -1;
+  }
+  return ret;
+}
+
+static bool _on_bulk_chunk(struct iwn_http_req *req, bool *again) {
+  struct rctx *ctx = req->user_data;
+  struct iwn_val val = iwn_http_request_chunk_get(req);
+  if (val.len > 0) {
+    _bulk_feed(ctx, val.buf, val.len);
+    iwn_http_request_chunk_next(req, _on_bulk_chunk);
+    return true;
+  }
+  return _bulk_complete(ctx) > 0;
+}
+
+static int _on_bulk(struct rctx *ctx) {
+  if (ctx->read_anon) {
+    return 403;
+  }
+  struct bulk *b = ctx->bulk_st = calloc(1, sizeof(*ctx->bulk_st));
+  if (!b) {
+    return 500;
+  }
+  if (!(b->line = iwxstr_new()) || !(ctx->qbuf = _qbuf_create())) {
+    return 500;
+  }
+  // Newline delimited JSON documents are parsed as request body arrives
+  // and stored by batches of `JBR_BULK_BATCH_SZ`.
+  if (iwn_http_request_is_streamed(ctx->req->http)) {
+    b->streamed = true;
+    iwn_http_request_chunk_next(ctx->req->http, _on_bulk_chunk);
+    return 1;
+  }
+  _bulk_feed(ctx, ctx->req->body, ctx->req->body_len);
+  return _bulk_complete(ctx);
+}
+
 static int _on_http_request(struct iwn_wf_req *req, void *op) {
   struct jbr *jbr = op;
   struct rctx *ctx = calloc(1, sizeof(*ctx));
@@ -472,20 +1120,33 @@ static int _on_http_request(struct iwn_wf_req *req, void *op) {
     size_t len = strlen(cname);
     char *c = strchr(req->path_unmatched, '/');
     if (!c) {
-      if (  len > EJDB_COLLECTION_NAME_MAX_LEN
-         || (method & (IWN_WF_GET | IWN_WF_HEAD | IWN_WF_PUT | IWN_WF_DELETE | IWN_WF_PATCH))) {
+      if ((method & (IWN_WF_GET | IWN_WF_HEAD)) && !strcmp(cname, "_metrics")) {
+        ctx->metrics = true;
+      } else if ((method == IWN_WF_GET) && !strcmp(cname, "_slowlog")) {
+        ctx->slowlog = true;
+      } else if (  len > EJDB_COLLECTION_NAME_MAX_LEN
+                || (method & (IWN_WF_GET | IWN_WF_HEAD | IWN_WF_PUT | IWN_WF_DELETE | IWN_WF_PATCH))) {
         return 400;
       }
     } else {
       len = c - cname;
-      if (  len > EJDB_COLLECTION_NAME_MAX_LEN
-         || method == IWN_WF_POST) {
+      if (len > EJDB_COLLECTION_NAME_MAX_LEN) {
         return 400;
       }
-      char *ep;
-      ctx->id = strtoll(c + 1, &ep, 10);
-      if (*ep != '\0' || ctx->id < 1) {
-        return 400;
+      if (!strcmp(c + 1, "_bulk")) {
+        if (method != IWN_WF_POST) {
+          return 400;
+        }
+        ctx->bulk = true;
+      } else {
+        if (method == IWN_WF_POST) {
+          return 400;
+        }
+        char *ep;
+        ctx->id = strtoll(c + 1, &ep, 10);
+        if (*ep != '\0' || ctx->id < 1) {
+          return 400;
+        }
       }
     }
     memcpy(ctx->cname, cname, len);
@@ -495,7 +1156,7 @@ static int _on_http_request(struct iwn_wf_req *req, void *op) {
   if (jbr->http->access_token) {
     struct iwn_val val = iwn_http_request_header_get(req->http, "x-access-token", IW_LLEN("x-access-token"));
     if (!val.len) {
-      if (jbr->http->read_anon) {
+      if (jbr->http->read_anon && !ctx->metrics && !ctx->slowlog) { // Server statistics are not public
         if (  (method & (IWN_WF_GET | IWN_WF_HEAD))
            || (method == IWN_WF_POST && ctx->cname[0] == '\0')) {
           ctx->read_anon = true;
@@ -515,13 +1176,17 @@ process:
   if (jbr->http->cors && iwn_http_response_header_set(req->http, "access-control-allow-origin", "*", 1)) {
     return 500;
   }
-  if (ctx->cname[0] != '\0') {
+  if (ctx->metrics) {
+    return _on_metrics(ctx);
+  } else if (ctx->slowlog) {
+    return _on_slowlog(ctx);
+  } else if (ctx->cname[0] != '\0') {
     switch (method) {
       case IWN_WF_GET:
       case IWN_WF_HEAD:
         return _on_get(ctx);
       case IWN_WF_POST:
-        return _on_post(ctx);
+        return ctx->bulk ? _on_bulk(ctx) : _on_post(ctx);
       case IWN_WF_PUT:
         return _on_put(ctx);
       case IWN_WF_PATCH:
@@ -553,6 +1218,10 @@ typedef enum {
   JBWS_IDX,
   JBWS_NIDX,
   JBWS_REMOVE_COLL,
+  JBWS_BGET,
+  JBWS_BQUERY,
+  JBWS_MQUERY,
+  JBWS_CANCEL,
 } jbws_e;
 
 static int _on_ws_session_http(struct iwn_wf_req *req, struct iwn_ws_handler_spec *spec) {
@@ -565,6 +1234,7 @@ static int _on_ws_session_http(struct iwn_wf_req *req, struct iwn_ws_handler_spe
   pthread_cond_init(&ctx->cond, 0);
   ctx->req = req;
   ctx->jbr = jbr;
+  ctx->timeout = _timeout_header(req->http);
   req->http->user_data = ctx;
 
   if (jbr->http->access_token) {
@@ -586,7 +1256,21 @@ static int _on_ws_session_http(struct iwn_wf_req *req, struct iwn_ws_handler_spe
 }
 
 static void _on_ws_session_dispose(struct iwn_ws_sess *ws) {
-  _on_http_request_dispose(ws->req->http);
+  struct rctx *ctx = ws->req->http->user_data;
+  // Cancel session queries without blocking poller thread,
+  // context is released by the last running worker if any
+  pthread_mutex_lock(&ctx->mtx);
+  for (struct wstask *t = ctx->ws_tasks; t; t = t->next) {
+    t->cancelled = true;
+  }
+  ctx->ws = 0;
+  ctx->ws_disposed = ctx->ws_inflight > 0;
+  bool dispose = !ctx->ws_disposed;
+  pthread_mutex_unlock(&ctx->mtx);
+  ws->req->http->user_data = 0;
+  if (dispose) {
+    _rctx_dispose(ctx);
+  }
 }
 
 static bool _on_ws_session_init(struct iwn_ws_sess *ws) {
@@ -686,8 +1370,13 @@ static bool _ws_document_get(struct iwn_ws_sess *ws, struct mctx *mctx, int64_t
   RCC(rc, finish, ejdb_get(ctx->jbr->db, mctx->cname, id, &jbl));
   RCA(xstr = iwxstr_new2((size_t) jbl->bn.size * 2), finish);
   RCC(rc, finish, iwxstr_printf(xstr, "%s\t%" PRId64 "\t", mctx->key, id));
-  RCC(rc, finish, jbl_as_json(jbl, jbl_xstr_json_printer, xstr, JBL_PRINT_PRETTY));
-  ret = iwn_ws_server_write(ws, iwxstr_ptr(xstr), iwxstr_size(xstr));
+  if (mctx->binn) {
+    RCC(rc, finish, iwxstr_cat(xstr, jbl->bn.ptr, jbl->bn.size));
+    ret = iwn_ws_server_write_binary(ws, iwxstr_ptr(xstr), iwxstr_size(xstr));
+  } else {
+    RCC(rc, finish, jbl_as_json(jbl, jbl_xstr_json_printer, xstr, JBL_PRINT_PRETTY));
+    ret = iwn_ws_server_write(ws, iwxstr_ptr(xstr), iwxstr_size(xstr));
+  }
 
 finish:
   iwxstr_destroy(xstr);
@@ -791,42 +1480,79 @@ finish:
   return ret;
 }
 
+// Sends message of worker task to websocket session.
+// Writes are serialized with session disposal, message is dropped if session is gone.
+static bool _ws_task_write(struct mctx *mctx, const char *buf, size_t len, bool binary) {
+  bool ret = false;
+  struct rctx *ctx = mctx->ctx;
+  pthread_mutex_lock(&ctx->mtx);
+  if (ctx->ws) {
+    if (binary) {
+      ret = iwn_ws_server_write_binary(ctx->ws, buf, len);
+    } else {
+      ret = iwn_ws_server_write(ctx->ws, buf, len);
+    }
+  }
+  pthread_mutex_unlock(&ctx->mtx);
+  return ret;
+}
+
 static iwrc _ws_query_visitor(EJDB_EXEC *ux, EJDB_DOC doc, int64_t *step) {
   iwrc rc = 0;
   struct mctx *mctx = ux->opaque;
-  if (!mctx->wbuf) {
-    RCA(mctx->wbuf = iwxstr_new2(512), finish);
-  } else {
-    iwxstr_clear(mctx->wbuf);
+  IWXSTR *wbuf = mctx->wbuf;
+  if (mctx->task->cancelled) {
+    *step = 0;
+    return 0;
   }
   if (ux->log) {
-    iwn_ws_server_printf(mctx->ctx->ws, "%s\texplain\t%s", mctx->key, iwxstr_ptr(ux->log));
+    iwxstr_clear(wbuf);
+    RCC(rc, finish, iwxstr_printf(wbuf, "%s\texplain\t%s", mctx->key, iwxstr_ptr(ux->log)));
+    _ws_task_write(mctx, iwxstr_ptr(wbuf), iwxstr_size(wbuf), false);
     iwxstr_destroy(ux->log);
     ux->log = 0;
   }
-  RCC(rc, finish, iwxstr_printf(mctx->wbuf, "%s\t%" PRId64 "\t", mctx->key, doc->id));
-  if (doc->node) {
-    RCC(rc, finish, jbn_as_json(doc->node, jbl_xstr_json_printer, mctx->wbuf, 0));
+  if (!mctx->task->batch) {
+    iwxstr_clear(wbuf);
+  } else if (iwxstr_size(wbuf)) {
+    RCC(rc, finish, iwxstr_cat(wbuf, "\n", 1));
+  }
+  RCC(rc, finish, iwxstr_printf(wbuf, "%s\t%" PRId64 "\t", mctx->key, doc->id));
+  if (mctx->binn) {
+    RCC(rc, finish, _doc_binn_cat(doc, wbuf));
+  } else if (doc->node) {
+    RCC(rc, finish, jbn_as_json(doc->node, jbl_xstr_json_printer, wbuf, 0));
   } else {
-    RCC(rc, finish, jbl_as_json(doc->raw, jbl_xstr_json_printer, mctx->wbuf, 0));
+    RCC(rc, finish, jbl_as_json(doc->raw, jbl_xstr_json_printer, wbuf, 0));
   }
-  if (!iwn_ws_server_write(mctx->ctx->ws, iwxstr_ptr(mctx->wbuf), iwxstr_size(mctx->wbuf))) {
+  if (mctx->task->batch && iwxstr_size(wbuf) < JBR_QUERY_BUF_SZ) {
+    goto finish; // Wait for more documents
+  }
+  if (!_ws_task_write(mctx, iwxstr_ptr(wbuf), iwxstr_size(wbuf), mctx->binn)) {
     *step = 0;
   }
+  if (mctx->task->batch) {
+    iwxstr_clear(wbuf);
+  }
 
 finish:
   return rc;
 }
 
-static bool _ws_query(struct iwn_ws_sess *ws, struct mctx *mctx, const char *query, bool explain) {
+// Executes query of worker task, results are sent as one message per document
+// or as newline separated batches of documents if task is batched (`mquery`)
+static bool _ws_query(struct mctx *mctx, const char *query, bool explain) {
   iwrc rc;
   bool ret = false;
+  IWXSTR *wbuf = mctx->wbuf;
   struct rctx *ctx = mctx->ctx;
 
   EJDB_EXEC ux = {
     .db = ctx->jbr->db,
     .opaque = mctx,
     .visitor = _ws_query_visitor,
+    .deadline = _timeout_deadline(ctx->timeout),
+    .cancel = &mctx->task->cancelled,
   };
 
   RCC(rc, finish,
@@ -838,37 +1564,129 @@ static bool _ws_query(struct iwn_ws_sess *ws, struct mctx *mctx, const char *que
   if (explain) {
     RCA(ux.log = iwxstr_new(), finish);
   }
-  RCC(rc, finish, ejdb_exec(&ux));
+  rc = ejdb_exec(&ux);
+  if (rc == EJDB_ERROR_QUERY_CANCELLED) {
+    rc = 0; // Cancelled by client, terminate response as usual
+  }
+  if (mctx->task->batch && iwxstr_size(wbuf)) { // Flush the tail of batch
+    _ws_task_write(mctx, iwxstr_ptr(wbuf), iwxstr_size(wbuf), false);
+  }
+  RCGO(rc, finish);
   if (ux.log) {
-    ret = iwn_ws_server_printf(mctx->ctx->ws, "%s\texplain\t%s", mctx->key, iwxstr_ptr(ux.log));
-  } else {
-    ret = true;
+    iwxstr_clear(wbuf);
+    RCC(rc, finish, iwxstr_printf(wbuf, "%s\texplain\t%s", mctx->key, iwxstr_ptr(ux.log)));
+    _ws_task_write(mctx, iwxstr_ptr(wbuf), iwxstr_size(wbuf), false);
   }
 
 finish:
+  iwxstr_clear(wbuf);
   if (rc) {
     iwrc rcs = rc;
     iwrc_strip_code(&rcs);
-    switch (rcs) {
-      case JQL_ERROR_QUERY_PARSE:
-        ret = _ws_error_send(ws, mctx->key, jql_error(ux.q), 0);
-        break;
-      default:
-        ret = _ws_rc_send(ws, mctx->key, rc, 0);
-        break;
-    }
+    const char *error = (rcs == JQL_ERROR_QUERY_PARSE) ? jql_error(ux.q) : iwlog_ecode_explained(rc);
+    rc = iwxstr_printf(wbuf, "%s ERROR: %s", mctx->key, error ? error : "unknown");
+  } else if (jql_has_aggregate_count(ux.q)) {
+    rc = iwxstr_printf(wbuf, "%s\t%" PRId64, mctx->key, ux.cnt);
   } else {
-    if (jql_has_aggregate_count(ux.q)) {
-      ret = iwn_ws_server_printf(ws, "%s\t%" PRId64, mctx->key, ux.cnt);
-    } else {
-      ret = iwn_ws_server_write(ws, mctx->key, -1);
-    }
+    rc = iwxstr_cat2(wbuf, mctx->key);
+  }
+  if (!rc) {
+    ret = _ws_task_write(mctx, iwxstr_ptr(wbuf), iwxstr_size(wbuf), false);
   }
   jql_destroy(&ux.q);
   iwxstr_destroy(ux.log);
   return ret;
 }
 
+static void _ws_task_release(struct wstask *task) {
+  bool dispose;
+  struct rctx *ctx = task->mctx.ctx;
+  pthread_mutex_lock(&ctx->mtx);
+  for (struct wstask *t = ctx->ws_tasks, *pt = 0; t; pt = t, t = t->next) {
+    if (t == task) {
+      if (pt) {
+        pt->next = t->next;
+      } else {
+        ctx->ws_tasks = t->next;
+      }
+      break;
+    }
+  }
+  --ctx->ws_inflight;
+  dispose = ctx->ws_disposed && ctx->ws_inflight == 0;
+  pthread_mutex_unlock(&ctx->mtx);
+  iwxstr_destroy(task->mctx.wbuf);
+  free(task);
+  if (dispose) { // The last worker of disposed session releases its context
+    _rctx_dispose(ctx);
+  }
+}
+
+static void _ws_task_run(void *op) {
+  struct wstask *task = op;
+  if (task->cancelled) {
+    _ws_task_write(&task->mctx, task->mctx.key, strlen(task->mctx.key), false);
+  } else {
+    _ws_query(&task->mctx, task->query, task->explain);
+  }
+  _ws_task_release(task);
+}
+
+// Schedules query execution on worker thread, so slow queries don't block session and poller
+static bool _ws_query_schedule(
+  struct iwn_ws_sess *ws, struct mctx *mctx, const char *query,
+  bool explain, bool batch) {
+  iwrc rc = 0;
+  struct rctx *ctx = mctx->ctx;
+  size_t len = strlen(query);
+  struct wstask *task = malloc(sizeof(*task) + len + 1);
+  if (!task) {
+    return _ws_rc_send(ws, mctx->key, iwrc_set_errno(IW_ERROR_ALLOC, errno), 0);
+  }
+  memcpy(&task->mctx, mctx, sizeof(task->mctx));
+  task->mctx.wbuf = iwxstr_new2(512);
+  if (!task->mctx.wbuf) {
+    free(task);
+    return _ws_rc_send(ws, mctx->key, iwrc_set_errno(IW_ERROR_ALLOC, errno), 0);
+  }
+  task->mctx.task = task;
+  task->cancelled = false;
+  task->explain = explain;
+  task->batch = batch;
+  memcpy(task->query, query, len + 1);
+
+  pthread_mutex_lock(&ctx->mtx);
+  if (ctx->ws_inflight >= ctx->jbr->ws_max_inflight) {
+    pthread_mutex_unlock(&ctx->mtx);
+    iwxstr_destroy(task->mctx.wbuf);
+    free(task);
+    return _ws_rc_send(ws, mctx->key, JBR_ERROR_WS_TOO_MANY_REQUESTS, 0);
+  }
+  ++ctx->ws_inflight;
+  task->next = ctx->ws_tasks;
+  ctx->ws_tasks = task;
+  pthread_mutex_unlock(&ctx->mtx);
+
+  rc = iwtp_schedule(ctx->jbr->ws_tp, _ws_task_run, task);
+  if (rc) {
+    _ws_task_release(task);
+    return _ws_rc_send(ws, mctx->key, rc, 0);
+  }
+  return true;
+}
+
+static bool _ws_cancel(struct iwn_ws_sess *ws, struct mctx *mctx) {
+  struct rctx *ctx = mctx->ctx;
+  pthread_mutex_lock(&ctx->mtx);
+  for (struct wstask *t = ctx->ws_tasks; t; t = t->next) {
+    if (!strcmp(t->mctx.key, mctx->key)) {
+      t->cancelled = true;
+    }
+  }
+  pthread_mutex_unlock(&ctx->mtx);
+  return true;
+}
+
 static bool _on_ws_msg_impl(struct iwn_ws_sess *ws, struct mctx *mctx, const char *msg_, size_t len) {
   if (len < 1) {
     return true;
@@ -901,6 +1719,10 @@ static bool _on_ws_msg_impl(struct iwn_ws_sess *ws, struct mctx *mctx, const cha
         "\n<key> rmc     <collection>"
         "\n<key> query   <collection> <query>"
         "\n<key> explain <collection> <query>"
+        "\n<key> bget    <collection> <id>"
+        "\n<key> bquery  <collection> <query>"
+        "\n<key> mquery  <collection> <query>"
+        "\n<key> cancel"
         "\n<key> <query>";
     return iwn_ws_server_write(ws, help, sizeof(help) - 1);
   }
@@ -949,12 +1771,22 @@ static bool _on_ws_msg_impl(struct iwn_ws_sess *ws, struct mctx *mctx, const cha
       wsop = JBWS_NIDX;
     } else if (!strncmp("rmc", msg, pos)) {
       wsop = JBWS_REMOVE_COLL;
+    } else if (!strncmp("bget", msg, pos)) {
+      wsop = JBWS_BGET;
+    } else if (!strncmp("bquery", msg, pos)) {
+      wsop = JBWS_BQUERY;
+    } else if (!strncmp("mquery", msg, pos)) {
+      wsop = JBWS_MQUERY;
+    } else if (!strncmp("cancel", msg, pos)) {
+      wsop = JBWS_CANCEL;
     }
   }
 
   if (wsop > JBWS_NONE) {
     if (wsop == JBWS_INFO) {
       return _ws_info(ws, mctx);
+    } else if (wsop == JBWS_CANCEL) {
+      return _ws_cancel(ws, mctx);
     }
     for ( ; pos < len && isspace(msg[pos]); ++pos);
     len -= pos;
@@ -994,8 +1826,11 @@ static bool _on_ws_msg_impl(struct iwn_ws_sess *ws, struct mctx *mctx, const cha
         return _ws_document_add(ws, mctx, msg);
       case JBWS_QUERY:
       case JBWS_EXPLAIN:
+      case JBWS_BQUERY:
+      case JBWS_MQUERY:
         msg[len] = '\0';
-        return _ws_query(ws, mctx, msg, (wsop == JBWS_EXPLAIN));
+        mctx->binn = (wsop == JBWS_BQUERY);
+        return _ws_query_schedule(ws, mctx, msg, (wsop == JBWS_EXPLAIN), (wsop == JBWS_MQUERY));
       default: {
         char nbuf[IWNUMBUF_SIZE];
         for (pos = 0; pos < len && pos < IWNUMBUF_SIZE - 1 && isdigit(msg[pos]); ++pos) {
@@ -1013,6 +1848,8 @@ static bool _on_ws_msg_impl(struct iwn_ws_sess *ws, struct mctx *mctx, const cha
         msg[len] = '\0';
         switch (wsop) {
           case JBWS_GET:
+          case JBWS_BGET:
+            mctx->binn = (wsop == JBWS_BGET);
             return _ws_document_get(ws, mctx, id);
           case JBWS_SET:
             return _ws_document_set(ws, mctx, id, msg);
@@ -1031,7 +1868,7 @@ static bool _on_ws_msg_impl(struct iwn_ws_sess *ws, struct mctx *mctx, const cha
     }
   } else {
     msg[len] = '\0';
-    return _ws_query(ws, mctx, msg, false);
+    return _ws_query_schedule(ws, mctx, msg, false, false);
   }
 }
 
@@ -1111,7 +1948,12 @@ iwrc jbr_start(EJDB db, const EJDB_OPTS *opts, struct jbr **jbrp) {
   uint16_t cores = iwp_num_cpu_cores();
   cores = MAX(2, cores == 0 ? 1 : cores - 1);
 
+  jbr->ws_max_inflight = opts->http.ws_max_inflight > 0
+                         ? opts->http.ws_max_inflight : JBR_WS_MAX_INFLIGHT_DEFAULT;
+
+  RCC(rc, finish, _cache_init(jbr));
   RCC(rc, finish, _configure(jbr));
+  RCC(rc, finish, iwtp_start("jbrws-", opts->http.ws_workers > 0 ? opts->http.ws_workers : cores, 0, &jbr->ws_tp));
   RCC(rc, finish, iwn_poller_create(cores, cores / 2, &jbr->poller));
   RCC(rc, finish, _start(jbr));
 
@@ -1120,7 +1962,11 @@ iwrc jbr_start(EJDB db, const EJDB_OPTS *opts, struct jbr **jbrp) {
   } else {
     iwn_poller_poll(jbr->poller);
     iwn_poller_destroy(&jbr->poller);
+    if (jbr->ws_tp) {
+      iwtp_shutdown(&jbr->ws_tp, true);
+    }
     *jbrp = 0;
+    _cache_destroy(jbr);
     free(jbr);
   }
 
@@ -1129,6 +1975,10 @@ finish:
     *jbrp = 0;
     iwn_wf_destroy(jbr->ctx);
     iwn_poller_destroy(&jbr->poller);
+    if (jbr->ws_tp) {
+      iwtp_shutdown(&jbr->ws_tp, false);
+    }
+    _cache_destroy(jbr);
     free(jbr);
   }
   return rc;
@@ -1143,6 +1993,10 @@ static const char* _jbr_ecodefn(locale_t locale, uint32_t ecode) {
       return "Invalid message recieved (JBR_ERROR_WS_INVALID_MESSAGE)";
     case JBR_ERROR_WS_ACCESS_DENIED:
       return "Access denied (JBR_ERROR_WS_ACCESS_DENIED)";
+    case JBR_ERROR_HTTP_WRITE:
+      return "Failed to write HTTP response (JBR_ERROR_HTTP_WRITE)";
+    case JBR_ERROR_WS_TOO_MANY_REQUESTS:
+      return "Too many in-flight websocket requests (JBR_ERROR_WS_TOO_MANY_REQUESTS)";
   }
   return 0;
 }
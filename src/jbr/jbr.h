@@ -41,6 +41,12 @@ void jbr_shutdown_request(struct ejdb *db);
 
 void jbr_shutdown_wait(struct jbr *jbr);
 
+/**
+ * @brief Drops cached GET response of document `id` in `coll`.
+ *        Zero `id` drops all cached responses.
+ */
+void jbr_cache_invalidate(struct jbr *jbr, const char *coll, int64_t id);
+
 iwrc jbr_init(void);
 
 IW_EXTERN_C_END;
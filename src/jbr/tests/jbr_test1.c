@@ -255,6 +255,228 @@ static void jbr_test1_1() {
                          "}"
                          );
 
+  // Large query result is streamed by multiple output buffers
+  char dbuf[128];
+  for (int i = 0; i < 10000; ++i) {
+    snprintf(dbuf, sizeof(dbuf), "{\"n\":%d,\"s\":\"%080d\"}", i, i);
+    rc = put_json(db, "c2", dbuf);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+  curl_easy_reset(curl);
+  iwxstr_clear(xstr);
+  iwxstr_clear(hstr);
+  snprintf(url, sizeof(url), "http://localhost:%" PRIu32 "/", port);
+  curl_easy_setopt(curl, CURLOPT_URL, url);
+  curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "@c2/*");
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write_xstr);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, xstr);
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curl_write_xstr);
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, hstr);
+  cc = curl_easy_perform(curl);
+  CU_ASSERT_EQUAL_FATAL(cc, 0);
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+  CU_ASSERT_EQUAL_FATAL(code, 200);
+  int lines = 0;
+  for (const char *p = iwxstr_ptr(xstr); (p = strstr(p, "\r\n")); p += 2) {
+    ++lines;
+  }
+  CU_ASSERT_EQUAL(lines, 10000);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "\t{\"n\":0,"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "\t{\"n\":9999,"));
+
+  // Binary documents
+  JBL jbl;
+  rc = ejdb_get(db, "c1", 1, &jbl);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  curl_easy_reset(curl);
+  iwxstr_clear(xstr);
+  iwxstr_clear(hstr);
+  curl_slist_free_all(headers);
+  headers = curl_slist_append(0, "Accept: application/x-binn");
+  snprintf(url, sizeof(url), "http://localhost:%" PRIu32 "/c1/1", port);
+  curl_easy_setopt(curl, CURLOPT_URL, url);
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write_xstr);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, xstr);
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curl_write_xstr);
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, hstr);
+  cc = curl_easy_perform(curl);
+  CU_ASSERT_EQUAL_FATAL(cc, 0);
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+  CU_ASSERT_EQUAL_FATAL(code, 200);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(hstr), "content-type: application/x-binn"));
+  CU_ASSERT_EQUAL_FATAL(iwxstr_size(xstr), (size_t) jbl->bn.size);
+  CU_ASSERT_EQUAL(memcmp(iwxstr_ptr(xstr), jbl->bn.ptr, jbl->bn.size), 0);
+
+  curl_easy_reset(curl);
+  iwxstr_clear(xstr);
+  iwxstr_clear(hstr);
+  snprintf(url, sizeof(url), "http://localhost:%" PRIu32 "/", port);
+  curl_easy_setopt(curl, CURLOPT_URL, url);
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+  curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "@c1/*");
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write_xstr);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, xstr);
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curl_write_xstr);
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, hstr);
+  cc = curl_easy_perform(curl);
+  CU_ASSERT_EQUAL_FATAL(cc, 0);
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+  CU_ASSERT_EQUAL_FATAL(code, 200);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(hstr), "content-type: application/x-binn"));
+  {
+    // Single document frame: | id:i64 | size:u32 | binn |
+    int64_t llv;
+    uint32_t lv;
+    CU_ASSERT_EQUAL_FATAL(iwxstr_size(xstr), sizeof(llv) + sizeof(lv) + (size_t) jbl->bn.size);
+    memcpy(&llv, iwxstr_ptr(xstr), sizeof(llv));
+    memcpy(&lv, iwxstr_ptr(xstr) + sizeof(llv), sizeof(lv));
+    CU_ASSERT_EQUAL(IW_ITOHLL(llv), 1);
+    CU_ASSERT_EQUAL(IW_ITOHL(lv), (uint32_t) jbl->bn.size);
+    CU_ASSERT_EQUAL(memcmp(iwxstr_ptr(xstr) + sizeof(llv) + sizeof(lv), jbl->bn.ptr, jbl->bn.size), 0);
+  }
+  jbl_destroy(&jbl);
+
+  // Bulk import
+  curl_easy_reset(curl);
+  iwxstr_clear(xstr);
+  iwxstr_clear(hstr);
+  snprintf(url, sizeof(url), "http://localhost:%" PRIu32 "/c3/_bulk", port);
+  curl_easy_setopt(curl, CURLOPT_URL, url);
+  curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "{\"a\":1}\n\n {\"a\":2}\n");
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write_xstr);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, xstr);
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curl_write_xstr);
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, hstr);
+  cc = curl_easy_perform(curl);
+  CU_ASSERT_EQUAL_FATAL(cc, 0);
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+  CU_ASSERT_EQUAL_FATAL(code, 200);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "1\n2\n");
+
+  curl_easy_reset(curl);
+  iwxstr_clear(xstr);
+  iwxstr_clear(hstr);
+  curl_easy_setopt(curl, CURLOPT_URL, url);
+  curl_easy_setopt(curl, CURLOPT_POSTFIELDS, "{\"a\":3}\n{\"a\":");
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write_xstr);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, xstr);
+  cc = curl_easy_perform(curl);
+  CU_ASSERT_EQUAL_FATAL(cc, 0);
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+  CU_ASSERT_EQUAL_FATAL(code, 400);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "line 2:"));
+  int64_t count = 0;
+  rc = ejdb_count2(db, "c3", "/*", &count, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 2);
+
+
+  iwxstr_destroy(xstr);
+  iwxstr_destroy(hstr);
+  curl_slist_free_all(headers);
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+}
+
+// GET responses cache
+static void jbr_test1_2() {
+  char url[64];
+  char etag[128];
+  char inm[160];
+  uint32_t port = iwu_rand_range(20000) + 20000;
+
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "jbr_test1_2.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true,
+    .http = {
+      .bind = "127.0.0.1",
+      .blocking = false,
+      .enabled = true,
+      .port = port,
+      .cache_size = 16
+    }
+  };
+
+  long code;
+  EJDB db;
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "c1", "{'a':1}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  IWXSTR *xstr = iwxstr_new();
+  IWXSTR *hstr = iwxstr_new();
+  snprintf(url, sizeof(url), "http://localhost:%" PRIu32 "/c1/1", port);
+
+  curl_easy_reset(curl);
+  curl_easy_setopt(curl, CURLOPT_URL, url);
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write_xstr);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, xstr);
+  curl_easy_setopt(curl, CURLOPT_HEADERFUNCTION, curl_write_xstr);
+  curl_easy_setopt(curl, CURLOPT_HEADERDATA, hstr);
+  CURLcode cc = curl_easy_perform(curl);
+  CU_ASSERT_EQUAL_FATAL(cc, 0);
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+  CU_ASSERT_EQUAL_FATAL(code, 200);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "{\n \"a\": 1\n}");
+
+  const char *hv = strstr(iwxstr_ptr(hstr), "etag: ");
+  CU_ASSERT_PTR_NOT_NULL_FATAL(hv);
+  hv += IW_LLEN("etag: ");
+  size_t len = strcspn(hv, "\r\n");
+  CU_ASSERT_FATAL(len > 0 && len < sizeof(etag));
+  memcpy(etag, hv, len);
+  etag[len] = '\0';
+  snprintf(inm, sizeof(inm), "If-None-Match: %s", etag);
+  struct curl_slist *headers = curl_slist_append(0, inm);
+
+  // Document is not changed
+  curl_easy_reset(curl);
+  iwxstr_clear(xstr);
+  curl_easy_setopt(curl, CURLOPT_URL, url);
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write_xstr);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, xstr);
+  cc = curl_easy_perform(curl);
+  CU_ASSERT_EQUAL_FATAL(cc, 0);
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+  CU_ASSERT_EQUAL(code, 304);
+  CU_ASSERT_EQUAL(iwxstr_size(xstr), 0);
+
+  // Update drops cached response
+  int64_t id = 1;
+  rc = put_json2(db, "c1", "{'a':2}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  curl_easy_reset(curl);
+  iwxstr_clear(xstr);
+  curl_easy_setopt(curl, CURLOPT_URL, url);
+  curl_easy_setopt(curl, CURLOPT_HTTPHEADER, headers);
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write_xstr);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, xstr);
+  cc = curl_easy_perform(curl);
+  CU_ASSERT_EQUAL_FATAL(cc, 0);
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+  CU_ASSERT_EQUAL(code, 200);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "{\n \"a\": 2\n}");
+
+  // Removal drops cached response
+  rc = ejdb_del(db, "c1", 1);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  curl_easy_reset(curl);
+  iwxstr_clear(xstr);
+  curl_easy_setopt(curl, CURLOPT_URL, url);
+  curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, curl_write_xstr);
+  curl_easy_setopt(curl, CURLOPT_WRITEDATA, xstr);
+  cc = curl_easy_perform(curl);
+  CU_ASSERT_EQUAL_FATAL(cc, 0);
+  curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &code);
+  CU_ASSERT_EQUAL(code, 404);
 
   iwxstr_destroy(xstr);
   iwxstr_destroy(hstr);
@@ -274,7 +496,8 @@ int main() {
     return CU_get_error();
   }
   if (
-    (NULL == CU_add_test(pSuite, "jbr_test1_1", jbr_test1_1))) {
+    (NULL == CU_add_test(pSuite, "jbr_test1_1", jbr_test1_1))
+    || (NULL == CU_add_test(pSuite, "jbr_test1_2", jbr_test1_2))) {
     CU_cleanup_registry();
     return CU_get_error();
   }
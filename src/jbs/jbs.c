@@ -40,6 +40,11 @@ static int _usage(const char *err) {
           "Default: 16777216, min: 1048576\n");
   fprintf(stderr, "\t-D, --dsz=NUM            Initial size of buffer to process/store document on queries."
           " Preferable average size of document. Default: 65536, min: 16384\n");
+  fprintf(stderr, "\t-Q, --slow-query=NUM     Record queries executed longer than NUM milliseconds"
+          " into slow queries log. Default: 0 (disabled)\n");
+  fprintf(stderr, "\t-G, --get-cache=NUM      Max number of cached GET document responses. Default: 0 (disabled)\n");
+  fprintf(stderr, "\t-M, --doc-cache=NUM      Max size in bytes of documents cache used to fetch documents by id."
+          " Default: 0 (disabled)\n");
   fprintf(stderr, "\t-T, --trylock            Exit with error if database is locked by another process."
           " If not set, current process will wait for lock release.");
   fprintf(stderr, "\n\n");
@@ -102,10 +107,13 @@ int main(int argc, char *argv[]) {
     { "wal", 0, 0, 'w' },
     { "sbz", 1, 0, 'S' },
     { "dsz", 1, 0, 'D' },
+    { "get-cache", 1, 0, 'G' },
+    { "doc-cache", 1, 0, 'M' },
+    { "slow-query", 1, 0, 'Q' },
     { "trylock", 0, 0, 'T' }
   };
 
-  while ((ch = getopt_long(argc, argv, "f:p:b:l:k:c:a:S:D:rCtwThv", long_options, 0)) != -1) {
+  while ((ch = getopt_long(argc, argv, "f:p:b:l:k:c:a:S:D:G:M:Q:rCtwThv", long_options, 0)) != -1) {
     switch (ch) {
       case 'h':
         ec = _usage(0);
@@ -148,6 +156,15 @@ int main(int argc, char *argv[]) {
       case 'D':
         env.opts.document_buffer_sz = iwatoi(optarg);
         break;
+      case 'G':
+        env.opts.http.cache_size = iwatoi(optarg);
+        break;
+      case 'M':
+        env.opts.document_cache_sz = iwatoi(optarg);
+        break;
+      case 'Q':
+        env.opts.slow_query_ms = iwatoi(optarg);
+        break;
       case 'T':
         env.opts.kv.file_lock_fail_fast = true;
         break;
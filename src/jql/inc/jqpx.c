@@ -480,6 +480,8 @@ static union jqp_unit* _jqp_unit_op(yycontext *yy, const char *text) {
     unit->op.value = JQP_OP_NI;
   } else if (!strcmp(text, "re")) {
     unit->op.value = JQP_OP_RE;
+  } else if (!strcmp(text, "match")) {
+    unit->op.value = JQP_OP_MATCH;
   } else if (!(strcmp(text, "~"))) {
     unit->op.value = JQP_OP_PREFIX;
   } else {
@@ -881,11 +883,65 @@ static void _jqp_set_aggregate_count(yycontext *yy) {
   aux->projection = 0; // No projections in aggregate mode
 }
 
+static void _jqp_set_groupby(yycontext *yy, union jqp_unit *unit) {
+  struct jqp_aux *aux = yy->aux;
+  if (unit->type != JQP_STRING_TYPE) {
+    iwlog_error("Unexpected type for group by: %d", unit->type);
+    JQRC(yy, JQL_ERROR_QUERY_PARSE);
+  }
+  if (aux->groupby) {
+    JQRC(yy, JQL_ERROR_GROUPBY_ALREADY_SET);
+  }
+  aux->groupby = &unit->string;
+  aux->qmode |= JQP_QRY_GROUP;
+  aux->projection = 0; // No projections in aggregate mode
+}
+
+static void _jqp_set_distinct(yycontext *yy) {
+  struct jqp_aux *aux = yy->aux;
+  aux->qmode |= JQP_QRY_DISTINCT;
+}
+
+static void _jqp_set_aggregate_op(yycontext *yy, jqp_agg_op_t op) {
+  struct jqp_aux *aux = yy->aux;
+  aux->aggregate_op = op;
+}
+
+static void _jqp_add_aggregate(yycontext *yy, union jqp_unit *unit) {
+  struct jqp_aux *aux = yy->aux;
+  if (unit->type != JQP_STRING_TYPE) {
+    iwlog_error("Unexpected type for aggregate: %d", unit->type);
+    JQRC(yy, JQL_ERROR_QUERY_PARSE);
+  }
+  struct jqp_aggregate *agg = iwpool_calloc(sizeof(*agg), aux->pool);
+  if (!agg) {
+    JQRC(yy, iwrc_set_errno(IW_ERROR_ALLOC, errno));
+  }
+  agg->op = aux->aggregate_op;
+  agg->value = &unit->string;
+  if (!aux->aggregates) {
+    aux->aggregates = agg;
+  } else {
+    struct jqp_aggregate *a = aux->aggregates;
+    while (a->next) {
+      a = a->next;
+    }
+    a->next = agg;
+  }
+  aux->qmode |= JQP_QRY_GROUP;
+  aux->projection = 0;
+}
+
 static void _jqp_set_noidx(yycontext *yy) {
   struct jqp_aux *aux = yy->aux;
   aux->qmode |= JQP_QRY_NOIDX;
 }
 
+static void _jqp_set_indexonly(yycontext *yy) {
+  struct jqp_aux *aux = yy->aux;
+  aux->qmode |= JQP_QRY_INDEXONLY;
+}
+
 static void _jqp_set_inverse(yycontext *yy) {
   struct jqp_aux *aux = yy->aux;
   aux->qmode |= (JQP_QRY_NOIDX | JQP_QRY_INVERSE);
@@ -918,6 +974,32 @@ static void _jqp_set_projection(yycontext *yy, union jqp_unit *unit) {
   }
 }
 
+// Builds JSON pointer from path nodes linked by `subnext`
+static iwrc _jqp_path_ptr(
+  struct jqp_aux    *aux,
+  struct jqp_string *nodes,
+  struct iwxstr     *xstr,
+  struct jbl_ptr   **ptrp,
+  const char       **pathp) {
+  iwrc rc = 0;
+  iwxstr_clear(xstr);
+  for (struct jqp_string *on = nodes; on; on = on->subnext) {
+    rc = iwxstr_cat(xstr, "/", 1);
+    RCRET(rc);
+    rc = iwxstr_cat(xstr, on->value, strlen(on->value));
+    RCRET(rc);
+  }
+  rc = jbl_ptr_alloc_pool(iwxstr_ptr(xstr), ptrp, aux->pool);
+  RCRET(rc);
+  if (pathp) {
+    *pathp = iwpool_strdup2(aux->pool, iwxstr_ptr(xstr));
+    if (!*pathp) {
+      rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+  }
+  return rc;
+}
+
 static void _jqp_finish(yycontext *yy) {
   iwrc rc = 0;
   int cnt = 0;
@@ -932,34 +1014,44 @@ static void _jqp_finish(yycontext *yy) {
       RCGO(rc, finish);
     }
   }
+  if (  (aux->qmode & JQP_QRY_GROUP)
+     && (cnt || aux->apply || aux->apply_placeholder || (aux->qmode & JQP_QRY_APPLY_DEL))) {
+    rc = JQL_ERROR_AGGREGATE_INCOMPATIBLE;
+    goto finish;
+  }
   aux->orderby_num = cnt;
+  if (cnt || (aux->qmode & JQP_QRY_GROUP)) {
+    xstr = iwxstr_new();
+    if (!xstr) {
+      rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
+      RCGO(rc, finish);
+    }
+  }
   if (cnt) {
     aux->orderby_ptrs = iwpool_alloc(cnt * sizeof(struct jbl_ptr*), aux->pool);
     if (!aux->orderby_ptrs) {
       rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
       goto finish;
     }
-    xstr = iwxstr_new();
-    if (!xstr) {
-      rc = iwrc_set_errno(IW_ERROR_ALLOC, errno);
-      RCGO(rc, finish);
-    }
     cnt = 0;
     orderby = aux->orderby;
     for ( ; orderby; orderby = orderby->next) {
-      iwxstr_clear(xstr);
-      for (struct jqp_string *on = orderby; on; on = on->subnext) {
-        rc = iwxstr_cat(xstr, "/", 1);
-        RCGO(rc, finish);
-        iwxstr_cat(xstr, on->value, strlen(on->value));
-      }
-      rc = jbl_ptr_alloc_pool(iwxstr_ptr(xstr), &aux->orderby_ptrs[cnt], aux->pool);
+      rc = _jqp_path_ptr(aux, orderby, xstr, &aux->orderby_ptrs[cnt], 0);
       RCGO(rc, finish);
       struct jbl_ptr *ptr = aux->orderby_ptrs[cnt];
       ptr->op = (uint64_t) ((orderby->flavour & JQP_STR_NEGATE) != 0);  // asc/desc
       cnt++;
     }
   }
+  if (aux->groupby) {
+    rc = _jqp_path_ptr(aux, aux->groupby, xstr, &aux->groupby_ptr, &aux->groupby_path);
+    RCGO(rc, finish);
+  }
+  for (struct jqp_aggregate *agg = aux->aggregates; agg; agg = agg->next) {
+    rc = _jqp_path_ptr(aux, agg->value, xstr, &agg->ptr, &agg->path);
+    RCGO(rc, finish);
+    aux->aggregates_num++;
+  }
 
 finish:
   if (xstr) {
@@ -1186,6 +1278,9 @@ static iwrc _jqp_print_join(jqp_op_t jqop, bool negate, jbl_json_printer pt, voi
     case JQP_OP_PREFIX:
       PT(0, 0, '~', 1);
       break;
+    case JQP_OP_MATCH:
+      PT("match", 5, 0, 0);
+      break;
     default:
       iwlog_ecode_error3(IW_ERROR_ASSERTION);
       rc = IW_ERROR_ASSERTION;
@@ -1374,6 +1469,45 @@ static iwrc _jqp_print_opts(const struct jqp_query *q, jbl_json_printer pt, void
     }
     ob = ob->next;
   }
+  if (aux->groupby) {
+    if (c++ > 0) {
+      PT("\n ", 2, 0, 0);
+    }
+    if (aux->qmode & JQP_QRY_DISTINCT) {
+      PT(" distinct ", 10, 0, 0);
+    } else {
+      PT(" group ", 7, 0, 0);
+    }
+    struct jqp_string *n = aux->groupby;
+    do {
+      PT(0, 0, '/', 1);
+      PT(n->value, -1, 0, 0);
+    } while ((n = n->subnext));
+  }
+  for (struct jqp_aggregate *agg = aux->aggregates; agg; agg = agg->next) {
+    if (c++ > 0) {
+      PT("\n ", 2, 0, 0);
+    }
+    switch (agg->op) {
+      case JQP_AGG_SUM:
+        PT(" sum ", 5, 0, 0);
+        break;
+      case JQP_AGG_MIN:
+        PT(" min ", 5, 0, 0);
+        break;
+      case JQP_AGG_MAX:
+        PT(" max ", 5, 0, 0);
+        break;
+      case JQP_AGG_AVG:
+        PT(" avg ", 5, 0, 0);
+        break;
+    }
+    struct jqp_string *n = agg->value;
+    do {
+      PT(0, 0, '/', 1);
+      PT(n->value, -1, 0, 0);
+    } while ((n = n->subnext));
+  }
   if (aux->skip || aux->limit) {
     if (c > 0) {
       PT("\n ", 2, 0, 0);
@@ -1429,7 +1563,7 @@ iwrc jqp_print_query(const struct jqp_query *q, jbl_json_printer pt, void *op) {
     rc = _jqp_print_projection(aux->projection, pt, op);
     RCRET(rc);
   }
-  if (aux->skip || aux->limit || aux->orderby) {
+  if (aux->skip || aux->limit || aux->orderby || aux->groupby || aux->aggregates) {
     PT(0, 0, '\n', 1);
     rc = _jqp_print_opts(q, pt, op);
   }
@@ -1007,6 +1007,25 @@ static bool _jql_match_starts(
   }
 }
 
+static bool _jql_match_fts(
+  JQP_AUX *aux,
+  JQVAL *left, JQP_OP *jqop, JQVAL *right,
+  iwrc *rcp) {
+  struct jbi_fts_query *fq = jqop->opaque;
+  if (!fq) {
+    *rcp = jbi_fts_query_from_jqval(right, aux->pool, &fq);
+    if (*rcp) {
+      return false;
+    }
+    if (!fq) {
+      *rcp = _JQL_ERROR_UNMATCHED;
+      return false;
+    }
+    jqop->opaque = fq;
+  }
+  return jbi_fts_jqval_matched(fq, left, rcp);
+}
+
 static bool _jql_match_jqval_pair(
   JQP_AUX *aux,
   JQVAL *left, JQP_OP *jqop, JQVAL *right,
@@ -1050,6 +1069,10 @@ static bool _jql_match_jqval_pair(
         break;
       case JQP_OP_PREFIX:
         match = _jql_match_starts(left, jqop, right, rcp);
+        break;
+      case JQP_OP_MATCH:
+        match = _jql_match_fts(aux, left, jqop, right, rcp);
+        break;
       default:
         break;
     }
@@ -1561,7 +1584,11 @@ typedef struct _PROJ_CTX {
   JQL q;
   JQP_PROJECTION *proj;
   IWPOOL *pool;
-  JBEXEC *exec_ctx; // Optional!
+  JBEXEC *exec_ctx;        // Optional!
+  struct jbdocref *refs;   // Not cached joined documents collected for batch fetch
+  size_t refs_num;
+  size_t refs_asz;
+  bool   collect;          // Only collect joined documents references
 } PROJ_CTX;
 
 static void _jql_proj_mark_up(JBL_NODE n, int amask) {
@@ -1607,6 +1634,117 @@ static bool _jql_proj_matched(
   return false;
 }
 
+// Returns joined nodes cache and pool used to allocate cached nodes.
+// Cache is dropped if `reset` is set and its pool grows too large,
+// it is safe only when no nodes of currently projected document point to the pool.
+static iwrc _jql_proj_join_cache(JBEXEC *exec_ctx, bool reset, IWHMAP **cachep, IWPOOL **poolp) {
+  iwrc rc = 0;
+  IWHMAP *cache = exec_ctx->proj_joined_nodes_cache;
+  IWPOOL *pool = exec_ctx->ux->pool;
+  if (!pool) {
+    pool = exec_ctx->proj_joined_nodes_pool;
+    if (!pool) {
+      pool = iwpool_create(512);
+      RCGA(pool, finish);
+      exec_ctx->proj_joined_nodes_pool = pool;
+    } else if (reset && cache && (iwpool_used_size(pool) > 10UL * 1024 * 1024)) { // 10Mb
+      iwhmap_destroy(cache);
+      exec_ctx->proj_joined_nodes_cache = 0;
+      cache = 0;
+      iwpool_destroy(pool);
+      pool = iwpool_create(1024UL * 1024); // 1Mb
+      exec_ctx->proj_joined_nodes_pool = pool;
+      RCGA(pool, finish);
+    }
+  }
+  if (!cache) {
+    RCB(finish, cache = iwhmap_create(jb_proj_node_cache_cmp, jb_proj_node_hash, jb_proj_node_kvfree));
+    exec_ctx->proj_joined_nodes_cache = cache;
+  }
+
+finish:
+  *cachep = cache;
+  *poolp = pool;
+  return rc;
+}
+
+static iwrc _jql_proj_join_ref_add(PROJ_CTX *pctx, const struct jbdocref *ref) {
+  if (pctx->refs_num >= pctx->refs_asz) {
+    size_t nsz = pctx->refs_asz ? pctx->refs_asz * 2 : 32;
+    struct jbdocref *nrefs = realloc(pctx->refs, nsz * sizeof(nrefs[0]));
+    if (!nrefs) {
+      return iwrc_set_errno(IW_ERROR_ALLOC, errno);
+    }
+    pctx->refs = nrefs;
+    pctx->refs_asz = nsz;
+  }
+  pctx->refs[pctx->refs_num++] = *ref;
+  return 0;
+}
+
+// Marks joined refs known to be missing in joined nodes cache
+static struct jbl_node _jql_proj_join_missing;
+
+// Fetches collected joined documents with single multi-get per joined collection
+// and puts them into joined nodes cache
+static iwrc _jql_proj_join_prefetch(PROJ_CTX *pctx) {
+  iwrc rc = 0;
+  IWHMAP *cache;
+  IWPOOL *pool, *tpool = 0;
+  int64_t *ids = 0;
+  JBL *jbls = 0;
+  JBEXEC *exec_ctx = pctx->exec_ctx;
+  struct jbdocref *refs = pctx->refs;
+  size_t num = pctx->refs_num;
+
+  RCC(rc, finish, _jql_proj_join_cache(exec_ctx, true, &cache, &pool));
+  qsort(refs, num, sizeof(refs[0]), jb_proj_node_cache_coll_cmp);
+  RCB(finish, ids = malloc(num * sizeof(ids[0])));
+  RCB(finish, jbls = malloc(num * sizeof(jbls[0])));
+  RCB(finish, tpool = iwpool_create(1024));
+
+  for (size_t i = 0, j; i < num; i = j) {
+    size_t cnt = 0;
+    const char *coll = refs[i].coll;
+    for (j = i; j < num && !strcmp(refs[j].coll, coll); ++j) {
+      if (!cnt || ids[cnt - 1] != refs[j].id) {
+        ids[cnt++] = refs[j].id;
+      }
+    }
+    rc = jb_collection_join_resolver_many(ids, cnt, coll, tpool, jbls, exec_ctx);
+    if (rc == IW_ERROR_NOT_EXISTS) { // All refs of missing collection are missing
+      rc = 0;
+      memset(jbls, 0, cnt * sizeof(jbls[0]));
+    }
+    RCGO(rc, finish);
+    for (size_t k = 0; k < cnt; ++k) {
+      JBL_NODE nn = &_jql_proj_join_missing;
+      if (jbls[k]) {
+        RCC(rc, finish, jbl_to_node(jbls[k], &nn, true, pool));
+      }
+      struct jbdocref *refkey = malloc(sizeof(*refkey));
+      RCGA(refkey, finish);
+      refkey->id = ids[k];
+      refkey->coll = coll;
+      rc = iwhmap_put(cache, refkey, nn);
+      if (rc) {
+        free(refkey);
+        goto finish;
+      }
+    }
+    iwpool_destroy(tpool);
+    RCB(finish, tpool = iwpool_create(1024));
+  }
+
+finish:
+  if (tpool) {
+    iwpool_destroy(tpool);
+  }
+  free(ids);
+  free(jbls);
+  return rc;
+}
+
 static bool _jql_proj_join_matched(
   int16_t lvl, JBL_NODE n,
   const char *key, int keylen,
@@ -1661,48 +1799,45 @@ static bool _jql_proj_join_matched(
       // Unable to convert current node value as int number
       return false;
     }
-    IWHMAP *cache = exec_ctx->proj_joined_nodes_cache;
-    IWPOOL *pool = exec_ctx->ux->pool;
-    if (!pool) {
-      pool = exec_ctx->proj_joined_nodes_pool;
-      if (!pool) {
-        pool = iwpool_create(512);
-        RCGA(pool, finish);
-        exec_ctx->proj_joined_nodes_pool = pool;
-      } else if (cache && (iwpool_used_size(pool) > 10UL * 1024 * 1024)) { // 10Mb
-        exec_ctx->proj_joined_nodes_cache = 0;
-        iwhmap_destroy(exec_ctx->proj_joined_nodes_cache);
-        cache = 0;
-        iwpool_destroy(pool);
-        pool = iwpool_create(1024UL * 1024); // 1Mb
-        RCGA(pool, finish);
-      }
-    }
-    if (!cache) {
-      RCB(finish, cache = iwhmap_create(jb_proj_node_cache_cmp, jb_proj_node_hash, jb_proj_node_kvfree));
-      exec_ctx->proj_joined_nodes_cache = cache;
-    }
+    IWHMAP *cache;
+    IWPOOL *pool;
     struct jbdocref ref = {
       .id = id,
       .coll = coll
     };
+    if (pctx->collect) {
+      cache = exec_ctx->proj_joined_nodes_cache;
+      if (!cache || !iwhmap_get(cache, &ref)) {
+        rc = _jql_proj_join_ref_add(pctx, &ref);
+      }
+      ret = false;
+      goto finish;
+    }
+    RCC(rc, finish, _jql_proj_join_cache(exec_ctx, false, &cache, &pool));
     nn = iwhmap_get(cache, &ref);
     if (!nn) {
       rc = jb_collection_join_resolver(id, coll, &jbl, exec_ctx);
-      if (rc) {
-        if ((rc == IW_ERROR_NOT_EXISTS) || (rc == IWKV_ERROR_NOTFOUND)) {
-          // If collection is not exists or record is not found just
-          // keep all untouched
-          rc = 0;
-          ret = false;
-        }
-        goto finish;
+      if ((rc == IW_ERROR_NOT_EXISTS) || (rc == IWKV_ERROR_NOTFOUND)) {
+        rc = 0;
+        nn = &_jql_proj_join_missing;
+      } else {
+        RCGO(rc, finish);
+        RCC(rc, finish, jbl_to_node(jbl, &nn, true, pool));
       }
-      RCC(rc, finish, jbl_to_node(jbl, &nn, true, pool));
       struct jbdocref *refkey = malloc(sizeof(*refkey));
       RCGA(refkey, finish);
       *refkey = ref;
-      RCC(rc, finish, iwhmap_put(cache, refkey, nn));
+      rc = iwhmap_put(cache, refkey, nn);
+      if (rc) {
+        free(refkey);
+        goto finish;
+      }
+    }
+    if (nn == &_jql_proj_join_missing) {
+      // If collection is not exists or record is not found just
+      // keep all untouched
+      ret = false;
+      goto finish;
     }
     jbn_apply_from(n, nn);
     proj->pos = lvl;
@@ -1731,7 +1866,13 @@ static jbn_visitor_cmd_t _jql_proj_visitor(int lvl, JBL_NODE n, const char *key,
     uint8_t flags = p->flags;
     JBL jbl = 0;
     bool matched;
-    if (flags & JQP_PROJECTION_FLAG_JOINS) {
+    if (pctx->collect) {
+      if (flags & JQP_PROJECTION_FLAG_JOINS) {
+        _jql_proj_join_matched((int16_t) lvl, n, keyptr, klidx, vctx, p, &jbl, rc);
+        RCRET(*rc);
+      }
+      continue;
+    } else if (flags & JQP_PROJECTION_FLAG_JOINS) {
       matched = _jql_proj_join_matched((int16_t) lvl, n, keyptr, klidx, vctx, p, &jbl, rc);
     } else {
       matched = _jql_proj_matched((int16_t) lvl, n, keyptr, klidx, vctx, p, rc);
@@ -1762,8 +1903,15 @@ static jbn_visitor_cmd_t _jql_proj_keep_visitor(
   return JBN_VCMD_DELETE;
 }
 
+static void _jql_project_reset(JQP_PROJECTION *proj) {
+  for (JQP_PROJECTION *p = proj; p; p = p->next) {
+    p->pos = -1;
+  }
+}
+
 static iwrc _jql_project(JBL_NODE root, JQL q, IWPOOL *pool, JBEXEC *exec_ctx) {
   iwrc rc;
+  bool joins = false;
   JQP_AUX *aux = q->aux;
   if (aux->has_exclude_all_projection) {
     jbn_data(root);
@@ -1783,6 +1931,9 @@ static iwrc _jql_project(JBL_NODE root, JQL q, IWPOOL *pool, JBEXEC *exec_ctx) {
   for (JQP_PROJECTION *p = proj; p; p = p->next) {
     p->pos = -1;
     p->cnt = 0;
+    if (p->flags & JQP_PROJECTION_FLAG_JOINS) {
+      joins = true;
+    }
     for (JQP_STRING *s = p->value; s; s = s->next) {
       if (s->flavour & JQP_STR_PLACEHOLDER) {
         if (s->opaque == 0 || ((JQVAL*) s->opaque)->type != JQVAL_STR) {
@@ -1797,6 +1948,20 @@ static iwrc _jql_project(JBL_NODE root, JQL q, IWPOOL *pool, JBEXEC *exec_ctx) {
     .op = &pctx
   };
 
+  if (joins && pctx.exec_ctx) {
+    // Collect references to joined documents not cached yet and fetch them in batch,
+    // projection pass below will find joined documents in cache.
+    pctx.collect = true;
+    rc = jbn_visit(root, 0, &vctx, _jql_proj_visitor);
+    pctx.collect = false;
+    if (!rc && pctx.refs_num) {
+      rc = _jql_proj_join_prefetch(&pctx);
+    }
+    free(pctx.refs);
+    RCGO(rc, finish);
+    _jql_project_reset(proj);
+  }
+
   RCC(rc, finish, jbn_visit(root, 0, &vctx, _jql_proj_visitor));
   if (aux->has_keep_projections) { // We have keep projections
     RCC(rc, finish, jbn_visit(root, 0, &vctx, _jql_proj_keep_visitor));
@@ -1878,6 +2043,10 @@ static const char* _ecodefn(locale_t locale, uint32_t ecode) {
       return "No collection specified in query (JQL_ERROR_NO_COLLECTION)";
     case JQL_ERROR_INVALID_PLACEHOLDER_VALUE_TYPE:
       return "Invalid type of placeholder value (JQL_ERROR_INVALID_PLACEHOLDER_VALUE_TYPE)";
+    case JQL_ERROR_GROUPBY_ALREADY_SET:
+      return "Group by clause already specified (JQL_ERROR_GROUPBY_ALREADY_SET)";
+    case JQL_ERROR_AGGREGATE_INCOMPATIBLE:
+      return "Aggregation cannot be combined with apply, delete or order by clauses (JQL_ERROR_AGGREGATE_INCOMPATIBLE)";
     default:
       break;
   }
@@ -60,6 +60,10 @@ typedef enum {
   JQL_ERROR_INVALID_PLACEHOLDER_VALUE_TYPE,
   /**< Invalid type of placeholder value
      (JQL_ERROR_INVALID_PLACEHOLDER_VALUE_TYPE) */
+  JQL_ERROR_GROUPBY_ALREADY_SET,            /**< Group by clause already specified (JQL_ERROR_GROUPBY_ALREADY_SET) */
+  JQL_ERROR_AGGREGATE_INCOMPATIBLE,
+  /**< Aggregation cannot be combined with apply, delete or order by clauses
+     (JQL_ERROR_AGGREGATE_INCOMPATIBLE) */
   _JQL_ERROR_END,
   _JQL_ERROR_UNMATCHED,
 } jql_ecode_t;
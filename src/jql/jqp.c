@@ -3,7 +3,7 @@
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
-#define YYRULECOUNT 63
+#define YYRULECOUNT 66
 #line 1 "./jqp.leg"
 
 #include "jqp.h"
@@ -38,7 +38,12 @@ static void _jqp_set_skip(struct _yycontext *yy, JQPUNIT *unit);
 static void _jqp_set_limit(struct _yycontext *yy, JQPUNIT *unit);
 static void _jqp_add_orderby(struct _yycontext *yy, JQPUNIT *unit);
 static void _jqp_set_aggregate_count(struct _yycontext *yy);
+static void _jqp_set_groupby(struct _yycontext *yy, JQPUNIT *unit);
+static void _jqp_set_distinct(struct _yycontext *yy);
+static void _jqp_set_aggregate_op(struct _yycontext *yy, jqp_agg_op_t op);
+static void _jqp_add_aggregate(struct _yycontext *yy, JQPUNIT *unit);
 static void _jqp_set_noidx(struct _yycontext *yy);
+static void _jqp_set_indexonly(struct _yycontext *yy);
 static void _jqp_set_inverse(struct _yycontext *yy);
 
 static JQPUNIT* _jqp_json_string(struct _yycontext *yy, const char *text);
@@ -346,45 +351,48 @@ YY_LOCAL(void) yySet(yycontext * yy, char *text, int count) {
 
 #define YYACCEPT yyAccept(yy, yythunkpos0)
 
-YY_RULE(int) yy_EOL(yycontext * yy);           /* 63 */
-YY_RULE(int) yy_SPACE(yycontext * yy);         /* 62 */
-YY_RULE(int) yy_NUME(yycontext * yy);          /* 61 */
-YY_RULE(int) yy_NUMF(yycontext * yy);          /* 60 */
-YY_RULE(int) yy_NUMJ(yycontext * yy);          /* 59 */
-YY_RULE(int) yy_STRJ(yycontext * yy);          /* 58 */
-YY_RULE(int) yy_SARRJ(yycontext * yy);         /* 57 */
-YY_RULE(int) yy_PAIRJ(yycontext * yy);         /* 56 */
-YY_RULE(int) yy_SOBJJ(yycontext * yy);         /* 55 */
-YY_RULE(int) yy_CHJ(yycontext * yy);           /* 54 */
-YY_RULE(int) yy_CHP(yycontext * yy);           /* 53 */
-YY_RULE(int) yy_VALJ(yycontext * yy);          /* 52 */
-YY_RULE(int) yy_NEXPRLEFT(yycontext * yy);     /* 51 */
-YY_RULE(int) yy_STRSTAR(yycontext * yy);       /* 50 */
-YY_RULE(int) yy_DBLSTAR(yycontext * yy);       /* 49 */
-YY_RULE(int) yy_NEXRIGHT(yycontext * yy);      /* 48 */
-YY_RULE(int) yy_NEXOP(yycontext * yy);         /* 47 */
-YY_RULE(int) yy_NEXLEFT(yycontext * yy);       /* 46 */
-YY_RULE(int) yy_NEXJOIN(yycontext * yy);       /* 45 */
-YY_RULE(int) yy_NEXPAIR(yycontext * yy);       /* 44 */
-YY_RULE(int) yy_STRP(yycontext * yy);          /* 43 */
-YY_RULE(int) yy_NEXPR(yycontext * yy);         /* 42 */
-YY_RULE(int) yy_NODE(yycontext * yy);          /* 41 */
-YY_RULE(int) yy_FILTER(yycontext * yy);        /* 40 */
-YY_RULE(int) yy_FILTERFACTOR(yycontext * yy);  /* 39 */
-YY_RULE(int) yy_HEX(yycontext * yy);           /* 38 */
-YY_RULE(int) yy_PCHP(yycontext * yy);          /* 37 */
-YY_RULE(int) yy_PSTRP(yycontext * yy);         /* 36 */
-YY_RULE(int) yy_STRN(yycontext * yy);          /* 35 */
-YY_RULE(int) yy_PROJFIELDS(yycontext * yy);    /* 34 */
-YY_RULE(int) yy_PROJNODE(yycontext * yy);      /* 33 */
-YY_RULE(int) yy_PROJALL(yycontext * yy);       /* 32 */
-YY_RULE(int) yy_PROJPROP(yycontext * yy);      /* 31 */
-YY_RULE(int) yy_ORDERNODE(yycontext * yy);     /* 30 */
-YY_RULE(int) yy_ORDERNODES(yycontext * yy);    /* 29 */
-YY_RULE(int) yy_NUMI(yycontext * yy);          /* 28 */
-YY_RULE(int) yy_INVERSE(yycontext * yy);       /* 27 */
-YY_RULE(int) yy_NOIDX(yycontext * yy);         /* 26 */
-YY_RULE(int) yy_COUNT(yycontext * yy);         /* 25 */
+YY_RULE(int) yy_EOL(yycontext * yy);           /* 66 */
+YY_RULE(int) yy_SPACE(yycontext * yy);         /* 65 */
+YY_RULE(int) yy_NUME(yycontext * yy);          /* 64 */
+YY_RULE(int) yy_NUMF(yycontext * yy);          /* 63 */
+YY_RULE(int) yy_NUMJ(yycontext * yy);          /* 62 */
+YY_RULE(int) yy_STRJ(yycontext * yy);          /* 61 */
+YY_RULE(int) yy_SARRJ(yycontext * yy);         /* 60 */
+YY_RULE(int) yy_PAIRJ(yycontext * yy);         /* 59 */
+YY_RULE(int) yy_SOBJJ(yycontext * yy);         /* 58 */
+YY_RULE(int) yy_CHJ(yycontext * yy);           /* 57 */
+YY_RULE(int) yy_CHP(yycontext * yy);           /* 56 */
+YY_RULE(int) yy_VALJ(yycontext * yy);          /* 55 */
+YY_RULE(int) yy_NEXPRLEFT(yycontext * yy);     /* 54 */
+YY_RULE(int) yy_STRSTAR(yycontext * yy);       /* 53 */
+YY_RULE(int) yy_DBLSTAR(yycontext * yy);       /* 52 */
+YY_RULE(int) yy_NEXRIGHT(yycontext * yy);      /* 51 */
+YY_RULE(int) yy_NEXOP(yycontext * yy);         /* 50 */
+YY_RULE(int) yy_NEXLEFT(yycontext * yy);       /* 49 */
+YY_RULE(int) yy_NEXJOIN(yycontext * yy);       /* 48 */
+YY_RULE(int) yy_NEXPAIR(yycontext * yy);       /* 47 */
+YY_RULE(int) yy_STRP(yycontext * yy);          /* 46 */
+YY_RULE(int) yy_NEXPR(yycontext * yy);         /* 45 */
+YY_RULE(int) yy_NODE(yycontext * yy);          /* 44 */
+YY_RULE(int) yy_FILTER(yycontext * yy);        /* 43 */
+YY_RULE(int) yy_FILTERFACTOR(yycontext * yy);  /* 42 */
+YY_RULE(int) yy_HEX(yycontext * yy);           /* 41 */
+YY_RULE(int) yy_PCHP(yycontext * yy);          /* 40 */
+YY_RULE(int) yy_PSTRP(yycontext * yy);         /* 39 */
+YY_RULE(int) yy_STRN(yycontext * yy);          /* 38 */
+YY_RULE(int) yy_PROJFIELDS(yycontext * yy);    /* 37 */
+YY_RULE(int) yy_PROJNODE(yycontext * yy);      /* 36 */
+YY_RULE(int) yy_PROJALL(yycontext * yy);       /* 35 */
+YY_RULE(int) yy_PROJPROP(yycontext * yy);      /* 34 */
+YY_RULE(int) yy_ORDERNODE(yycontext * yy);     /* 33 */
+YY_RULE(int) yy_ORDERNODES(yycontext * yy);    /* 32 */
+YY_RULE(int) yy_NUMI(yycontext * yy);          /* 31 */
+YY_RULE(int) yy_INVERSE(yycontext * yy);       /* 30 */
+YY_RULE(int) yy_INDEXONLY(yycontext * yy);     /* 29 */
+YY_RULE(int) yy_NOIDX(yycontext * yy);         /* 28 */
+YY_RULE(int) yy_COUNT(yycontext * yy);         /* 27 */
+YY_RULE(int) yy_AGGREGATE(yycontext * yy);     /* 26 */
+YY_RULE(int) yy_GROUPBY(yycontext * yy);       /* 25 */
 YY_RULE(int) yy_ORDERBY(yycontext * yy);       /* 24 */
 YY_RULE(int) yy_LIMIT(yycontext * yy);         /* 23 */
 YY_RULE(int) yy_SKIP(yycontext * yy);          /* 22 */
@@ -419,7 +427,7 @@ YY_ACTION(void) yy_4_NUMPK_ARR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_4_NUMPK_ARR\n"));
   {
-#line 235
+#line 250
     __ = _jqp_json_collect(yy, JBV_ARRAY, s);
     ;
   }
@@ -439,7 +447,7 @@ YY_ACTION(void) yy_3_NUMPK_ARR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_3_NUMPK_ARR\n"));
   {
-#line 234
+#line 249
     _jqp_unit_push(yy, v);
     ;
   }
@@ -459,7 +467,7 @@ YY_ACTION(void) yy_2_NUMPK_ARR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_NUMPK_ARR\n"));
   {
-#line 234
+#line 249
     _jqp_unit_push(yy, fv);
     ;
   }
@@ -479,7 +487,7 @@ YY_ACTION(void) yy_1_NUMPK_ARR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_NUMPK_ARR\n"));
   {
-#line 233
+#line 248
     _jqp_unit_push(yy, s);
     ;
   }
@@ -496,7 +504,7 @@ YY_ACTION(void) yy_1_NUMPK(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_NUMPK\n"));
   {
-#line 231
+#line 246
     __ = _jqp_json_number(yy, yytext);
     ;
   }
@@ -510,7 +518,7 @@ YY_ACTION(void) yy_1_NUMJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_NUMJ\n"));
   {
-#line 229
+#line 244
     __ = _jqp_json_number(yy, yytext);
     ;
   }
@@ -524,7 +532,7 @@ YY_ACTION(void) yy_1_STRJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_STRJ\n"));
   {
-#line 214
+#line 229
     __ = _jqp_json_string(yy, yytext);
     ;
   }
@@ -538,7 +546,7 @@ YY_ACTION(void) yy_3_VALJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_3_VALJ\n"));
   {
-#line 212
+#line 227
     __ = _jqp_json_true_false_null(yy, "null");
     ;
   }
@@ -552,7 +560,7 @@ YY_ACTION(void) yy_2_VALJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_VALJ\n"));
   {
-#line 211
+#line 226
     __ = _jqp_json_true_false_null(yy, "false");
     ;
   }
@@ -566,7 +574,7 @@ YY_ACTION(void) yy_1_VALJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_VALJ\n"));
   {
-#line 210
+#line 225
     __ = _jqp_json_true_false_null(yy, "true");
     ;
   }
@@ -582,7 +590,7 @@ YY_ACTION(void) yy_1_PAIRJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_PAIRJ\n"));
   {
-#line 204
+#line 219
     __ = _jqp_json_pair(yy, s, v);
     ;
   }
@@ -598,7 +606,7 @@ YY_ACTION(void) yy_1_SARRJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_SARRJ\n"));
   {
-#line 202
+#line 217
     __ = _jqp_unit(yy);
     ;
   }
@@ -612,7 +620,7 @@ YY_ACTION(void) yy_1_SOBJJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_SOBJJ\n"));
   {
-#line 200
+#line 215
     __ = _jqp_unit(yy);
     ;
   }
@@ -629,7 +637,7 @@ YY_ACTION(void) yy_4_ARRJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_4_ARRJ\n"));
   {
-#line 198
+#line 213
     __ = _jqp_json_collect(yy, JBV_ARRAY, s);
     ;
   }
@@ -649,7 +657,7 @@ YY_ACTION(void) yy_3_ARRJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_3_ARRJ\n"));
   {
-#line 197
+#line 212
     _jqp_unit_push(yy, v);
     ;
   }
@@ -669,7 +677,7 @@ YY_ACTION(void) yy_2_ARRJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_ARRJ\n"));
   {
-#line 197
+#line 212
     _jqp_unit_push(yy, fv);
     ;
   }
@@ -689,7 +697,7 @@ YY_ACTION(void) yy_1_ARRJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_ARRJ\n"));
   {
-#line 196
+#line 211
     _jqp_unit_push(yy, s);
     ;
   }
@@ -709,7 +717,7 @@ YY_ACTION(void) yy_4_OBJJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_4_OBJJ\n"));
   {
-#line 194
+#line 209
     __ = _jqp_json_collect(yy, JBV_OBJECT, s);
     ;
   }
@@ -729,7 +737,7 @@ YY_ACTION(void) yy_3_OBJJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_3_OBJJ\n"));
   {
-#line 193
+#line 208
     _jqp_unit_push(yy, p);
     ;
   }
@@ -749,7 +757,7 @@ YY_ACTION(void) yy_2_OBJJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_OBJJ\n"));
   {
-#line 193
+#line 208
     _jqp_unit_push(yy, fp);
     ;
   }
@@ -769,7 +777,7 @@ YY_ACTION(void) yy_1_OBJJ(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_OBJJ\n"));
   {
-#line 192
+#line 207
     _jqp_unit_push(yy, s);
     ;
   }
@@ -786,7 +794,7 @@ YY_ACTION(void) yy_1_STRN(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_STRN\n"));
   {
-#line 190
+#line 205
     __ = _jqp_unescaped_string(yy, JQP_STR_QUOTED, yytext);
     ;
   }
@@ -800,7 +808,7 @@ YY_ACTION(void) yy_1_STRSTAR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_STRSTAR\n"));
   {
-#line 188
+#line 203
     __ = _jqp_unescaped_string(yy, JQP_STR_STAR, "*");
     ;
   }
@@ -814,7 +822,7 @@ YY_ACTION(void) yy_1_DBLSTAR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_DBLSTAR\n"));
   {
-#line 186
+#line 201
     __ = _jqp_unescaped_string(yy, JQP_STR_DBL_STAR, "**");
     ;
   }
@@ -828,7 +836,7 @@ YY_ACTION(void) yy_1_STRP(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_STRP\n"));
   {
-#line 184
+#line 199
     __ = _jqp_unescaped_string(yy, 0, yytext);
     ;
   }
@@ -842,7 +850,7 @@ YY_ACTION(void) yy_9_NEXOP(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_9_NEXOP\n"));
   {
-#line 182
+#line 197
     __ = _jqp_unit_op(yy, yytext);
     ;
   }
@@ -856,7 +864,7 @@ YY_ACTION(void) yy_8_NEXOP(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_8_NEXOP\n"));
   {
-#line 181
+#line 196
     __ = _jqp_unit_op(yy, yytext);
     ;
   }
@@ -870,7 +878,7 @@ YY_ACTION(void) yy_7_NEXOP(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_7_NEXOP\n"));
   {
-#line 180
+#line 195
     __ = _jqp_unit_op(yy, yytext);
     ;
   }
@@ -884,7 +892,7 @@ YY_ACTION(void) yy_6_NEXOP(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_6_NEXOP\n"));
   {
-#line 179
+#line 194
     __ = _jqp_unit_op(yy, yytext);
     ;
   }
@@ -898,7 +906,7 @@ YY_ACTION(void) yy_5_NEXOP(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_5_NEXOP\n"));
   {
-#line 179
+#line 194
     _jqp_op_negate(yy);
     ;
   }
@@ -912,7 +920,7 @@ YY_ACTION(void) yy_4_NEXOP(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_4_NEXOP\n"));
   {
-#line 178
+#line 193
     __ = _jqp_unit_op(yy, yytext);
     ;
   }
@@ -926,7 +934,7 @@ YY_ACTION(void) yy_3_NEXOP(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_3_NEXOP\n"));
   {
-#line 177
+#line 192
     __ = _jqp_unit_op(yy, yytext);
     ;
   }
@@ -940,7 +948,7 @@ YY_ACTION(void) yy_2_NEXOP(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_NEXOP\n"));
   {
-#line 176
+#line 191
     __ = _jqp_unit_op(yy, yytext);
     ;
   }
@@ -954,7 +962,7 @@ YY_ACTION(void) yy_1_NEXOP(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_NEXOP\n"));
   {
-#line 176
+#line 191
     _jqp_op_negate(yy);
     ;
   }
@@ -968,7 +976,7 @@ YY_ACTION(void) yy_1_PLACEHOLDER(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_PLACEHOLDER\n"));
   {
-#line 174
+#line 189
     __ = _jqp_placeholder(yy, yytext);
     ;
   }
@@ -985,7 +993,7 @@ YY_ACTION(void) yy_1_NEXPRLEFT(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_NEXPRLEFT\n"));
   {
-#line 170
+#line 185
     __ = _jqp_expr(yy, l, o, r);
     ;
   }
@@ -1005,7 +1013,7 @@ YY_ACTION(void) yy_1_NEXPAIR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_NEXPAIR\n"));
   {
-#line 166
+#line 181
     __ = _jqp_expr(yy, l, o, r);
     ;
   }
@@ -1022,7 +1030,7 @@ YY_ACTION(void) yy_2_NEXJOIN(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_NEXJOIN\n"));
   {
-#line 164
+#line 179
     __ = _jqp_unit_join(yy, yytext);
     ;
   }
@@ -1036,7 +1044,7 @@ YY_ACTION(void) yy_1_NEXJOIN(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_NEXJOIN\n"));
   {
-#line 164
+#line 179
     _jqp_op_negate(yy);
     ;
   }
@@ -1053,7 +1061,7 @@ YY_ACTION(void) yy_4_NEXPR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_4_NEXPR\n"));
   {
-#line 162
+#line 177
     __ = _jqp_pop_expr_chain(yy, n);
     ;
   }
@@ -1073,7 +1081,7 @@ YY_ACTION(void) yy_3_NEXPR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_3_NEXPR\n"));
   {
-#line 161
+#line 176
     _jqp_unit_push(yy, np);
     ;
   }
@@ -1093,7 +1101,7 @@ YY_ACTION(void) yy_2_NEXPR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_NEXPR\n"));
   {
-#line 161
+#line 176
     _jqp_unit_push(yy, j);
     ;
   }
@@ -1113,7 +1121,7 @@ YY_ACTION(void) yy_1_NEXPR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_NEXPR\n"));
   {
-#line 160
+#line 175
     _jqp_unit_push(yy, n);
     ;
   }
@@ -1131,7 +1139,7 @@ YY_ACTION(void) yy_1_NODE(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_NODE\n"));
   {
-#line 158
+#line 173
     __ = _jqp_node(yy, n);
     ;
   }
@@ -1146,7 +1154,7 @@ YY_ACTION(void) yy_1_FILTERANCHOR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_FILTERANCHOR\n"));
   {
-#line 155
+#line 170
     __ = _jqp_string(yy, JQP_STR_ANCHOR, yytext);
     ;
   }
@@ -1163,7 +1171,7 @@ YY_ACTION(void) yy_4_FILTER(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_4_FILTER\n"));
   {
-#line 153
+#line 168
     __ = _jqp_pop_node_chain(yy, fn);
     ;
   }
@@ -1183,7 +1191,7 @@ YY_ACTION(void) yy_3_FILTER(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_3_FILTER\n"));
   {
-#line 153
+#line 168
     _jqp_unit_push(yy, n);
     ;
   }
@@ -1203,7 +1211,7 @@ YY_ACTION(void) yy_2_FILTER(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_FILTER\n"));
   {
-#line 153
+#line 168
     _jqp_unit_push(yy, fn);
     ;
   }
@@ -1223,7 +1231,7 @@ YY_ACTION(void) yy_1_FILTER(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_FILTER\n"));
   {
-#line 153
+#line 168
     _jqp_unit_push(yy, a);
     ;
   }
@@ -1243,7 +1251,7 @@ YY_ACTION(void) yy_4_FILTEREXPR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_4_FILTEREXPR\n"));
   {
-#line 151
+#line 166
     __ = _jqp_pop_filter_factor_chain(yy, ff);
     ;
   }
@@ -1263,7 +1271,7 @@ YY_ACTION(void) yy_3_FILTEREXPR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_3_FILTEREXPR\n"));
   {
-#line 151
+#line 166
     _jqp_unit_push(yy, f);
     ;
   }
@@ -1283,7 +1291,7 @@ YY_ACTION(void) yy_2_FILTEREXPR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_FILTEREXPR\n"));
   {
-#line 151
+#line 166
     _jqp_unit_push(yy, j);
     ;
   }
@@ -1303,7 +1311,7 @@ YY_ACTION(void) yy_1_FILTEREXPR(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_FILTEREXPR\n"));
   {
-#line 150
+#line 165
     _jqp_unit_push(yy, ff);
     ;
   }
@@ -1320,7 +1328,7 @@ YY_ACTION(void) yy_1_PSTRP(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_PSTRP\n"));
   {
-#line 140
+#line 155
     __ = _jqp_string(yy, 0, yytext);
     ;
   }
@@ -1336,7 +1344,7 @@ YY_ACTION(void) yy_3_PROJFIELDS(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_3_PROJFIELDS\n"));
   {
-#line 134
+#line 149
     __ = _jqp_pop_projfields_chain(yy, sp);
     ;
   }
@@ -1354,7 +1362,7 @@ YY_ACTION(void) yy_2_PROJFIELDS(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_PROJFIELDS\n"));
   {
-#line 133
+#line 148
     _jqp_unit_push(yy, p);
     ;
   }
@@ -1372,7 +1380,7 @@ YY_ACTION(void) yy_1_PROJFIELDS(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_PROJFIELDS\n"));
   {
-#line 133
+#line 148
     _jqp_unit_push(yy, sp);
     ;
   }
@@ -1388,7 +1396,7 @@ YY_ACTION(void) yy_1_PROJALL(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_PROJALL\n"));
   {
-#line 129
+#line 144
     __ = _jqp_string(yy, JQP_STR_PROJALIAS, "all");
     ;
   }
@@ -1405,7 +1413,7 @@ YY_ACTION(void) yy_4_PROJNODES(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_4_PROJNODES\n"));
   {
-#line 127
+#line 142
     __ = _jqp_pop_projection_nodes(yy, sn);
     ;
   }
@@ -1425,7 +1433,7 @@ YY_ACTION(void) yy_3_PROJNODES(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_3_PROJNODES\n"));
   {
-#line 127
+#line 142
     _jqp_unit_push(yy, n);
     ;
   }
@@ -1445,7 +1453,7 @@ YY_ACTION(void) yy_2_PROJNODES(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_PROJNODES\n"));
   {
-#line 127
+#line 142
     _jqp_unit_push(yy, sn);
     ;
   }
@@ -1465,7 +1473,7 @@ YY_ACTION(void) yy_1_PROJNODES(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_PROJNODES\n"));
   {
-#line 126
+#line 141
     __ = _jqp_projection(yy, a, 0);
     ;
   }
@@ -1484,7 +1492,7 @@ YY_ACTION(void) yy_3_ORDERNODES(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_3_ORDERNODES\n"));
   {
-#line 122
+#line 137
     __ = _jqp_pop_ordernodes(yy, sn);
   }
 #undef yythunkpos
@@ -1501,7 +1509,7 @@ YY_ACTION(void) yy_2_ORDERNODES(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_ORDERNODES\n"));
   {
-#line 122
+#line 137
     _jqp_unit_push(yy, n);
     ;
   }
@@ -1519,7 +1527,7 @@ YY_ACTION(void) yy_1_ORDERNODES(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_ORDERNODES\n"));
   {
-#line 122
+#line 137
     _jqp_unit_push(yy, sn);
     ;
   }
@@ -1536,7 +1544,7 @@ YY_ACTION(void) yy_2_ORDERBY(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_ORDERBY\n"));
   {
-#line 120
+#line 135
     p->string.flavour |= (yy->aux->negate ? JQP_STR_NEGATE : 0);
     _jqp_op_negate_reset(yy);
     _jqp_add_orderby(yy, p);
@@ -1554,7 +1562,7 @@ YY_ACTION(void) yy_1_ORDERBY(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_ORDERBY\n"));
   {
-#line 118
+#line 133
     _jqp_op_negate(yy);
     ;
   }
@@ -1563,13 +1571,125 @@ YY_ACTION(void) yy_1_ORDERBY(yycontext * yy, char *yytext, int yyleng) {
 #undef yy
 #undef p
 }
+YY_ACTION(void) yy_5_AGGREGATE(yycontext * yy, char *yytext, int yyleng) {
+#define p          yy->__val[-1]
+#define __         yy->__
+#define yypos      yy->__pos
+#define yythunkpos yy->__thunkpos
+  yyprintf((stderr, "do yy_5_AGGREGATE\n"));
+  {
+#line 131
+    _jqp_add_aggregate(yy, p);
+    ;
+  }
+#undef yythunkpos
+#undef yypos
+#undef yy
+#undef p
+}
+YY_ACTION(void) yy_4_AGGREGATE(yycontext * yy, char *yytext, int yyleng) {
+#define p          yy->__val[-1]
+#define __         yy->__
+#define yypos      yy->__pos
+#define yythunkpos yy->__thunkpos
+  yyprintf((stderr, "do yy_4_AGGREGATE\n"));
+  {
+#line 130
+    _jqp_set_aggregate_op(yy, JQP_AGG_AVG);
+    ;
+  }
+#undef yythunkpos
+#undef yypos
+#undef yy
+#undef p
+}
+YY_ACTION(void) yy_3_AGGREGATE(yycontext * yy, char *yytext, int yyleng) {
+#define p          yy->__val[-1]
+#define __         yy->__
+#define yypos      yy->__pos
+#define yythunkpos yy->__thunkpos
+  yyprintf((stderr, "do yy_3_AGGREGATE\n"));
+  {
+#line 129
+    _jqp_set_aggregate_op(yy, JQP_AGG_MAX);
+    ;
+  }
+#undef yythunkpos
+#undef yypos
+#undef yy
+#undef p
+}
+YY_ACTION(void) yy_2_AGGREGATE(yycontext * yy, char *yytext, int yyleng) {
+#define p          yy->__val[-1]
+#define __         yy->__
+#define yypos      yy->__pos
+#define yythunkpos yy->__thunkpos
+  yyprintf((stderr, "do yy_2_AGGREGATE\n"));
+  {
+#line 128
+    _jqp_set_aggregate_op(yy, JQP_AGG_MIN);
+    ;
+  }
+#undef yythunkpos
+#undef yypos
+#undef yy
+#undef p
+}
+YY_ACTION(void) yy_1_AGGREGATE(yycontext * yy, char *yytext, int yyleng) {
+#define p          yy->__val[-1]
+#define __         yy->__
+#define yypos      yy->__pos
+#define yythunkpos yy->__thunkpos
+  yyprintf((stderr, "do yy_1_AGGREGATE\n"));
+  {
+#line 127
+    _jqp_set_aggregate_op(yy, JQP_AGG_SUM);
+    ;
+  }
+#undef yythunkpos
+#undef yypos
+#undef yy
+#undef p
+}
+YY_ACTION(void) yy_2_GROUPBY(yycontext * yy, char *yytext, int yyleng) {
+#define p          yy->__val[-1]
+#define __         yy->__
+#define yypos      yy->__pos
+#define yythunkpos yy->__thunkpos
+  yyprintf((stderr, "do yy_2_GROUPBY\n"));
+  {
+#line 125
+    _jqp_set_groupby(yy, p);
+    ;
+  }
+#undef yythunkpos
+#undef yypos
+#undef yy
+#undef p
+}
+YY_ACTION(void) yy_1_GROUPBY(yycontext * yy, char *yytext, int yyleng) {
+#define p          yy->__val[-1]
+#define __         yy->__
+#define yypos      yy->__pos
+#define yythunkpos yy->__thunkpos
+  yyprintf((stderr, "do yy_1_GROUPBY\n"));
+  {
+#line 125
+    _jqp_set_distinct(yy);
+    ;
+  }
+#undef yythunkpos
+#undef yypos
+#undef yy
+#undef p
+}
 YY_ACTION(void) yy_1_INVERSE(yycontext * yy, char *yytext, int yyleng) {
 #define __         yy->__
 #define yypos      yy->__pos
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_INVERSE\n"));
   {
-#line 116
+#line 123
     _jqp_set_inverse(yy);
     ;
   }
@@ -1577,13 +1697,27 @@ YY_ACTION(void) yy_1_INVERSE(yycontext * yy, char *yytext, int yyleng) {
 #undef yypos
 #undef yy
 }
+YY_ACTION(void) yy_1_INDEXONLY(yycontext * yy, char *yytext, int yyleng) {
+#define __         yy->__
+#define yypos      yy->__pos
+#define yythunkpos yy->__thunkpos
+  yyprintf((stderr, "do yy_1_INDEXONLY\n"));
+  {
+#line 121
+    _jqp_set_indexonly(yy);
+    ;
+  }
+#undef yythunkpos
+#undef yypos
+#undef yy
+}
 YY_ACTION(void) yy_1_NOIDX(yycontext * yy, char *yytext, int yyleng) {
 #define __         yy->__
 #define yypos      yy->__pos
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_NOIDX\n"));
   {
-#line 114
+#line 119
     _jqp_set_noidx(yy);
     ;
   }
@@ -1597,7 +1731,7 @@ YY_ACTION(void) yy_1_COUNT(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_COUNT\n"));
   {
-#line 112
+#line 117
     _jqp_set_aggregate_count(yy);
     ;
   }
@@ -1612,7 +1746,7 @@ YY_ACTION(void) yy_3_LIMIT(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_3_LIMIT\n"));
   {
-#line 110
+#line 115
     _jqp_set_limit(yy, __);
     ;
   }
@@ -1628,7 +1762,7 @@ YY_ACTION(void) yy_2_LIMIT(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_LIMIT\n"));
   {
-#line 110
+#line 115
     __ = p;
     ;
   }
@@ -1644,7 +1778,7 @@ YY_ACTION(void) yy_1_LIMIT(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_LIMIT\n"));
   {
-#line 110
+#line 115
     __ = _jqp_number(yy, JQP_INT_LIMIT, yytext);
     ;
   }
@@ -1660,7 +1794,7 @@ YY_ACTION(void) yy_3_SKIP(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_3_SKIP\n"));
   {
-#line 108
+#line 113
     _jqp_set_skip(yy, __);
     ;
   }
@@ -1676,7 +1810,7 @@ YY_ACTION(void) yy_2_SKIP(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_SKIP\n"));
   {
-#line 108
+#line 113
     __ = p;
     ;
   }
@@ -1692,7 +1826,7 @@ YY_ACTION(void) yy_1_SKIP(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_SKIP\n"));
   {
-#line 108
+#line 113
     __ = _jqp_number(yy, JQP_INT_SKIP, yytext);
     ;
   }
@@ -1709,7 +1843,7 @@ YY_ACTION(void) yy_4_PROJECTION(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_4_PROJECTION\n"));
   {
-#line 102
+#line 107
     __ = _jqp_pop_joined_projections(yy, sn);
     ;
   }
@@ -1727,7 +1861,7 @@ YY_ACTION(void) yy_3_PROJECTION(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_3_PROJECTION\n"));
   {
-#line 101
+#line 106
     _jqp_push_joined_projection(yy, n);
     ;
   }
@@ -1745,7 +1879,7 @@ YY_ACTION(void) yy_2_PROJECTION(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_PROJECTION\n"));
   {
-#line 101
+#line 106
     _jqp_string_push(yy, yytext, true);
     ;
   }
@@ -1763,7 +1897,7 @@ YY_ACTION(void) yy_1_PROJECTION(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_PROJECTION\n"));
   {
-#line 100
+#line 105
     _jqp_unit_push(yy, sn);
     ;
   }
@@ -1779,7 +1913,7 @@ YY_ACTION(void) yy_2_FILTERJOIN(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_FILTERJOIN\n"));
   {
-#line 94
+#line 99
     __ = _jqp_unit_join(yy, yytext);
     ;
   }
@@ -1793,7 +1927,7 @@ YY_ACTION(void) yy_1_FILTERJOIN(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_FILTERJOIN\n"));
   {
-#line 94
+#line 99
     _jqp_op_negate(yy);
     ;
   }
@@ -1809,7 +1943,7 @@ YY_ACTION(void) yy_2_FILTEREXPR_PK(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_FILTEREXPR_PK\n"));
   {
-#line 92
+#line 97
     __ = _jqp_create_filterexpr_pk(yy, p);
   }
 #undef yythunkpos
@@ -1826,7 +1960,7 @@ YY_ACTION(void) yy_1_FILTEREXPR_PK(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_FILTEREXPR_PK\n"));
   {
-#line 90
+#line 95
     _jqp_unit_push(yy, a);
     ;
   }
@@ -1846,7 +1980,7 @@ YY_ACTION(void) yy_6_QUERY(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_6_QUERY\n"));
   {
-#line 86
+#line 91
     _jqp_finish(yy);
     ;
   }
@@ -1868,7 +2002,7 @@ YY_ACTION(void) yy_5_QUERY(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_5_QUERY\n"));
   {
-#line 84
+#line 89
     _jqp_set_projection(yy, p);
     ;
   }
@@ -1890,7 +2024,7 @@ YY_ACTION(void) yy_4_QUERY(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_4_QUERY\n"));
   {
-#line 83
+#line 88
     _jqp_set_apply_upsert(yy, u);
     ;
   }
@@ -1912,7 +2046,7 @@ YY_ACTION(void) yy_3_QUERY(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_3_QUERY\n"));
   {
-#line 83
+#line 88
     _jqp_set_apply_delete(yy);
     ;
   }
@@ -1934,7 +2068,7 @@ YY_ACTION(void) yy_2_QUERY(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_2_QUERY\n"));
   {
-#line 83
+#line 88
     _jqp_set_apply(yy, a);
     ;
   }
@@ -1956,7 +2090,7 @@ YY_ACTION(void) yy_1_QUERY(yycontext * yy, char *yytext, int yyleng) {
 #define yythunkpos yy->__thunkpos
   yyprintf((stderr, "do yy_1_QUERY\n"));
   {
-#line 82
+#line 87
     _jqp_set_filters_expr(yy, s);
     ;
   }
@@ -2727,6 +2861,14 @@ l65:
       yy->__pos = yypos63;
       yy->__thunkpos = yythunkpos63;
       if (!yymatchString(yy, "re")) {
+        goto l249;
+      }
+      goto l63;
+l249:
+      ;
+      yy->__pos = yypos63;
+      yy->__thunkpos = yythunkpos63;
+      if (!yymatchString(yy, "match")) {
         goto l60;
       }
     }
@@ -3843,6 +3985,22 @@ l147:
   yyprintf((stderr, "  fail %s @ %s\n", "INVERSE", yy->__buf + yy->__pos));
   return 0;
 }
+YY_RULE(int) yy_INDEXONLY(yycontext * yy) {
+  int yypos0 = yy->__pos, yythunkpos0 = yy->__thunkpos;
+  yyprintf((stderr, "%s\n", "INDEXONLY"));
+  if (!yymatchString(yy, "indexonly")) {
+    goto l260;
+  }
+  yyDo(yy, yy_1_INDEXONLY, yy->__begin, yy->__end);
+  yyprintf((stderr, "  ok   %s @ %s\n", "INDEXONLY", yy->__buf + yy->__pos));
+  return 1;
+l260:
+  ;
+  yy->__pos = yypos0;
+  yy->__thunkpos = yythunkpos0;
+  yyprintf((stderr, "  fail %s @ %s\n", "INDEXONLY", yy->__buf + yy->__pos));
+  return 0;
+}
 YY_RULE(int) yy_NOIDX(yycontext * yy) {
   int yypos0 = yy->__pos, yythunkpos0 = yy->__thunkpos;
   yyprintf((stderr, "%s\n", "NOIDX"));
@@ -3875,6 +4033,103 @@ l149:
   yyprintf((stderr, "  fail %s @ %s\n", "COUNT", yy->__buf + yy->__pos));
   return 0;
 }
+YY_RULE(int) yy_AGGREGATE(yycontext * yy) {
+  int yypos0 = yy->__pos, yythunkpos0 = yy->__thunkpos;
+  yyDo(yy, yyPush, 1, 0);
+  yyprintf((stderr, "%s\n", "AGGREGATE"));
+  {
+    int yypos254 = yy->__pos, yythunkpos254 = yy->__thunkpos;
+    if (!yymatchString(yy, "sum")) {
+      goto l255;
+    }
+    yyDo(yy, yy_1_AGGREGATE, yy->__begin, yy->__end);
+    goto l254;
+l255:
+    ;
+    yy->__pos = yypos254;
+    yy->__thunkpos = yythunkpos254;
+    if (!yymatchString(yy, "min")) {
+      goto l256;
+    }
+    yyDo(yy, yy_2_AGGREGATE, yy->__begin, yy->__end);
+    goto l254;
+l256:
+    ;
+    yy->__pos = yypos254;
+    yy->__thunkpos = yythunkpos254;
+    if (!yymatchString(yy, "max")) {
+      goto l257;
+    }
+    yyDo(yy, yy_3_AGGREGATE, yy->__begin, yy->__end);
+    goto l254;
+l257:
+    ;
+    yy->__pos = yypos254;
+    yy->__thunkpos = yythunkpos254;
+    if (!yymatchString(yy, "avg")) {
+      goto l253;
+    }
+    yyDo(yy, yy_4_AGGREGATE, yy->__begin, yy->__end);
+  }
+l254:
+  ;
+  if (!yy___(yy)) {
+    goto l253;
+  }
+  if (!yy_ORDERNODES(yy)) {
+    goto l253;
+  }
+  yyDo(yy, yySet, -1, 0);
+  yyDo(yy, yy_5_AGGREGATE, yy->__begin, yy->__end);
+  yyprintf((stderr, "  ok   %s @ %s\n", "AGGREGATE", yy->__buf + yy->__pos));
+  yyDo(yy, yyPop, 1, 0);
+  return 1;
+l253:
+  ;
+  yy->__pos = yypos0;
+  yy->__thunkpos = yythunkpos0;
+  yyprintf((stderr, "  fail %s @ %s\n", "AGGREGATE", yy->__buf + yy->__pos));
+  return 0;
+}
+YY_RULE(int) yy_GROUPBY(yycontext * yy) {
+  int yypos0 = yy->__pos, yythunkpos0 = yy->__thunkpos;
+  yyDo(yy, yyPush, 1, 0);
+  yyprintf((stderr, "%s\n", "GROUPBY"));
+  {
+    int yypos251 = yy->__pos, yythunkpos251 = yy->__thunkpos;
+    if (!yymatchString(yy, "group")) {
+      goto l252;
+    }
+    goto l251;
+l252:
+    ;
+    yy->__pos = yypos251;
+    yy->__thunkpos = yythunkpos251;
+    if (!yymatchString(yy, "distinct")) {
+      goto l250;
+    }
+    yyDo(yy, yy_1_GROUPBY, yy->__begin, yy->__end);
+  }
+l251:
+  ;
+  if (!yy___(yy)) {
+    goto l250;
+  }
+  if (!yy_ORDERNODES(yy)) {
+    goto l250;
+  }
+  yyDo(yy, yySet, -1, 0);
+  yyDo(yy, yy_2_GROUPBY, yy->__begin, yy->__end);
+  yyprintf((stderr, "  ok   %s @ %s\n", "GROUPBY", yy->__buf + yy->__pos));
+  yyDo(yy, yyPop, 1, 0);
+  return 1;
+l250:
+  ;
+  yy->__pos = yypos0;
+  yy->__thunkpos = yythunkpos0;
+  yyprintf((stderr, "  fail %s @ %s\n", "GROUPBY", yy->__buf + yy->__pos));
+  return 0;
+}
 YY_RULE(int) yy_ORDERBY(yycontext * yy) {
   int yypos0 = yy->__pos, yythunkpos0 = yy->__thunkpos;
   yyDo(yy, yyPush, 1, 0);
@@ -4070,6 +4325,22 @@ l164:
     }
     goto l162;
 l165:
+    ;
+    yy->__pos = yypos162;
+    yy->__thunkpos = yythunkpos162;
+    if (!yy_GROUPBY(yy)) {
+      goto l258;
+    }
+    goto l162;
+l258:
+    ;
+    yy->__pos = yypos162;
+    yy->__thunkpos = yythunkpos162;
+    if (!yy_AGGREGATE(yy)) {
+      goto l259;
+    }
+    goto l162;
+l259:
     ;
     yy->__pos = yypos162;
     yy->__thunkpos = yythunkpos162;
@@ -4086,6 +4357,14 @@ l166:
     }
     goto l162;
 l167:
+    ;
+    yy->__pos = yypos162;
+    yy->__thunkpos = yythunkpos162;
+    if (!yy_INDEXONLY(yy)) {
+      goto l261;
+    }
+    goto l162;
+l261:
     ;
     yy->__pos = yypos162;
     yy->__thunkpos = yythunkpos162;
@@ -5159,7 +5438,7 @@ YY_PARSE(yycontext*) YYRELEASE(yycontext * yyctx) {
 }
 
 #endif
-#line 253 "./jqp.leg"
+#line 268 "./jqp.leg"
 
 
 #include "./inc/jqpx.c"
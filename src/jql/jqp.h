@@ -99,6 +99,7 @@ typedef enum {
   JQP_OP_NI,
   JQP_OP_RE,
   JQP_OP_PREFIX,
+  JQP_OP_MATCH,
 } jqp_op_t;
 
 struct jqp_aux;
@@ -213,6 +214,22 @@ typedef struct jqp_query {
   struct jqp_aux *aux;
 } JQP_QUERY;
 
+typedef enum {
+  JQP_AGG_SUM = 1,
+  JQP_AGG_MIN,
+  JQP_AGG_MAX,
+  JQP_AGG_AVG,
+} jqp_agg_op_t;
+
+/** Aggregate clause: `sum|min|max|avg /path` */
+typedef struct jqp_aggregate {
+  jqp_agg_op_t op;
+  struct jqp_string    *value; /**< Path nodes linked by `subnext` */
+  struct jbl_ptr       *ptr;   /**< Path pointer allocated by `_jqp_finish()` */
+  const char *path;            /**< Path pointer as string */
+  struct jqp_aggregate *next;
+} JQP_AGGREGATE;
+
 //--
 
 union jqp_unit {
@@ -260,6 +277,9 @@ typedef uint8_t jqp_query_mode_t;
 #define JQP_QRY_APPLY_DEL    ((jqp_query_mode_t) 0x04U)
 #define JQP_QRY_INVERSE      ((jqp_query_mode_t) 0x08U)
 #define JQP_QRY_APPLY_UPSERT ((jqp_query_mode_t) 0x10U)
+#define JQP_QRY_GROUP        ((jqp_query_mode_t) 0x20U)
+#define JQP_QRY_DISTINCT     ((jqp_query_mode_t) 0x40U)
+#define JQP_QRY_INDEXONLY    ((jqp_query_mode_t) 0x80U)
 
 #define JQP_QRY_AGGREGATE (JQP_QRY_COUNT)
 
@@ -283,6 +303,12 @@ typedef struct jqp_aux {
   struct jqp_string     *end_placeholder;
   struct jqp_string     *orderby;
   struct jbl_ptr       **orderby_ptrs;        /**< Order-by pointers, orderby_num - number of pointers allocated */
+  struct jqp_string     *groupby;             /**< Group by path nodes (optional) */
+  struct jbl_ptr        *groupby_ptr;         /**< Group by pointer */
+  const char *groupby_path;                   /**< Group by pointer as string */
+  struct jqp_aggregate  *aggregates;          /**< Aggregate clauses, aggregates_num - number of clauses */
+  int aggregates_num;
+  jqp_agg_op_t aggregate_op;                  /**< Operation of currently parsed aggregate clause */
   struct jqp_op   *start_op;
   struct jqp_op   *end_op;
   union jqp_unit  *skip;
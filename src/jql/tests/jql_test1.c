@@ -75,7 +75,7 @@ static void jql_test1_1(void) {
   for (int i = 11; i <= 13; ++i) {
     _jql_test1_1(i, JQL_ERROR_QUERY_PARSE);
   }
-  for (int i = 14; i <= 22; ++i) {
+  for (int i = 14; i <= 24; ++i) {
     _jql_test1_1(i, 0);
   }
 }
@@ -12,6 +12,50 @@ int clean_suite() {
   return 0;
 }
 
+void ejdb_test1_4() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test1_4.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true
+  };
+  EJDB db;
+  JBL jbls[3] = { 0 };
+  int64_t ids[3], id = 0, count = 0;
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = put_json2(db, "c1", "{'n':0}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_from_json(&jbls[0], "{\"n\":1}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_from_json(&jbls[1], "{\"n\":2}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_put_new_batch(db, "c1", jbls, 2, ids);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(ids[0], id + 1);
+  CU_ASSERT_EQUAL(ids[1], id + 2);
+
+  // Batch stops on invalid document
+  rc = ejdb_put_new_batch(db, "c1", jbls, 3, ids);
+  CU_ASSERT_EQUAL(rc, IW_ERROR_INVALID_ARGS);
+  CU_ASSERT_EQUAL(ids[0], id + 3);
+  CU_ASSERT_EQUAL(ids[1], id + 4);
+  CU_ASSERT_EQUAL(ids[2], 0);
+
+  rc = ejdb_count2(db, "c1", "/*", &count, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 5);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  jbl_destroy(&jbls[0]);
+  jbl_destroy(&jbls[1]);
+}
+
 void ejdb_test1_3() {
   EJDB_OPTS opts = {
     .kv = {
@@ -292,6 +336,170 @@ void ejdb_test1_1() {
   CU_ASSERT_EQUAL_FATAL(rc, 0);
 }
 
+// Runtime metrics
+void ejdb_test1_5() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test1_5.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true
+  };
+  EJDB db;
+  JBL metrics, jbl;
+  int64_t count = 0;
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 0; i < 3; ++i) {
+    rc = put_json(db, "c1", "{'n':1}");
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+  rc = ejdb_get(db, "c1", 1, &jbl);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  jbl_destroy(&jbl);
+  rc = ejdb_del(db, "c1", 2);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_count2(db, "c1", "/*", &count, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 2);
+
+  rc = ejdb_get_metrics(db, &metrics);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  const char *paths[] = {
+    "/collections/0/puts", "/collections/0/gets", "/collections/0/dels", "/collections/0/queries",
+    "/exec/full/count", "/exec/full/buckets/+Inf", "/exec/pk/count", "/scanned", "/matched"
+  };
+  int64_t expected[] = { 3, 1, 1, 1, 1, 1, 0, 2, 2 };
+  for (int i = 0; i < (int) (sizeof(paths) / sizeof(paths[0])); ++i) {
+    rc = jbl_at(metrics, paths[i], &jbl);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    CU_ASSERT_EQUAL(jbl_get_i64(jbl), expected[i]);
+    jbl_destroy(&jbl);
+  }
+  jbl_destroy(&metrics);
+
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+  rc = jb_metrics_print(db, xstr);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "ejdb_collection_puts_total{collection=\"c1\"} 3\n"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "ejdb_exec_duration_seconds_count{scanner=\"full\"} 1\n"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(xstr), "ejdb_documents_scanned_total 2\n"));
+  iwxstr_destroy(xstr);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+}
+
+// Documents cache
+void ejdb_test1_6() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test1_6.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true,
+    .document_cache_sz = 1024 * 1024
+  };
+  EJDB db;
+  JBL metrics, jbl;
+  int64_t id = 0;
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json2(db, "c1", "{'n':1}", &id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  for (int i = 0; i < 2; ++i) { // miss, hit
+    rc = ejdb_get(db, "c1", id, &jbl);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    jbl_destroy(&jbl);
+  }
+
+  // Update drops cached document
+  rc = patch_json(db, "c1", "[{'op':'replace', 'path':'/n', 'value':2}]", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 0; i < 2; ++i) { // miss, hit
+    JBL nv;
+    rc = ejdb_get(db, "c1", id, &jbl);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    rc = jbl_at(jbl, "/n", &nv);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    CU_ASSERT_EQUAL(jbl_get_i64(nv), 2);
+    jbl_destroy(&nv);
+    jbl_destroy(&jbl);
+  }
+
+  // Removal drops cached document
+  rc = ejdb_del(db, "c1", id);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_get(db, "c1", id, &jbl);
+  CU_ASSERT_EQUAL(rc, IWKV_ERROR_NOTFOUND);
+
+  rc = ejdb_get_metrics(db, &metrics);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  const char *paths[] = { "/doc_cache_hits", "/doc_cache_misses", "/doc_cache_size", "/collections/0/gets" };
+  int64_t expected[] = { 2, 3, 0, 4 };
+  for (int i = 0; i < (int) (sizeof(paths) / sizeof(paths[0])); ++i) {
+    rc = jbl_at(metrics, paths[i], &jbl);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    CU_ASSERT_EQUAL(jbl_get_i64(jbl), expected[i]);
+    jbl_destroy(&jbl);
+  }
+  jbl_destroy(&metrics);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+}
+
+// Multi-get
+void ejdb_test1_7() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test1_7.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true
+  };
+  EJDB db;
+  JBL docs[5], jbl;
+  int64_t id;
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 1; i <= 3; ++i) {
+    char buf[32];
+    snprintf(buf, sizeof(buf), "{'n':%d}", i);
+    rc = put_json2(db, "c1", buf, &id);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    CU_ASSERT_EQUAL(id, i);
+  }
+  IWPOOL *pool = iwpool_create(256);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(pool);
+
+  int64_t ids[] = { 3, 7, 1, 3, 2 };
+  int64_t expected[] = { 3, 0, 1, 3, 2 };
+  rc = ejdb_get_many(db, "c1", ids, 5, pool, docs);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 0; i < 5; ++i) {
+    if (!expected[i]) {
+      CU_ASSERT_PTR_NULL(docs[i]);
+      continue;
+    }
+    CU_ASSERT_PTR_NOT_NULL_FATAL(docs[i]);
+    rc = jbl_at(docs[i], "/n", &jbl);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    CU_ASSERT_EQUAL(jbl_get_i64(jbl), expected[i]);
+    jbl_destroy(&jbl);
+  }
+
+  rc = ejdb_get_many(db, "c2", ids, 5, pool, docs);
+  CU_ASSERT_EQUAL(rc, IW_ERROR_NOT_EXISTS);
+
+  iwpool_destroy(pool);
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+}
+
 int main() {
   CU_pSuite pSuite = NULL;
   if (CUE_SUCCESS != CU_initialize_registry()) {
@@ -304,7 +512,11 @@ int main() {
   }
   if (  (NULL == CU_add_test(pSuite, "ejdb_test1_1", ejdb_test1_1))
      || (NULL == CU_add_test(pSuite, "ejdb_test1_2", ejdb_test1_2))
-     || (NULL == CU_add_test(pSuite, "ejdb_test1_3", ejdb_test1_3))) {
+     || (NULL == CU_add_test(pSuite, "ejdb_test1_3", ejdb_test1_3))
+     || (NULL == CU_add_test(pSuite, "ejdb_test1_4", ejdb_test1_4))
+     || (NULL == CU_add_test(pSuite, "ejdb_test1_5", ejdb_test1_5))
+     || (NULL == CU_add_test(pSuite, "ejdb_test1_6", ejdb_test1_6))
+     || (NULL == CU_add_test(pSuite, "ejdb_test1_7", ejdb_test1_7))) {
     CU_cleanup_registry();
     return CU_get_error();
   }
@@ -298,6 +298,88 @@ static void ejdb_test2_1() {
   iwxstr_destroy(xstr);
 }
 
+// Full-text index: tokenization, phrases, alternatives, ranking and reindexing
+static void ejdb_test2_3() {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test2_3.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true
+  };
+  EJDB db;
+  EJDB_LIST list = 0;
+  int64_t id1 = 0, id2 = 0, id3 = 0, cnt = 0;
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_ensure_index(db, "c1", "/text", EJDB_IDX_FTS | EJDB_IDX_UNIQUE);
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_INVALID_INDEX_MODE);
+
+  rc = put_json2(db, "c1", "{'text':'The quick brown Fox jumps over the lazy dog'}", &id1);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json2(db, "c1", "{'text':['fox, fox', 'and FOX']}", &id2);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_ensure_index(db, "c1", "/text", EJDB_IDX_FTS);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = put_json2(db, "c1", "{'text':'Brown quick dogs'}", &id3);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "c1", "{'text':42}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_count2(db, "c1", "/[text match \"fox\"]", &cnt, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(cnt, 2);
+
+  rc = ejdb_count2(db, "c1", "/[text match \"quick BROWN\"]", &cnt, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(cnt, 2);
+
+  rc = ejdb_count2(db, "c1", "/[text match \"\\\"quick brown\\\"\"]", &cnt, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(cnt, 1);
+
+  rc = ejdb_count2(db, "c1", "/[text match \"dogs | jumps\"]", &cnt, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(cnt, 2);
+
+  rc = ejdb_count2(db, "c1", "/[text match \"cat\"]", &cnt, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(cnt, 0);
+
+  // Document with higher term frequency ranks first
+  rc = ejdb_list2(db, "c1", "/[text match \"fox\"]", 0, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(list->first);
+  CU_ASSERT_EQUAL(list->first->id, id2);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(list->first->next);
+  CU_ASSERT_EQUAL(list->first->next->id, id1);
+  CU_ASSERT_PTR_NULL(list->first->next->next);
+  ejdb_list_destroy(&list);
+
+  // Reindex on update and delete
+  rc = ejdb_patch(db, "c1", "{\"text\":\"a slow red fox\"}", id3);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_count2(db, "c1", "/[text match \"fox\"]", &cnt, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(cnt, 3);
+  rc = ejdb_count2(db, "c1", "/[text match \"dogs\"]", &cnt, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(cnt, 0);
+
+  rc = ejdb_del(db, "c1", id2);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_count2(db, "c1", "/[text match \"fox\"]", &cnt, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(cnt, 2);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+}
+
 int main() {
   CU_pSuite pSuite = NULL;
   if (CUE_SUCCESS != CU_initialize_registry()) {
@@ -309,7 +391,8 @@ int main() {
     return CU_get_error();
   }
   if (  (NULL == CU_add_test(pSuite, "ejdb_test2_1", ejdb_test2_1))
-     || (NULL == CU_add_test(pSuite, "ejdb_test2_2", ejdb_test2_2))) {
+     || (NULL == CU_add_test(pSuite, "ejdb_test2_2", ejdb_test2_2))
+     || (NULL == CU_add_test(pSuite, "ejdb_test2_3", ejdb_test2_3))) {
     CU_cleanup_registry();
     return CU_get_error();
   }
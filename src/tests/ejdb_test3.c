@@ -1029,6 +1029,20 @@ void ejdb_test3_7() {
   CU_ASSERT_EQUAL_FATAL(rc, 0);
 }
 
+struct ejdb_test3_8_visit {
+  IWXSTR *xstr;
+  int64_t back_id; // Visitor steps two documents back once it meets this document
+};
+
+static iwrc ejdb_test3_8_visitor(struct ejdb_exec *ux, struct ejdb_doc *doc, int64_t *step) {
+  struct ejdb_test3_8_visit *v = ux->opaque;
+  if (doc->id == v->back_id) {
+    v->back_id = 0;
+    *step = -2;
+  }
+  return iwxstr_printf(v->xstr, "%" PRId64 ",", doc->id);
+}
+
 void ejdb_test3_8(void) {
   EJDB_OPTS opts = {
     .kv = {
@@ -1043,7 +1057,7 @@ void ejdb_test3_8(void) {
   char buf[64];
   JBL_NODE n;
 
-  int64_t id1 = 0, id2 = 0;
+  int64_t id1 = 0, id2 = 0, id3 = 0;
   EJDB_LIST list = 0;
 
   IWPOOL *pool = iwpool_create(255);
@@ -1097,6 +1111,46 @@ void ejdb_test3_8(void) {
   jql_destroy(&q);
   ejdb_list_destroy(&list);
 
+  // PK array results are in the given order, missing ids are skipped
+  snprintf(buf, sizeof(buf), "@users/=[%" PRId64 ",999,%" PRId64 "]", id2, id1);
+  rc = jql_create(&q, 0, buf);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_list4(db, q, 0, 0, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(list->first);
+  CU_ASSERT_EQUAL(list->first->id, id2);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(list->first->next);
+  CU_ASSERT_EQUAL(list->first->next->id, id1);
+  CU_ASSERT_PTR_NULL(list->first->next->next);
+  jql_destroy(&q);
+  ejdb_list_destroy(&list);
+
+  // Missing ids are skipped in the scan direction requested by visitor
+  rc = put_json2(db, "users", "{'name':'Mike'}", &id3);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  snprintf(buf, sizeof(buf), "@users/=[%" PRId64 ",%" PRId64 ",999,%" PRId64 "]", id1, id2, id3);
+  rc = jql_create(&q, 0, buf);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  struct ejdb_test3_8_visit visit = {
+    .xstr    = iwxstr_new(),
+    .back_id = id3
+  };
+  CU_ASSERT_PTR_NOT_NULL_FATAL(visit.xstr);
+  EJDB_EXEC ux = {
+    .db      = db,
+    .q       = q,
+    .visitor = ejdb_test3_8_visitor,
+    .opaque  = &visit
+  };
+  rc = ejdb_exec(&ux);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_clear(log);
+  iwxstr_printf(log, "%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",%" PRId64 ",",
+                id1, id2, id3, id1, id2, id3);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(visit.xstr), iwxstr_ptr(log));
+  iwxstr_destroy(visit.xstr);
+  jql_destroy(&q);
+
   // matching against PK array as JSON query parameter
   snprintf(buf, sizeof(buf), "[%" PRId64 ",%" PRId64 "]", id1, id2);
   rc = jbn_from_json(buf, &n, pool);
@@ -1149,6 +1203,991 @@ static void ejdb_test3_9(void) {
   CU_ASSERT_EQUAL_FATAL(rc, 0);
 }
 
+// F64 index keys ordering over negative, zero and positive values
+static void ejdb_test3_10(void) {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_10.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true
+  };
+  EJDB db;
+  EJDB_LIST list = 0;
+  const char *vals[] = { "-10.5", "-2", "-0.25", "0", "1.5", "3", "100.125" };
+  char dbuf[64];
+  IWXSTR *log = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_ensure_index(db, "c1", "/f", EJDB_IDX_F64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  for (int i = 0; i < (int) (sizeof(vals) / sizeof(vals[0])); ++i) {
+    snprintf(dbuf, sizeof(dbuf), "{\"f\":%s,\"n\":%d}", vals[i], i + 1);
+    rc = put_json(db, "c1", dbuf);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+
+  for (int pass = 0; pass < 2; ++pass) {
+    if (pass) { // Check index after reopening
+      rc = ejdb_close(&db);
+      CU_ASSERT_EQUAL_FATAL(rc, 0);
+      opts.kv.oflags = 0;
+      rc = ejdb_open(&opts, &db);
+      CU_ASSERT_EQUAL_FATAL(rc, 0);
+    }
+
+    rc = ejdb_list3(db, "c1", "/[f >= -2] | asc /f", 0, log, &list);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED F64|7 /f"));
+    for (EJDB_DOC doc = list->first; doc; doc = doc->next) {
+      JBL jbl;
+      rc = jbl_at(doc->raw, "/n", &jbl);
+      CU_ASSERT_EQUAL_FATAL(rc, 0);
+      iwxstr_printf(xstr, "%" PRId64, jbl_get_i64(jbl));
+      jbl_destroy(&jbl);
+    }
+    CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "234567");
+    ejdb_list_destroy(&list);
+    iwxstr_clear(log);
+    iwxstr_clear(xstr);
+
+    rc = ejdb_list3(db, "c1", "/[f < 1] | desc /f", 0, log, &list);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    for (EJDB_DOC doc = list->first; doc; doc = doc->next) {
+      JBL jbl;
+      rc = jbl_at(doc->raw, "/n", &jbl);
+      CU_ASSERT_EQUAL_FATAL(rc, 0);
+      iwxstr_printf(xstr, "%" PRId64, jbl_get_i64(jbl));
+      jbl_destroy(&jbl);
+    }
+    CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "4321");
+    ejdb_list_destroy(&list);
+    iwxstr_clear(log);
+    iwxstr_clear(xstr);
+
+    int64_t cnt = 0;
+    rc = ejdb_count2(db, "c1", "/[f = -0.25]", &cnt, 0);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    CU_ASSERT_EQUAL(cnt, 1);
+    rc = ejdb_count2(db, "c1", "/[f in [-10.5, 3, 4]]", &cnt, 0);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    CU_ASSERT_EQUAL(cnt, 2);
+  }
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(log);
+  iwxstr_destroy(xstr);
+}
+
+static iwrc ejdb_test3_11_visitor(struct ejdb_exec *ux, struct ejdb_doc *doc, int64_t *step) {
+  JBL jbl;
+  iwrc rc = jbl_at(doc->raw, "/n", &jbl);
+  RCRET(rc);
+  rc = iwxstr_printf(ux->opaque, "%" PRId64 ",", jbl_get_i64(jbl));
+  jbl_destroy(&jbl);
+  return rc;
+}
+
+// Runs query page by page using resume token and compares result with the whole query output
+static void ejdb_test3_11_paginate(EJDB db, const char *query, int64_t limit) {
+  JQL q;
+  IWXSTR *all = iwxstr_new();
+  IWXSTR *paged = iwxstr_new();
+  IWXSTR *token = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(all);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(paged);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(token);
+
+  iwrc rc = jql_create(&q, "c1", query);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  EJDB_EXEC ux = {
+    .db      = db,
+    .q       = q,
+    .visitor = ejdb_test3_11_visitor,
+    .opaque  = all
+  };
+  rc = ejdb_exec(&ux);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_TRUE(ux.cnt > limit);
+
+  for (int i = 0; i < 100; ++i) {
+    EJDB_EXEC pux = {
+      .db      = db,
+      .q       = q,
+      .visitor = ejdb_test3_11_visitor,
+      .opaque  = paged,
+      .limit   = limit,
+      .resume  = token
+    };
+    rc = ejdb_exec(&pux);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    CU_ASSERT_TRUE(iwxstr_size(token) > 0);
+    if (pux.cnt < limit) {
+      break;
+    }
+  }
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(paged), iwxstr_ptr(all));
+
+  jql_destroy(&q);
+  iwxstr_destroy(all);
+  iwxstr_destroy(paged);
+  iwxstr_destroy(token);
+}
+
+// Keyset pagination with resume tokens and index skip
+static void ejdb_test3_11(void) {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_11.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true
+  };
+  EJDB db;
+  JQL q;
+  char dbuf[64];
+  IWXSTR *xstr = iwxstr_new();
+  IWXSTR *token = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(token);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = ejdb_ensure_index(db, "c1", "/f", EJDB_IDX_I64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/s", EJDB_IDX_STR | EJDB_IDX_UNIQUE);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  for (int i = 1; i <= 10; ++i) {
+    snprintf(dbuf, sizeof(dbuf), "{\"f\":%d,\"s\":\"s%02d\",\"n\":%d}", i, i, i);
+    rc = put_json(db, "c1", dbuf);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+  rc = put_json(db, "c1", "{'n':11}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "c1", "{'f':5,'n':12}"); // Duplicated index key
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  ejdb_test3_11_paginate(db, "/[f >= 3] | asc /f", 3);
+  ejdb_test3_11_paginate(db, "/[f < 8] | desc /f", 3);
+  ejdb_test3_11_paginate(db, "/[f = 5]", 1);
+  ejdb_test3_11_paginate(db, "/* | asc /f", 4);
+  ejdb_test3_11_paginate(db, "/[s > s03] | asc /s", 2);
+  ejdb_test3_11_paginate(db, "/[n > 0]", 5);
+  ejdb_test3_11_paginate(db, "/[n > 0] | inverse", 5);
+
+  // Skip over index without documents fetching
+  rc = jql_create(&q, "c1", "/[f >= 3] | asc /f skip 4");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  EJDB_EXEC ux = {
+    .db      = db,
+    .q       = q,
+    .visitor = ejdb_test3_11_visitor,
+    .opaque  = xstr
+  };
+  rc = ejdb_exec(&ux);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "6,7,8,9,10,");
+  jql_destroy(&q);
+  iwxstr_clear(xstr);
+
+  // Resume token is not applicable for `in` queries
+  rc = jql_create(&q, "c1", "/[f in [1, 2]]");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = iwxstr_cat(token, "\0\0\0\0\0\0\0\0\0\0\0\0", 12);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  ux = (EJDB_EXEC) {
+    .db      = db,
+    .q       = q,
+    .visitor = ejdb_test3_11_visitor,
+    .opaque  = xstr,
+    .resume  = token
+  };
+  rc = ejdb_exec(&ux);
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_INVALID_RESUME_TOKEN);
+  jql_destroy(&q);
+
+  // Token of other index
+  rc = jql_create(&q, "c1", "/[n > 0]");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  ux.q = q;
+  rc = ejdb_exec(&ux);
+  CU_ASSERT_EQUAL(rc, EJDB_ERROR_INVALID_RESUME_TOKEN);
+  jql_destroy(&q);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(xstr);
+  iwxstr_destroy(token);
+}
+
+// Iterates query by cursor and compares result with the whole query output
+static void ejdb_test3_12_iterate(EJDB db, const char *query, int64_t batch_size) {
+  JQL q;
+  JBL jbl;
+  EJDB_CURSOR cur;
+  EJDB_DOC doc;
+  int64_t count;
+  IWXSTR *all = iwxstr_new();
+  IWXSTR *iterated = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(all);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(iterated);
+
+  iwrc rc = jql_create(&q, "c1", query);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  EJDB_EXEC ux = {
+    .db      = db,
+    .q       = q,
+    .visitor = ejdb_test3_11_visitor,
+    .opaque  = all
+  };
+  rc = ejdb_exec(&ux);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_TRUE(ux.cnt > batch_size);
+
+  rc = ejdb_cursor_open(db, q, batch_size, &cur);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  bool partial = false;
+  for (int i = 0; i < 100; ++i) {
+    rc = ejdb_cursor_next(cur, &doc, &count);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    CU_ASSERT_TRUE(count <= batch_size);
+    if (partial) { // Cursor is exhausted after incomplete batch
+      CU_ASSERT_PTR_NULL(doc);
+    }
+    if (!doc) {
+      CU_ASSERT_EQUAL(count, 0);
+      break;
+    }
+    partial = count < batch_size;
+    for ( ; doc; doc = doc->next, --count) {
+      rc = jbl_at(doc->raw, "/n", &jbl);
+      CU_ASSERT_EQUAL_FATAL(rc, 0);
+      iwxstr_printf(iterated, "%" PRId64 ",", jbl_get_i64(jbl));
+      jbl_destroy(&jbl);
+    }
+    CU_ASSERT_EQUAL(count, 0);
+  }
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(iterated), iwxstr_ptr(all));
+
+  ejdb_cursor_close(&cur);
+  CU_ASSERT_PTR_NULL(cur);
+  jql_destroy(&q);
+  iwxstr_destroy(all);
+  iwxstr_destroy(iterated);
+}
+
+// Pull-style query cursor
+static void ejdb_test3_12(void) {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_12.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true
+  };
+  EJDB db;
+  JQL q;
+  EJDB_CURSOR cur;
+  EJDB_DOC doc;
+  int64_t count;
+  char dbuf[64];
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/f", EJDB_IDX_I64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  for (int i = 1; i <= 20; ++i) {
+    snprintf(dbuf, sizeof(dbuf), "{\"f\":%d,\"n\":%d}", i % 7, i);
+    rc = put_json(db, "c1", dbuf);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+
+  ejdb_test3_12_iterate(db, "/*", 3);
+  ejdb_test3_12_iterate(db, "/[f >= 2] | asc /f", 4);
+  ejdb_test3_12_iterate(db, "/[f >= 2] | asc /f skip 3 limit 10", 4);
+  ejdb_test3_12_iterate(db, "/* | desc /n", 6); // Sorted, fetched by skip offsets
+  ejdb_test3_12_iterate(db, "/* | desc /n skip 2", 5);
+
+  // Writers are not blocked between batches
+  rc = jql_create(&q, "c1", "/[f >= 0] | asc /f");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_cursor_open(db, q, 5, &cur);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_cursor_next(cur, &doc, &count);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 5);
+  rc = put_json(db, "c1", "{'f':6,'n':21}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  int64_t total = count;
+  do {
+    rc = ejdb_cursor_next(cur, &doc, &count);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    total += count;
+  } while (doc);
+  CU_ASSERT_EQUAL(total, 21);
+  ejdb_cursor_close(&cur);
+  jql_destroy(&q);
+
+  // Modifying queries are not supported
+  rc = jql_create(&q, "c1", "/* | del");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_cursor_open(db, q, 5, &cur);
+  CU_ASSERT_EQUAL(rc, IW_ERROR_INVALID_ARGS);
+  CU_ASSERT_PTR_NULL(cur);
+  jql_destroy(&q);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+}
+
+static iwrc ejdb_test3_13_visitor(struct ejdb_exec *ux, struct ejdb_doc *doc, int64_t *step) {
+  iwrc rc = ejdb_test3_11_visitor(ux, doc, step);
+  if (ux->cnt == 1) { // Stop on the last document of the first batch
+    *step = 0;
+  }
+  return rc;
+}
+
+// Scan releasing collection lock between batches
+static void ejdb_test3_13(void) {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_13.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true
+  };
+  EJDB db;
+  char dbuf[64];
+  const char *queries[] = {
+    "/*", "/[f >= 2] | asc /f", "/[f >= 2] | desc /f skip 2 limit 9", "/* | desc /n"
+  };
+  IWXSTR *all = iwxstr_new();
+  IWXSTR *yielded = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(all);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(yielded);
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/f", EJDB_IDX_I64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 1; i <= 20; ++i) {
+    snprintf(dbuf, sizeof(dbuf), "{\"f\":%d,\"n\":%d}", i % 7, i);
+    rc = put_json(db, "c1", dbuf);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+
+  for (int i = 0; i < (int) (sizeof(queries) / sizeof(queries[0])); ++i) {
+    JQL q;
+    rc = jql_create(&q, "c1", queries[i]);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    EJDB_EXEC ux = {
+      .db      = db,
+      .q       = q,
+      .visitor = ejdb_test3_11_visitor,
+      .opaque  = all
+    };
+    rc = ejdb_exec(&ux);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    int64_t cnt = ux.cnt;
+
+    ux = (EJDB_EXEC) {
+      .db          = db,
+      .q           = q,
+      .visitor     = ejdb_test3_11_visitor,
+      .opaque      = yielded,
+      .yield_batch = 3
+    };
+    rc = ejdb_exec(&ux);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    CU_ASSERT_EQUAL(ux.cnt, cnt);
+    CU_ASSERT_PTR_NULL(ux.resume);
+    CU_ASSERT_STRING_EQUAL(iwxstr_ptr(yielded), iwxstr_ptr(all));
+    iwxstr_clear(all);
+    iwxstr_clear(yielded);
+    jql_destroy(&q);
+  }
+
+  // Visitor stops scan on batch boundary
+  JQL q;
+  rc = jql_create(&q, "c1", "/[f >= 2] | asc /f");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  EJDB_EXEC ux = {
+    .db          = db,
+    .q           = q,
+    .visitor     = ejdb_test3_13_visitor,
+    .opaque      = yielded,
+    .yield_batch = 2
+  };
+  rc = ejdb_exec(&ux);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(ux.cnt, 2);
+  jql_destroy(&q);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  iwxstr_destroy(all);
+  iwxstr_destroy(yielded);
+}
+
+static iwrc ejdb_test3_14_visitor(struct ejdb_exec *ux, struct ejdb_doc *doc, int64_t *step) {
+  return 0;
+}
+
+// Query cancellation and deadline
+static void ejdb_test3_14(void) {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_14.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true
+  };
+  EJDB db;
+  char dbuf[64];
+  volatile bool cancel = false;
+  const char *queries[] = { "/*", "/* | asc /n" };
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 1; i <= 1000; ++i) {
+    snprintf(dbuf, sizeof(dbuf), "{\"n\":%d}", i);
+    rc = put_json(db, "c1", dbuf);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+
+  for (int i = 0; i < (int) (sizeof(queries) / sizeof(queries[0])); ++i) {
+    JQL q;
+    rc = jql_create(&q, "c1", queries[i]);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    EJDB_EXEC ux = {
+      .db      = db,
+      .q       = q,
+      .visitor = ejdb_test3_14_visitor,
+      .cancel  = &cancel
+    };
+    rc = ejdb_exec(&ux);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    CU_ASSERT_EQUAL(ux.cnt, 1000);
+
+    cancel = true;
+    ux = (EJDB_EXEC) {
+      .db      = db,
+      .q       = q,
+      .visitor = ejdb_test3_14_visitor,
+      .cancel  = &cancel
+    };
+    rc = ejdb_exec(&ux);
+    CU_ASSERT_EQUAL(rc, EJDB_ERROR_QUERY_CANCELLED);
+    CU_ASSERT_TRUE(ux.cnt < 1000);
+    cancel = false;
+
+    ux = (EJDB_EXEC) {
+      .db       = db,
+      .q        = q,
+      .visitor  = ejdb_test3_14_visitor,
+      .deadline = 1 // Already expired
+    };
+    rc = ejdb_exec(&ux);
+    CU_ASSERT_EQUAL(rc, EJDB_ERROR_QUERY_TIMEOUT);
+    CU_ASSERT_TRUE(ux.cnt < 1000);
+    jql_destroy(&q);
+  }
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+}
+
+static iwrc ejdb_test3_15_visitor(struct ejdb_exec *ux, struct ejdb_doc *doc, int64_t *step) {
+  usleep(2000);
+  return 0;
+}
+
+// Slow queries log
+static void ejdb_test3_15(void) {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_15.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true,
+    .slow_query_ms = 1,
+    .slow_query_log_sz = 2
+  };
+  EJDB db;
+  JBL jbl, at;
+  char dbuf[64];
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 1; i <= 3; ++i) {
+    snprintf(dbuf, sizeof(dbuf), "{\"n\":%d}", i);
+    rc = put_json(db, "c1", dbuf);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+
+  JQL q;
+  rc = jql_create(&q, "c1", "/* | asc /n");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 0; i < 3; ++i) {
+    IWXSTR *log = iwxstr_new();
+    CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+    EJDB_EXEC ux = {
+      .db      = db,
+      .q       = q,
+      .visitor = ejdb_test3_15_visitor,
+      .log     = i < 2 ? log : 0 // Last query plan is recorded without explain log
+    };
+    rc = ejdb_exec(&ux);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    CU_ASSERT_EQUAL(ux.cnt, 3);
+    if (i < 2) {
+      // Explain log is kept intact
+      CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] NO"));
+      CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] SORTER"));
+    }
+    iwxstr_destroy(log);
+  }
+  jql_destroy(&q);
+
+  rc = ejdb_get_slow_queries(db, &jbl);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = jbl_at(jbl, "/total", &at);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(jbl_get_i64(at), 3);
+  jbl_destroy(&at);
+
+  rc = jbl_at(jbl, "/queries/2", &at); // Only two recent entries are kept
+  CU_ASSERT_EQUAL(rc, JBL_ERROR_PATH_NOTFOUND);
+
+  rc = jbl_at(jbl, "/queries/1/query", &at);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_STRING_EQUAL(jbl_get_str(at), "/* | asc /n");
+  jbl_destroy(&at);
+
+  rc = jbl_at(jbl, "/queries/1/plan", &at);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(jbl_get_str(at), "[INDEX] NO"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(jbl_get_str(at), "[COLLECTOR] SORTER"));
+  jbl_destroy(&at);
+
+  rc = jbl_at(jbl, "/queries/1/scanned", &at);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(jbl_get_i64(at), 3);
+  jbl_destroy(&at);
+
+  rc = jbl_at(jbl, "/queries/1/duration", &at);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_TRUE(jbl_get_i64(at) >= 1000);
+  jbl_destroy(&at);
+  jbl_destroy(&jbl);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+}
+
+static void ejdb_test3_16_check(EJDB db, const char *coll, const char *q, const char **expected, int num) {
+  EJDB_LIST list = 0;
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+  iwrc rc = ejdb_list3(db, coll, q, 0, 0, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  int i = 0;
+  for (EJDB_DOC doc = list->first; doc; doc = doc->next, ++i) {
+    iwxstr_clear(xstr);
+    rc = jbl_as_json(doc->raw, jbl_xstr_json_printer, xstr, 0);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    CU_ASSERT_EQUAL(doc->id, i + 1);
+    if (i < num) {
+      CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), expected[i]);
+    }
+  }
+  CU_ASSERT_EQUAL(i, num);
+  ejdb_list_destroy(&list);
+  iwxstr_destroy(xstr);
+}
+
+// Grouping and aggregation
+static void ejdb_test3_16(void) {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_16.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true,
+    .sort_buffer_sz = 1024 * 1024
+  };
+  EJDB db;
+  JBL metrics, jbl;
+  char dbuf[64];
+  int64_t count = 0;
+  const char *docs[] = {
+    "{'c':'x','n':1}", "{'c':'y','n':2}", "{'c':'x','n':4}", "{'c':'x'}", "{'n':5}", "{'c':'y','n':2.5}"
+  };
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 0; i < (int) (sizeof(docs) / sizeof(docs[0])); ++i) {
+    rc = put_json(db, "c1", docs[i]);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+
+  const char *r1[] = {
+    "{\"key\":\"x\",\"count\":3,\"sum\":{\"/n\":5},\"min\":{\"/n\":1},\"avg\":{\"/n\":2.5}}",
+    "{\"key\":\"y\",\"count\":2,\"sum\":{\"/n\":4.5},\"min\":{\"/n\":2},\"avg\":{\"/n\":2.25}}"
+  };
+  ejdb_test3_16_check(db, "c1", "/* | group /c sum /n min /n avg /n", r1, 2);
+  ejdb_test3_16_check(db, "c1", "/* | group /c sum /n min /n avg /n skip 1", r1 + 1, 1);
+
+  const char *r2[] = { "{\"key\":\"x\"}", "{\"key\":\"y\"}" };
+  ejdb_test3_16_check(db, "c1", "/[n > 0] | distinct /c", r2, 2);
+
+  const char *r3[] = { "{\"count\":0,\"max\":{\"/n\":null}}" };
+  ejdb_test3_16_check(db, "c1", "/[c = \"z\"] | max /n", r3, 1);
+
+  rc = ejdb_count2(db, "c1", "/* | group /c", &count, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 2);
+
+  JQL q;
+  rc = jql_create(&q, "c1", "/* | group /c | del");
+  CU_ASSERT_EQUAL(rc, JQL_ERROR_AGGREGATE_INCOMPATIBLE);
+  rc = jql_create(&q, "c1", "/* | group /c asc /n");
+  CU_ASSERT_EQUAL(rc, JQL_ERROR_AGGREGATE_INCOMPATIBLE);
+
+  // Documents are grouped in order of index scan
+  rc = ejdb_ensure_index(db, "c1", "/n", EJDB_IDX_I64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  EJDB_LIST list = 0;
+  IWXSTR *log = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+  rc = ejdb_list3(db, "c1", "/* | group /n", 0, log, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED I64|5 /n"));
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[COLLECTOR] GROUP"));
+  count = 0;
+  for (EJDB_DOC doc = list->first; doc; doc = doc->next) {
+    ++count;
+  }
+  CU_ASSERT_EQUAL(count, 5);
+  ejdb_list_destroy(&list);
+  iwxstr_destroy(log);
+
+  // Index runs are emitted in descending index order, groups sharing
+  // the same index key (2 and 2.5) in ascending order
+  const char *r5[] = {
+    "{\"key\":5,\"count\":1,\"sum\":{\"/n\":5}}",
+    "{\"key\":4,\"count\":1,\"sum\":{\"/n\":4}}",
+    "{\"key\":2,\"count\":1,\"sum\":{\"/n\":2}}",
+    "{\"key\":2.5,\"count\":1,\"sum\":{\"/n\":2.5}}",
+    "{\"key\":1,\"count\":1,\"sum\":{\"/n\":1}}"
+  };
+  ejdb_test3_16_check(db, "c1", "/* | group /n sum /n", r5, 5);
+
+  // Groups collected in memory are emitted in ascending order
+  const char *r6[] = { r5[4], r5[2], r5[3], r5[1], r5[0] };
+  ejdb_test3_16_check(db, "c1", "/* | group /n sum /n noidx", r6, 5);
+
+  // Repeated IN values don't emit the same group twice
+  const char *r7[] = { r5[4], r5[1] };
+  ejdb_test3_16_check(db, "c1", "/[n in [4, 4, 1]] | group /n sum /n", r7, 2);
+  const char *r8[] = { r5[2], r5[3] };
+  ejdb_test3_16_check(db, "c1", "/[n in [2, 2.5, 2]] | group /n sum /n", r8, 2);
+
+  // Integer sum overflow switches to floating point
+  rc = put_json(db, "c3", "{'n':9223372036854775807}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "c3", "{'n':9223372036854775807}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_list3(db, "c3", "/* | sum /n", 0, 0, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(list->first);
+  rc = jbl_at(list->first->raw, "/sum/~1n", &jbl);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(jbl_type(jbl), JBV_F64);
+  CU_ASSERT_DOUBLE_EQUAL(jbl_get_f64(jbl), 18446744073709551616.0, 1);
+  jbl_destroy(&jbl);
+  ejdb_list_destroy(&list);
+
+  // Groups overflow
+  for (int i = 0; i < 40000; ++i) {
+    snprintf(dbuf, sizeof(dbuf), "{\"k\":%d,\"n\":%d}", i / 2, i);
+    rc = put_json(db, "c2", dbuf);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+  rc = ejdb_count2(db, "c2", "/* | group /k sum /n", &count, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 20000);
+
+  const char *r4[] = { "{\"key\":7,\"count\":2,\"sum\":{\"/n\":29}}" };
+  ejdb_test3_16_check(db, "c2", "/[k = 7] | group /k sum /n", r4, 1);
+
+  rc = ejdb_get_metrics(db, &metrics);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_at(metrics, "/group_spills", &jbl);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_TRUE(jbl_get_i64(jbl) > 0);
+  jbl_destroy(&jbl);
+  jbl_destroy(&metrics);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+}
+
+// Distinct values read from index
+static void ejdb_test3_17(void) {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_17.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true
+  };
+  EJDB db;
+  JBL metrics, jbl;
+  char dbuf[64];
+  int64_t count = 0;
+  EJDB_LIST list = 0;
+  const char *docs[] = {
+    "{'c':'x','n':1}", "{'c':'y','n':2}", "{'c':'x','n':4}", "{'c':'x'}", "{'n':5}", "{'c':'y','n':2.5}"
+  };
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c1", "/c", EJDB_IDX_STR);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_ensure_index(db, "c2", "/u", EJDB_IDX_UNIQUE | EJDB_IDX_I64);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 0; i < (int) (sizeof(docs) / sizeof(docs[0])); ++i) {
+    rc = put_json(db, "c1", docs[i]);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+  for (int i = 1; i <= 5; ++i) {
+    snprintf(dbuf, sizeof(dbuf), "{\"u\":%d}", i);
+    rc = put_json(db, "c2", dbuf);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+
+  IWXSTR *log = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+  rc = ejdb_list3(db, "c1", "/* | distinct /c indexonly", 0, log, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] DISTINCT STR|5 /c"));
+  ejdb_list_destroy(&list);
+
+  const char *r1[] = { "{\"key\":\"x\"}", "{\"key\":\"y\"}" };
+  ejdb_test3_16_check(db, "c1", "/* | distinct /c indexonly", r1, 2);
+
+  const char *r2[] = { "{\"key\":\"x\",\"count\":3}", "{\"key\":\"y\",\"count\":2}" };
+  ejdb_test3_16_check(db, "c1", "/* | group /c indexonly", r2, 2);
+  ejdb_test3_16_check(db, "c1", "/* | group /c indexonly skip 1", r2 + 1, 1);
+  ejdb_test3_16_check(db, "c1", "/* | group /c indexonly limit 1", r2, 1);
+
+  rc = ejdb_count2(db, "c1", "/* | distinct /c indexonly", &count, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(count, 2);
+
+  const char *r3[] = { "{\"key\":2,\"count\":1}", "{\"key\":3,\"count\":1}" };
+  ejdb_test3_16_check(db, "c2", "/* | group /u indexonly skip 1 limit 2", r3, 2);
+
+  // Index only queries never read documents
+  rc = ejdb_get_metrics(db, &metrics);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_at(metrics, "/scanned", &jbl);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(jbl_get_i64(jbl), 0);
+  jbl_destroy(&jbl);
+  jbl_destroy(&metrics);
+
+  // Without `indexonly` or with filter documents are scanned
+  iwxstr_clear(log);
+  rc = ejdb_list3(db, "c1", "/* | distinct /c", 0, log, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NULL(strstr(iwxstr_ptr(log), "[INDEX] DISTINCT"));
+  ejdb_list_destroy(&list);
+
+  iwxstr_clear(log);
+  rc = ejdb_list3(db, "c1", "/[n > 0] | distinct /c indexonly", 0, log, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NULL(strstr(iwxstr_ptr(log), "[INDEX] DISTINCT"));
+  ejdb_list_destroy(&list);
+  iwxstr_destroy(log);
+
+  ejdb_test3_16_check(db, "c1", "/* | distinct /c", r1, 2);
+  ejdb_test3_16_check(db, "c1", "/[n > 0] | distinct /c indexonly", r1, 2);
+  ejdb_test3_16_check(db, "c1", "/* | group /c", r2, 2);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+}
+
+static void ejdb_test3_18_check(EJDB db, bool legacy) {
+  EJDB_LIST list = 0;
+  int64_t cnt = 0;
+  IWXSTR *log = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(log);
+  IWXSTR *xstr = iwxstr_new();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(xstr);
+
+  struct jbcoll *jbc = iwhmap_get(db->mcolls, "c1");
+  CU_ASSERT_PTR_NOT_NULL_FATAL(jbc);
+  CU_ASSERT_PTR_NOT_NULL_FATAL(jbc->idx);
+  CU_ASSERT_EQUAL(JBI_IDX_F64_TEXT_KEYS(jbc->idx) != 0, legacy);
+
+  // Distinct values are decoded from both binary and text index keys
+  const double keys[] = { -10.5, -2, -0.25, 0, 1.5, 3, 100.125 };
+  iwrc rc = ejdb_list3(db, "c1", "/* | distinct /f indexonly", 0, log, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] DISTINCT F64|"));
+  for (EJDB_DOC doc = list->first; doc; doc = doc->next, ++cnt) {
+    JBL jbl;
+    rc = jbl_at(doc->raw, "/key", &jbl);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    CU_ASSERT_EQUAL(jbl_type(jbl), JBV_F64);
+    if (cnt < (int64_t) (sizeof(keys) / sizeof(keys[0]))) {
+      CU_ASSERT_DOUBLE_EQUAL(jbl_get_f64(jbl), keys[cnt], 1e-9);
+    }
+    jbl_destroy(&jbl);
+  }
+  CU_ASSERT_EQUAL(cnt, sizeof(keys) / sizeof(keys[0]));
+  ejdb_list_destroy(&list);
+  iwxstr_clear(log);
+
+  JBL metrics, scanned;
+  rc = ejdb_get_metrics(db, &metrics);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_at(metrics, "/scanned", &scanned);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(jbl_get_i64(scanned), 0);
+  jbl_destroy(&scanned);
+  jbl_destroy(&metrics);
+
+  rc = ejdb_list3(db, "c1", "/[f >= -2] | asc /f", 0, log, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_PTR_NOT_NULL(strstr(iwxstr_ptr(log), "[INDEX] SELECTED F64|"));
+  for (EJDB_DOC doc = list->first; doc; doc = doc->next) {
+    JBL jbl;
+    rc = jbl_at(doc->raw, "/n", &jbl);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    iwxstr_printf(xstr, "%" PRId64, jbl_get_i64(jbl));
+    jbl_destroy(&jbl);
+  }
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "234567");
+  ejdb_list_destroy(&list);
+  iwxstr_clear(xstr);
+
+  rc = ejdb_list3(db, "c1", "/[f < 1] | desc /f", 0, 0, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (EJDB_DOC doc = list->first; doc; doc = doc->next) {
+    JBL jbl;
+    rc = jbl_at(doc->raw, "/n", &jbl);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    iwxstr_printf(xstr, "%" PRId64, jbl_get_i64(jbl));
+    jbl_destroy(&jbl);
+  }
+  CU_ASSERT_STRING_EQUAL(iwxstr_ptr(xstr), "4321");
+  ejdb_list_destroy(&list);
+
+  rc = ejdb_count2(db, "c1", "/[f = -0.25]", &cnt, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(cnt, 1);
+  rc = ejdb_count2(db, "c1", "/[f in [-10.5, 3, 4]]", &cnt, 0);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(cnt, 2);
+
+  iwxstr_destroy(log);
+  iwxstr_destroy(xstr);
+}
+
+// Legacy F64 index with `IWDB_REALNUM_KEYS` text keys is migrated on writable open
+static void ejdb_test3_18(void) {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test3_18.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true
+  };
+  EJDB db;
+  struct iwdb *idb;
+  uint32_t dbid;
+  size_t sz;
+  char numbuf[IWNUMBUF_SIZE];
+  char dbuf[64];
+  const char *vals[] = { "-10.5", "-2", "-0.25", "0", "1.5", "3", "100.125" };
+  const iwdb_flags_t idbf = IWDB_REALNUM_KEYS | IWDB_COMPOUND_KEYS;
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  // Index database layout written by versions before binary F64 keys
+  rc = iwkv_new_db(db->iwkv, idbf, &dbid, &idb);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  for (int i = 0; i < (int) (sizeof(vals) / sizeof(vals[0])); ++i) {
+    int64_t id;
+    snprintf(dbuf, sizeof(dbuf), "{\"f\":%s,\"n\":%d}", vals[i], i + 1);
+    rc = put_json2(db, "c1", dbuf, &id);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    iwjson_ftoa(iwatof(vals[i]), numbuf, &sz);
+    struct iwkv_val key = { .data = numbuf, .size = sz, .compound = id };
+    struct iwkv_val val = { 0 };
+    rc = iwkv_put(idb, &key, &val, 0);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+  }
+
+  struct jbcoll *jbc = iwhmap_get(db->mcolls, "c1");
+  CU_ASSERT_PTR_NOT_NULL_FATAL(jbc);
+  binn *imeta = binn_object();
+  CU_ASSERT_PTR_NOT_NULL_FATAL(imeta);
+  CU_ASSERT_TRUE_FATAL(binn_object_set_str(imeta, "ptr", "/f"));
+  CU_ASSERT_TRUE_FATAL(binn_object_set_uint32(imeta, "mode", EJDB_IDX_F64));
+  CU_ASSERT_TRUE_FATAL(binn_object_set_uint32(imeta, "idbf", idbf));
+  CU_ASSERT_TRUE_FATAL(binn_object_set_uint32(imeta, "dbid", dbid));
+  snprintf(dbuf, sizeof(dbuf), KEY_PREFIX_IDXMETA "%u" "." "%u", jbc->dbid, dbid);
+  struct iwkv_val key = { .data = dbuf, .size = strlen(dbuf) };
+  struct iwkv_val val = { .data = binn_ptr(imeta), .size = binn_size(imeta) };
+  rc = iwkv_put(db->metadb, &key, &val, 0);
+  binn_free(imeta);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  // Read-only open keeps legacy text keys
+  opts.kv.oflags = IWKV_RDONLY;
+  rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  ejdb_test3_18_check(db, true);
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  // Writable open migrates index to binary keys
+  opts.kv.oflags = 0;
+  rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  ejdb_test3_18_check(db, false);
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  // Migrated index survives reopening
+  rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  ejdb_test3_18_check(db, false);
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+}
+
 int main() {
   CU_pSuite pSuite = NULL;
   if (CUE_SUCCESS != CU_initialize_registry()) {
@@ -1167,7 +2206,16 @@ int main() {
      || (NULL == CU_add_test(pSuite, "ejdb_test3_6", ejdb_test3_6))
      || (NULL == CU_add_test(pSuite, "ejdb_test3_7", ejdb_test3_7))
      || (NULL == CU_add_test(pSuite, "ejdb_test3_8", ejdb_test3_8))
-     || (NULL == CU_add_test(pSuite, "ejdb_test3_9", ejdb_test3_9))) {
+     || (NULL == CU_add_test(pSuite, "ejdb_test3_9", ejdb_test3_9))
+     || (NULL == CU_add_test(pSuite, "ejdb_test3_10", ejdb_test3_10))
+     || (NULL == CU_add_test(pSuite, "ejdb_test3_11", ejdb_test3_11))
+     || (NULL == CU_add_test(pSuite, "ejdb_test3_12", ejdb_test3_12))
+     || (NULL == CU_add_test(pSuite, "ejdb_test3_13", ejdb_test3_13))
+     || (NULL == CU_add_test(pSuite, "ejdb_test3_14", ejdb_test3_14))
+     || (NULL == CU_add_test(pSuite, "ejdb_test3_15", ejdb_test3_15))
+     || (NULL == CU_add_test(pSuite, "ejdb_test3_16", ejdb_test3_16))
+     || (NULL == CU_add_test(pSuite, "ejdb_test3_17", ejdb_test3_17))
+     || (NULL == CU_add_test(pSuite, "ejdb_test3_18", ejdb_test3_18))) {
     CU_cleanup_registry();
     return CU_get_error();
   }
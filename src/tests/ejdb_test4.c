@@ -209,6 +209,101 @@ static void ejdb_test4_2(void) {
   CU_ASSERT_EQUAL_FATAL(rc, 0);
 }
 
+// Batched join prefetch over several collections with missing refs
+static void ejdb_test4_3(void) {
+  EJDB_OPTS opts = {
+    .kv = {
+      .path = "ejdb_test4_3.db",
+      .oflags = IWKV_TRUNC
+    },
+    .no_wal = true,
+    .document_cache_sz = 1024 * 1024
+  };
+
+  EJDB db;
+  JQL q;
+  JBL metrics, jbl;
+  JBL_NODE n;
+  int i = 0;
+  EJDB_LIST list = 0;
+
+  iwrc rc = ejdb_open(&opts, &db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  // Same document ids in different joined collections
+  rc = put_json(db, "artists", "{'name':'Leonardo Da Vinci'}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "artists", "{'name':'Raphael'}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "cities", "{'name':'Florence'}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = put_json(db, "paintings", "{'name':'p1', 'artist_ref':1, 'city_ref':1}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "paintings", "{'name':'p2', 'artist_ref':2, 'city_ref':999}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = put_json(db, "paintings", "{'name':'p3', 'artist_ref':999, 'city_ref':1, 'owner_ref':5}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  rc = jql_create(&q, "paintings", "/* | /{name, artist_ref<artists, city_ref<cities, owner_ref<owners}");
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = ejdb_list4(db, q, 0, 0, &list);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+
+  for (EJDB_DOC doc = list->first; doc; doc = doc->next, ++i) {
+    const char *artist = 0, *city = 0;
+    rc = jbn_at(doc->node, "/name", &n);
+    CU_ASSERT_EQUAL_FATAL(rc, 0);
+    if (!strncmp(n->vptr, "p1", n->vsize)) {
+      artist = "Leonardo Da Vinci";
+      city = "Florence";
+    } else if (!strncmp(n->vptr, "p2", n->vsize)) {
+      artist = "Raphael";
+    } else {
+      city = "Florence";
+      rc = jbn_at(doc->node, "/owner_ref", &n); // Missing collection
+      CU_ASSERT_EQUAL_FATAL(rc, 0);
+      CU_ASSERT_EQUAL(n->type, JBV_I64);
+      CU_ASSERT_EQUAL(n->vi64, 5);
+    }
+    if (artist) {
+      rc = jbn_at(doc->node, "/artist_ref/name", &n);
+      CU_ASSERT_EQUAL_FATAL(rc, 0);
+      CU_ASSERT_NSTRING_EQUAL(n->vptr, artist, n->vsize);
+    } else {
+      rc = jbn_at(doc->node, "/artist_ref", &n);
+      CU_ASSERT_EQUAL_FATAL(rc, 0);
+      CU_ASSERT_EQUAL(n->type, JBV_I64);
+      CU_ASSERT_EQUAL(n->vi64, 999);
+    }
+    if (city) {
+      rc = jbn_at(doc->node, "/city_ref/name", &n);
+      CU_ASSERT_EQUAL_FATAL(rc, 0);
+      CU_ASSERT_NSTRING_EQUAL(n->vptr, city, n->vsize);
+    } else {
+      rc = jbn_at(doc->node, "/city_ref", &n);
+      CU_ASSERT_EQUAL_FATAL(rc, 0);
+      CU_ASSERT_EQUAL(n->type, JBV_I64);
+      CU_ASSERT_EQUAL(n->vi64, 999);
+    }
+  }
+  CU_ASSERT_EQUAL(i, 3);
+  jql_destroy(&q);
+  ejdb_list_destroy(&list);
+
+  // All refs are resolved by prefetch, missing ones are not retried one by one
+  rc = ejdb_get_metrics(db, &metrics);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  rc = jbl_at(metrics, "/doc_cache_misses", &jbl);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+  CU_ASSERT_EQUAL(jbl_get_i64(jbl), 0);
+  jbl_destroy(&jbl);
+  jbl_destroy(&metrics);
+
+  rc = ejdb_close(&db);
+  CU_ASSERT_EQUAL_FATAL(rc, 0);
+}
+
 int main() {
   CU_pSuite pSuite = NULL;
   if (CUE_SUCCESS != CU_initialize_registry()) {
@@ -220,7 +315,8 @@ int main() {
     return CU_get_error();
   }
   if (  (NULL == CU_add_test(pSuite, "ejdb_test4_1", ejdb_test4_1))
-     || (NULL == CU_add_test(pSuite, "ejdb_test4_2", ejdb_test4_2))) {
+     || (NULL == CU_add_test(pSuite, "ejdb_test4_2", ejdb_test4_2))
+     || (NULL == CU_add_test(pSuite, "ejdb_test4_3", ejdb_test4_3))) {
     CU_cleanup_registry();
     return CU_get_error();
   }